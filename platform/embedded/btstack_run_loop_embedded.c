@@ -57,6 +57,7 @@
 
 #include "btstack_run_loop.h"
 #include "btstack_run_loop_embedded.h"
+#include "btstack_run_loop_profiler.h"
 #include "btstack_linked_list.h"
 #include "btstack_util.h"
 #include "hal_tick.h"
@@ -152,6 +153,30 @@ static bool btstack_run_loop_embedded_remove_timer(btstack_timer_source_t *ts){
 #endif
 }
 
+#if defined(TIMER_SUPPORT) && defined(ENABLE_RUN_LOOP_TIMER_SLACK)
+static uint32_t btstack_run_loop_embedded_get_slack(btstack_timer_source_t * ts){
+#ifdef HAVE_EMBEDDED_TICK
+    return btstack_run_loop_embedded_ticks_for_ms(ts->slack_ms);
+#else
+    return ts->slack_ms;
+#endif
+}
+
+// earliest timeout + slack, timers after the current result cannot lower it
+static uint32_t btstack_run_loop_embedded_get_wake_up_time(void){
+    btstack_timer_source_t * ts = (btstack_timer_source_t *) timers;
+    uint32_t wake_up = ts->timeout + btstack_run_loop_embedded_get_slack(ts);
+    for (ts = (btstack_timer_source_t *) ts->item.next; ts != NULL; ts = (btstack_timer_source_t *) ts->item.next){
+        if (btstack_time_delta(ts->timeout, wake_up) >= 0) break;
+        uint32_t deadline = ts->timeout + btstack_run_loop_embedded_get_slack(ts);
+        if (btstack_time_delta(deadline, wake_up) < 0){
+            wake_up = deadline;
+        }
+    }
+    return wake_up;
+}
+#endif
+
 static void btstack_run_loop_embedded_dump_timer(void){
 #ifdef TIMER_SUPPORT
 #ifdef ENABLE_LOG_INFO 
@@ -184,7 +209,11 @@ void btstack_run_loop_embedded_execute_once(void) {
     for (ds = (btstack_data_source_t *) data_sources; ds != NULL ; ds = next){
         next = (btstack_data_source_t *) ds->item.next; // cache pointer to next data_source to allow data source to remove itself
         if (ds->flags & DATA_SOURCE_CALLBACK_POLL){
-            ds->process(ds, DATA_SOURCE_CALLBACK_POLL);
+            // data source might be removed and freed by its handler
+            void (*process)(btstack_data_source_t * _ds, btstack_data_source_callback_type_t callback_type) = ds->process;
+            BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start);
+            (*process)(ds, DATA_SOURCE_CALLBACK_POLL);
+            BTSTACK_RUN_LOOP_PROFILER_END(profiler_start, BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE, process);
         }
     }
     
@@ -198,13 +227,23 @@ void btstack_run_loop_embedded_execute_once(void) {
 #endif
 
     // process timers
-    while (timers) {
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+    // wait until the first timer has to fire, then process all expired timers together
+    bool process_timers = (timers != NULL) && (btstack_time_delta(btstack_run_loop_embedded_get_wake_up_time(), now) <= 0);
+#else
+    bool process_timers = true;
+#endif
+    while (process_timers && (timers != NULL)) {
         btstack_timer_source_t * ts = (btstack_timer_source_t *) timers;
         int32_t delta = btstack_time_delta(ts->timeout, now);
         if (delta > 0) break;
 
         btstack_run_loop_embedded_remove_timer(ts);
-        ts->process(ts);
+        // timer might be freed by its handler
+        void (*process)(btstack_timer_source_t * timer) = ts->process;
+        BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start);
+        (*process)(ts);
+        BTSTACK_RUN_LOOP_PROFILER_END(profiler_start, BTSTACK_RUN_LOOP_PROFILER_HANDLER_TIMER, process);
     }
 #endif
     
@@ -214,7 +253,9 @@ void btstack_run_loop_embedded_execute_once(void) {
         trigger_event_received = 0;
         hal_cpu_enable_irqs();
     } else {
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_BEGIN();
         hal_cpu_enable_irqs_and_sleep();
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_END();
     }
 }
 
@@ -208,6 +208,10 @@ void btstack_run_loop_freertos_execute_code_on_main_thread_from_isr(void (*fn)(v
 }
 #endif
 
+static void btstack_run_loop_freertos_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration){
+    btstack_run_loop_freertos_execute_code_on_main_thread(callback_registration->callback, callback_registration->context);
+}
+
 void btstack_run_loop_freertos_trigger_exit(void){
     run_loop_exit_requested = true;
 }
@@ -325,6 +329,7 @@ static const btstack_run_loop_t btstack_run_loop_freertos = {
     &btstack_run_loop_freertos_execute,
     &btstack_run_loop_freertos_dump_timer,
     &btstack_run_loop_freertos_get_time_ms,
+    &btstack_run_loop_freertos_execute_on_main_thread,
 };
 
 const btstack_run_loop_t * btstack_run_loop_freertos_get_instance(void){
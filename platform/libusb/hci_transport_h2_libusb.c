@@ -64,6 +64,7 @@
 #include "btstack_config.h"
 
 #include "btstack_debug.h"
+#include "btstack_trace.h"
 #include "hci.h"
 #include "hci_transport.h"
 
@@ -448,11 +449,15 @@ static void handle_completed_transfer(struct libusb_transfer *transfer){
     int signal_done = 0;
 
     if (transfer->endpoint == event_in_addr) {
+        BTSTACK_TRACE_BEGIN(trace_start);
         packet_handler(HCI_EVENT_PACKET, transfer->buffer, transfer->actual_length);
+        BTSTACK_TRACE_PACKET_END(trace_start, BTSTACK_TRACEPOINT_TRANSPORT_RX, HCI_EVENT_PACKET, transfer->buffer, transfer->actual_length);
         resubmit = 1;
     } else if (transfer->endpoint == acl_in_addr) {
         // log_info("-> acl");
+        BTSTACK_TRACE_BEGIN(trace_start);
         packet_handler(HCI_ACL_DATA_PACKET, transfer->buffer, transfer->actual_length);
+        BTSTACK_TRACE_PACKET_END(trace_start, BTSTACK_TRACEPOINT_TRANSPORT_RX, HCI_ACL_DATA_PACKET, transfer->buffer, transfer->actual_length);
         resubmit = 1;
     } else if (transfer->endpoint == 0){
         // log_info("command done, size %u", transfer->actual_length);
@@ -0,0 +1,327 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_run_loop_epoll.c"
+
+/*
+ *  btstack_run_loop_epoll.c
+ */
+
+// enable POSIX functions (needed for -std=c99)
+#define _POSIX_C_SOURCE 200809
+
+#include "btstack_run_loop_epoll.h"
+
+#include "btstack_run_loop.h"
+#include "btstack_run_loop_base.h"
+#include "btstack_run_loop_profiler.h"
+#include "btstack_util.h"
+#include "btstack_linked_list.h"
+#include "btstack_debug.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+// max number of ready file descriptors processed per iteration
+#define BTSTACK_RUN_LOOP_EPOLL_MAX_EVENTS 32
+
+// the run loop
+static btstack_linked_list_t data_sources;
+static int data_sources_modified;
+static int epoll_fd = -1;
+
+// callbacks queued by other threads, lock-free LIFO linked via registration->item
+static btstack_context_callback_registration_t * main_thread_callbacks;
+// eventfd to wake up run loop
+static int main_thread_event_fd = -1;
+static btstack_data_source_t main_thread_data_source;
+
+// start time
+static struct timespec init_ts;
+
+static uint32_t btstack_run_loop_epoll_events_for_flags(uint16_t flags){
+    uint32_t events = 0;
+    if (flags & DATA_SOURCE_CALLBACK_READ){
+        events |= EPOLLIN;
+    }
+    if (flags & DATA_SOURCE_CALLBACK_WRITE){
+        events |= EPOLLOUT;
+    }
+    return events;
+}
+
+// update epoll registration of data source in run loop. fd is only registered if read or write is enabled
+static void btstack_run_loop_epoll_update(btstack_data_source_t * ds, uint16_t old_flags, uint16_t new_flags){
+    if (ds->source.fd < 0) return;
+    uint32_t old_events = btstack_run_loop_epoll_events_for_flags(old_flags);
+    uint32_t new_events = btstack_run_loop_epoll_events_for_flags(new_flags);
+    if (old_events == new_events) return;
+
+    int op;
+    if (old_events == 0u){
+        op = EPOLL_CTL_ADD;
+    } else if (new_events == 0u){
+        op = EPOLL_CTL_DEL;
+    } else {
+        op = EPOLL_CTL_MOD;
+    }
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events   = new_events;
+    event.data.ptr = ds;
+    if (epoll_ctl(epoll_fd, op, ds->source.fd, &event) < 0){
+        // closed file descriptors are removed from epoll automatically
+        if ((op == EPOLL_CTL_DEL) && ((errno == EBADF) || (errno == ENOENT))) return;
+        log_error("epoll_ctl op %u for fd %u failed, errno %u", op, ds->source.fd, errno);
+    }
+}
+
+static bool btstack_run_loop_epoll_contains_data_source(btstack_data_source_t * ds){
+    btstack_linked_item_t *it;
+    for (it = (btstack_linked_item_t *) data_sources; it ; it = it->next){
+        if (it == (btstack_linked_item_t *) ds) return true;
+    }
+    return false;
+}
+
+/**
+ * Add data_source to run_loop
+ */
+static void btstack_run_loop_epoll_add_data_source(btstack_data_source_t *ds){
+    data_sources_modified = 1;
+    if (btstack_linked_list_add(&data_sources, (btstack_linked_item_t *) ds)){
+        btstack_run_loop_epoll_update(ds, 0, ds->flags);
+    }
+}
+
+/**
+ * Remove data_source from run loop
+ */
+static bool btstack_run_loop_epoll_remove_data_source(btstack_data_source_t *ds){
+    data_sources_modified = 1;
+    log_debug("btstack_run_loop_epoll_remove_data_source %p\n", ds);
+    bool removed = btstack_linked_list_remove(&data_sources, (btstack_linked_item_t *) ds);
+    if (removed){
+        btstack_run_loop_epoll_update(ds, ds->flags, 0);
+    }
+    return removed;
+}
+
+static void btstack_run_loop_epoll_enable_data_source_callbacks(btstack_data_source_t * ds, uint16_t callback_types){
+    uint16_t old_flags = ds->flags;
+    ds->flags |= callback_types;
+    if (ds->flags == old_flags) return;
+    if (!btstack_run_loop_epoll_contains_data_source(ds)) return;
+    btstack_run_loop_epoll_update(ds, old_flags, ds->flags);
+}
+
+static void btstack_run_loop_epoll_disable_data_source_callbacks(btstack_data_source_t * ds, uint16_t callback_types){
+    uint16_t old_flags = ds->flags;
+    ds->flags &= ~callback_types;
+    if (ds->flags == old_flags) return;
+    if (!btstack_run_loop_epoll_contains_data_source(ds)) return;
+    btstack_run_loop_epoll_update(ds, old_flags, ds->flags);
+}
+
+/**
+ * @brief Queries the current time in ms since start
+ */
+static uint32_t btstack_run_loop_epoll_get_time_ms(void){
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    uint64_t time_ms = ((uint64_t) (now_ts.tv_sec - init_ts.tv_sec) * 1000u) + (uint64_t) (now_ts.tv_nsec / 1000000);
+    return (uint32_t) time_ms;
+}
+
+static void btstack_run_loop_epoll_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration){
+    // push onto queue
+    btstack_context_callback_registration_t * head = __atomic_load_n(&main_thread_callbacks, __ATOMIC_RELAXED);
+    do {
+        callback_registration->item = (btstack_linked_item_t *) head;
+    } while (!__atomic_compare_exchange_n(&main_thread_callbacks, &head, callback_registration, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    // wake up run loop if queue was empty
+    if (head == NULL){
+        eventfd_write(main_thread_event_fd, 1);
+    }
+}
+
+static void btstack_run_loop_epoll_main_thread_process(btstack_data_source_t *ds, btstack_data_source_callback_type_t callback_type){
+    UNUSED(callback_type);
+
+    // reset eventfd before taking queued callbacks, a late trigger only causes an empty wake up
+    eventfd_t value;
+    eventfd_read(ds->source.fd, &value);
+
+    btstack_context_callback_registration_t * callbacks = __atomic_exchange_n(&main_thread_callbacks, NULL, __ATOMIC_ACQUIRE);
+
+    // reverse to execute callbacks in order
+    btstack_context_callback_registration_t * fifo = NULL;
+    while (callbacks != NULL){
+        btstack_context_callback_registration_t * next = (btstack_context_callback_registration_t *) callbacks->item;
+        callbacks->item = (btstack_linked_item_t *) fifo;
+        fifo = callbacks;
+        callbacks = next;
+    }
+
+    while (fifo != NULL){
+        // registration can be queued again by its callback
+        btstack_context_callback_registration_t * next = (btstack_context_callback_registration_t *) fifo->item;
+        void (*callback)(void * context) = fifo->callback;
+        BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start);
+        (*callback)(fifo->context);
+        BTSTACK_RUN_LOOP_PROFILER_END(profiler_start, BTSTACK_RUN_LOOP_PROFILER_HANDLER_CALLBACK, callback);
+        fifo = next;
+    }
+}
+
+static void btstack_run_loop_epoll_main_thread_init(void){
+    main_thread_callbacks = NULL;
+    if (main_thread_event_fd < 0){
+        main_thread_event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (main_thread_event_fd < 0){
+            log_error("eventfd for execute on main thread failed, errno %u", errno);
+            return;
+        }
+    }
+    btstack_run_loop_set_data_source_fd(&main_thread_data_source, main_thread_event_fd);
+    btstack_run_loop_set_data_source_handler(&main_thread_data_source, &btstack_run_loop_epoll_main_thread_process);
+    btstack_run_loop_epoll_enable_data_source_callbacks(&main_thread_data_source, DATA_SOURCE_CALLBACK_READ);
+    btstack_run_loop_epoll_add_data_source(&main_thread_data_source);
+}
+
+/**
+ * Execute run_loop
+ */
+static void btstack_run_loop_epoll_execute(void) {
+    struct epoll_event events[BTSTACK_RUN_LOOP_EPOLL_MAX_EVENTS];
+    uint32_t now_ms;
+
+    log_info("epoll run loop");
+
+    while (true) {
+        // get next timeout, -1 if no timers
+        now_ms = btstack_run_loop_epoll_get_time_ms();
+        int timeout_ms = (int) btstack_run_loop_base_get_time_until_timeout(now_ms);
+
+        // wait for ready FDs
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_BEGIN();
+        int num_events = epoll_wait(epoll_fd, events, BTSTACK_RUN_LOOP_EPOLL_MAX_EVENTS, timeout_ms);
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_END();
+        if ((num_events < 0) && (errno != EINTR)){
+            log_error("epoll_wait failed, errno %u", errno);
+        }
+
+        // process ready data sources. As file descriptors are level-triggered, remaining events are reported
+        // again in the next iteration if a callback added or removed a data source
+        data_sources_modified = 0;
+        int i;
+        for (i = 0; (i < num_events) && !data_sources_modified; i++){
+            btstack_data_source_t *ds = (btstack_data_source_t *) events[i].data.ptr;
+            uint32_t ready = events[i].events;
+            if ((ready & (EPOLLIN | EPOLLERR | EPOLLHUP)) && (ds->flags & DATA_SOURCE_CALLBACK_READ)){
+                log_debug("btstack_run_loop_epoll_execute: process read ds %p with fd %u\n", ds, ds->source.fd);
+                // data source might be removed and freed by its handler
+                void (*process)(btstack_data_source_t * _ds, btstack_data_source_callback_type_t callback_type) = ds->process;
+                BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start_read);
+                (*process)(ds, DATA_SOURCE_CALLBACK_READ);
+                BTSTACK_RUN_LOOP_PROFILER_END(profiler_start_read, BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE, process);
+            }
+            if (data_sources_modified) break;
+            if ((ready & (EPOLLOUT | EPOLLERR)) && (ds->flags & DATA_SOURCE_CALLBACK_WRITE)){
+                log_debug("btstack_run_loop_epoll_execute: process write ds %p with fd %u\n", ds, ds->source.fd);
+                // data source might be removed and freed by its handler
+                void (*process)(btstack_data_source_t * _ds, btstack_data_source_callback_type_t callback_type) = ds->process;
+                BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start_write);
+                (*process)(ds, DATA_SOURCE_CALLBACK_WRITE);
+                BTSTACK_RUN_LOOP_PROFILER_END(profiler_start_write, BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE, process);
+            }
+        }
+
+        // process timers
+        now_ms = btstack_run_loop_epoll_get_time_ms();
+        btstack_run_loop_base_process_timers(now_ms);
+    }
+}
+
+// set timer
+static void btstack_run_loop_epoll_set_timer(btstack_timer_source_t *a, uint32_t timeout_in_ms){
+    uint32_t time_ms = btstack_run_loop_epoll_get_time_ms();
+    a->timeout = time_ms + timeout_in_ms;
+    log_debug("btstack_run_loop_epoll_set_timer to %u ms (now %u, timeout %u)", a->timeout, time_ms, timeout_in_ms);
+}
+
+static void btstack_run_loop_epoll_init(void){
+    data_sources = NULL;
+    btstack_run_loop_base_init();
+    if (epoll_fd >= 0){
+        close(epoll_fd);
+    }
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0){
+        log_error("epoll_create1 failed, errno %u", errno);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &init_ts);
+    init_ts.tv_nsec = 0;
+    btstack_run_loop_epoll_main_thread_init();
+}
+
+static const btstack_run_loop_t btstack_run_loop_epoll = {
+    &btstack_run_loop_epoll_init,
+    &btstack_run_loop_epoll_add_data_source,
+    &btstack_run_loop_epoll_remove_data_source,
+    &btstack_run_loop_epoll_enable_data_source_callbacks,
+    &btstack_run_loop_epoll_disable_data_source_callbacks,
+    &btstack_run_loop_epoll_set_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
+    &btstack_run_loop_epoll_execute,
+    &btstack_run_loop_base_dump_timer,
+    &btstack_run_loop_epoll_get_time_ms,
+    &btstack_run_loop_epoll_execute_on_main_thread,
+};
+
+/**
+ * Provide btstack_run_loop_epoll instance
+ */
+const btstack_run_loop_t * btstack_run_loop_epoll_get_instance(void){
+    return &btstack_run_loop_epoll;
+}
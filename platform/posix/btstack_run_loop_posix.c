@@ -49,10 +49,14 @@
 #include "btstack_run_loop_posix.h"
 
 #include "btstack_run_loop.h"
+#include "btstack_run_loop_base.h"
+#include "btstack_run_loop_profiler.h"
 #include "btstack_util.h"
 #include "btstack_linked_list.h"
 #include "btstack_debug.h"
 
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
@@ -60,12 +64,15 @@
 #include <time.h>
 #include <unistd.h>
 
-static void btstack_run_loop_posix_dump_timer(void);
-
 // the run loop
 static btstack_linked_list_t data_sources;
 static int data_sources_modified;
-static btstack_linked_list_t timers;
+
+// callbacks queued by other threads, lock-free LIFO linked via registration->item
+static btstack_context_callback_registration_t * main_thread_callbacks;
+// self-pipe to wake up run loop
+static int main_thread_pipe_fds[2] = { -1, -1 };
+static btstack_data_source_t main_thread_data_source;
 
 // start time. tv_usec/tv_nsec = 0
 #ifdef _POSIX_MONOTONIC_CLOCK
@@ -94,44 +101,6 @@ static bool btstack_run_loop_posix_remove_data_source(btstack_data_source_t *ds)
     return btstack_linked_list_remove(&data_sources, (btstack_linked_item_t *) ds);
 }
 
-/**
- * Add timer to run_loop (keep list sorted)
- */
-static void btstack_run_loop_posix_add_timer(btstack_timer_source_t *ts){
-    btstack_linked_item_t *it;
-    for (it = (btstack_linked_item_t *) &timers; it->next ; it = it->next){
-        btstack_timer_source_t * next = (btstack_timer_source_t *) it->next;
-        btstack_assert(next != ts);
-        // exit if new timeout before list timeout
-        int32_t delta = btstack_time_delta(ts->timeout, next->timeout);
-        if (delta < 0) break;
-    }
-    ts->item.next = it->next;
-    it->next = (btstack_linked_item_t *) ts;
-    log_debug("Added timer %p at %u\n", ts, ts->timeout);
-    // btstack_run_loop_posix_dump_timer();
-}
-
-/**
- * Remove timer from run loop
- */
-static bool btstack_run_loop_posix_remove_timer(btstack_timer_source_t *ts){
-    // log_info("Removed timer %x at %u\n", (int) ts, (unsigned int) ts->timeout.tv_sec);
-    // btstack_run_loop_posix_dump_timer();
-    return btstack_linked_list_remove(&timers, (btstack_linked_item_t *) ts);
-}
-
-static void btstack_run_loop_posix_dump_timer(void){
-#ifdef ENABLE_LOG_INFO    
-    btstack_linked_item_t *it;
-    int i = 1;
-    for (it = (btstack_linked_item_t *) timers; it ; it = it->next){
-        btstack_timer_source_t *ts = (btstack_timer_source_t*) it;
-        log_info("timer %u (%p): timeout %u\n", i++, ts, ts->timeout);
-    }
-#endif
-}
-
 static void btstack_run_loop_posix_enable_data_source_callbacks(btstack_data_source_t * ds, uint16_t callback_types){
     ds->flags |= callback_types;
 }
@@ -193,6 +162,67 @@ static uint32_t btstack_run_loop_posix_get_time_ms(void){
     return time_ms;
 }
 
+static void btstack_run_loop_posix_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration){
+    // push onto queue
+    btstack_context_callback_registration_t * head = __atomic_load_n(&main_thread_callbacks, __ATOMIC_RELAXED);
+    do {
+        callback_registration->item = (btstack_linked_item_t *) head;
+    } while (!__atomic_compare_exchange_n(&main_thread_callbacks, &head, callback_registration, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    // wake up run loop if queue was empty
+    if (head == NULL){
+        const uint8_t trigger = 0;
+        ssize_t res = write(main_thread_pipe_fds[1], &trigger, 1);
+        UNUSED(res);
+    }
+}
+
+static void btstack_run_loop_posix_main_thread_process(btstack_data_source_t *ds, btstack_data_source_callback_type_t callback_type){
+    UNUSED(callback_type);
+
+    // drain pipe before taking queued callbacks, a late trigger only causes an empty wake up
+    uint8_t buffer[16];
+    while (read(ds->source.fd, buffer, sizeof(buffer)) > 0){
+    }
+
+    btstack_context_callback_registration_t * callbacks = __atomic_exchange_n(&main_thread_callbacks, NULL, __ATOMIC_ACQUIRE);
+
+    // reverse to execute callbacks in order
+    btstack_context_callback_registration_t * fifo = NULL;
+    while (callbacks != NULL){
+        btstack_context_callback_registration_t * next = (btstack_context_callback_registration_t *) callbacks->item;
+        callbacks->item = (btstack_linked_item_t *) fifo;
+        fifo = callbacks;
+        callbacks = next;
+    }
+
+    while (fifo != NULL){
+        // registration can be queued again by its callback
+        btstack_context_callback_registration_t * next = (btstack_context_callback_registration_t *) fifo->item;
+        void (*callback)(void * context) = fifo->callback;
+        BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start);
+        (*callback)(fifo->context);
+        BTSTACK_RUN_LOOP_PROFILER_END(profiler_start, BTSTACK_RUN_LOOP_PROFILER_HANDLER_CALLBACK, callback);
+        fifo = next;
+    }
+}
+
+static void btstack_run_loop_posix_main_thread_init(void){
+    main_thread_callbacks = NULL;
+    if (main_thread_pipe_fds[0] < 0){
+        if (pipe(main_thread_pipe_fds) != 0){
+            log_error("pipe for execute on main thread failed, errno %u", errno);
+            return;
+        }
+        fcntl(main_thread_pipe_fds[0], F_SETFL, fcntl(main_thread_pipe_fds[0], F_GETFL) | O_NONBLOCK);
+        fcntl(main_thread_pipe_fds[1], F_SETFL, fcntl(main_thread_pipe_fds[1], F_GETFL) | O_NONBLOCK);
+    }
+    btstack_run_loop_set_data_source_fd(&main_thread_data_source, main_thread_pipe_fds[0]);
+    btstack_run_loop_set_data_source_handler(&main_thread_data_source, &btstack_run_loop_posix_main_thread_process);
+    btstack_run_loop_posix_enable_data_source_callbacks(&main_thread_data_source, DATA_SOURCE_CALLBACK_READ);
+    btstack_run_loop_posix_add_data_source(&main_thread_data_source);
+}
+
 /**
  * Execute run_loop
  */
@@ -200,7 +230,6 @@ static void btstack_run_loop_posix_execute(void) {
     fd_set descriptors_read;
     fd_set descriptors_write;
     
-    btstack_timer_source_t       *ts;
     btstack_linked_list_iterator_t it;
     struct timeval * timeout;
     struct timeval tv;
@@ -239,22 +268,19 @@ static void btstack_run_loop_posix_execute(void) {
         
         // get next timeout
         timeout = NULL;
-        if (timers) {
-            ts = (btstack_timer_source_t *) timers;
+        now_ms = btstack_run_loop_posix_get_time_ms();
+        int32_t delta = btstack_run_loop_base_get_time_until_timeout(now_ms);
+        if (delta >= 0) {
             timeout = &tv;
-            uint32_t list_timeout  = ts->timeout;
-            now_ms = btstack_run_loop_posix_get_time_ms();
-            int32_t delta = btstack_time_delta(list_timeout, now_ms);
-            if (delta < 0){
-                delta = 0;
-            }
             tv.tv_sec  = delta / 1000;
             tv.tv_usec = (int) (delta - (tv.tv_sec * 1000)) * 1000;
             log_debug("btstack_run_loop_execute next timeout in %u ms", delta);
         }
                 
         // wait for ready FDs
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_BEGIN();
         select( highest_fd+1 , &descriptors_read, &descriptors_write, NULL, timeout);
+        BTSTACK_RUN_LOOP_PROFILER_IDLE_END();
                 
 
         data_sources_modified = 0;
@@ -264,28 +290,27 @@ static void btstack_run_loop_posix_execute(void) {
             log_debug("btstack_run_loop_posix_execute: check ds %p with fd %u\n", ds, ds->source.fd);
             if (FD_ISSET(ds->source.fd, &descriptors_read)) {
                 log_debug("btstack_run_loop_posix_execute: process read ds %p with fd %u\n", ds, ds->source.fd);
-                ds->process(ds, DATA_SOURCE_CALLBACK_READ);
+                // data source might be removed and freed by its handler
+                void (*process)(btstack_data_source_t * _ds, btstack_data_source_callback_type_t callback_type) = ds->process;
+                BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start_read);
+                (*process)(ds, DATA_SOURCE_CALLBACK_READ);
+                BTSTACK_RUN_LOOP_PROFILER_END(profiler_start_read, BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE, process);
             }
             if (data_sources_modified) break;
             if (FD_ISSET(ds->source.fd, &descriptors_write)) {
                 log_debug("btstack_run_loop_posix_execute: process write ds %p with fd %u\n", ds, ds->source.fd);
-                ds->process(ds, DATA_SOURCE_CALLBACK_WRITE);
+                // data source might be removed and freed by its handler
+                void (*process)(btstack_data_source_t * _ds, btstack_data_source_callback_type_t callback_type) = ds->process;
+                BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start_write);
+                (*process)(ds, DATA_SOURCE_CALLBACK_WRITE);
+                BTSTACK_RUN_LOOP_PROFILER_END(profiler_start_write, BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE, process);
             }
         }
         log_debug("btstack_run_loop_posix_execute: after ds check\n");
         
         // process timers
         now_ms = btstack_run_loop_posix_get_time_ms();
-        while (timers) {
-            ts = (btstack_timer_source_t *) timers;
-            int32_t delta = btstack_time_delta(ts->timeout, now_ms);
-            if (delta > 0) break;
-            log_debug("btstack_run_loop_posix_execute: process timer %p\n", ts);
-            
-            // remove timer before processing it to allow handler to re-register with run loop
-            btstack_run_loop_posix_remove_timer(ts);
-            ts->process(ts);
-        }
+        btstack_run_loop_base_process_timers(now_ms);
     }
 }
 
@@ -298,7 +323,7 @@ static void btstack_run_loop_posix_set_timer(btstack_timer_source_t *a, uint32_t
 
 static void btstack_run_loop_posix_init(void){
     data_sources = NULL;
-    timers = NULL;
+    btstack_run_loop_base_init();
 #ifdef _POSIX_MONOTONIC_CLOCK
     clock_gettime(CLOCK_MONOTONIC, &init_ts);
     init_ts.tv_nsec = 0;
@@ -307,6 +332,7 @@ static void btstack_run_loop_posix_init(void){
     gettimeofday(&init_tv, NULL);
     init_tv.tv_usec = 0;
 #endif
+    btstack_run_loop_posix_main_thread_init();
 }
 
 
@@ -317,11 +343,12 @@ static const btstack_run_loop_t btstack_run_loop_posix = {
     &btstack_run_loop_posix_enable_data_source_callbacks,
     &btstack_run_loop_posix_disable_data_source_callbacks,
     &btstack_run_loop_posix_set_timer,
-    &btstack_run_loop_posix_add_timer,
-    &btstack_run_loop_posix_remove_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
     &btstack_run_loop_posix_execute,
-    &btstack_run_loop_posix_dump_timer,
+    &btstack_run_loop_base_dump_timer,
     &btstack_run_loop_posix_get_time_ms,
+    &btstack_run_loop_posix_execute_on_main_thread,
 };
 
 /**
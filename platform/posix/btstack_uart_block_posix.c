@@ -71,10 +71,13 @@ static const uint8_t * write_bytes_data;
 // block read
 static uint16_t  read_bytes_len;
 static uint8_t * read_bytes_data;
+// receive_bytes: report after first read instead of waiting for read_bytes_len bytes
+static bool      read_bytes_partial;
 
 // callbacks
 static void (*block_sent)(void);
 static void (*block_received)(void);
+static void (*bytes_received)(uint16_t num_bytes);
 
 
 static int btstack_uart_posix_init(const btstack_uart_config_t * config){
@@ -145,6 +148,15 @@ static void btstack_uart_posix_process_read(btstack_data_source_t *ds) {
         return;
     }
 
+    if (read_bytes_partial){
+        read_bytes_len = 0;
+        btstack_run_loop_disable_data_source_callbacks(ds, DATA_SOURCE_CALLBACK_READ);
+        if (bytes_received){
+            bytes_received((uint16_t) bytes_read);
+        }
+        return;
+    }
+
     read_bytes_len   -= bytes_read;
     read_bytes_data  += bytes_read;
     if (read_bytes_len > 0) return;
@@ -406,12 +418,24 @@ static void btstack_uart_posix_send_block(const uint8_t *data, uint16_t size){
 static void btstack_uart_posix_receive_block(uint8_t *buffer, uint16_t len){
     read_bytes_data = buffer;
     read_bytes_len = len;
+    read_bytes_partial = false;
     btstack_run_loop_enable_data_source_callbacks(&transport_data_source, DATA_SOURCE_CALLBACK_READ);
 
     // go
     // btstack_uart_posix_process_read(&transport_data_source);
 }
 
+static void btstack_uart_posix_set_bytes_received( void (*bytes_handler)(uint16_t num_bytes)){
+    bytes_received = bytes_handler;
+}
+
+static void btstack_uart_posix_receive_bytes(uint8_t *buffer, uint16_t max_len){
+    read_bytes_data = buffer;
+    read_bytes_len = max_len;
+    read_bytes_partial = true;
+    btstack_run_loop_enable_data_source_callbacks(&transport_data_source, DATA_SOURCE_CALLBACK_READ);
+}
+
 // static void btstack_uart_posix_set_sleep(uint8_t sleep){
 // }
 // static void btstack_uart_posix_set_csr_irq_handler( void (*csr_irq_handler)(void)){
@@ -431,6 +455,8 @@ static const btstack_uart_block_t btstack_uart_posix = {
     /* int (*get_supported_sleep_modes); */                           NULL,
     /* void (*set_sleep)(btstack_uart_sleep_mode_t sleep_mode); */    NULL,
     /* void (*set_wakeup_handler)(void (*handler)(void)); */          NULL,
+    /* void (*set_bytes_received)(void (*handler)(uint16_t)); */      &btstack_uart_posix_set_bytes_received,
+    /* void (*receive_bytes)(uint8_t *buffer, uint16_t max_len); */   &btstack_uart_posix_receive_bytes,
 };
 
 const btstack_uart_block_t * btstack_uart_block_posix_instance(void){
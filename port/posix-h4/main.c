@@ -79,6 +79,44 @@ static char tlv_db_path[100];
 static const btstack_tlv_t * tlv_impl;
 static btstack_tlv_posix_t   tlv_context;
 
+#ifdef ENABLE_BTSTACK_TRACE
+#include <time.h>
+#include "btstack_trace.h"
+#define TRACE_JSON_PATH "/tmp/btstack_trace.json"
+static btstack_trace_event_t trace_events[4096];
+
+static uint32_t trace_get_time_us(void){
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    return (uint32_t) ((now_ts.tv_sec * 1000000) + (now_ts.tv_nsec / 1000));
+}
+
+static void trace_write(void * context, const char * data, uint16_t size){
+    fwrite(data, 1, size, (FILE *) context);
+}
+
+static void trace_export(void){
+    FILE * file = fopen(TRACE_JSON_PATH, "w");
+    if (file == NULL) return;
+    btstack_trace_export_chrome_json(&trace_write, file);
+    fclose(file);
+    printf("Trace: %s\n", TRACE_JSON_PATH);
+}
+#endif
+
+#ifdef ENABLE_RUN_LOOP_PROFILER
+#include <time.h>
+#include "btstack_run_loop_profiler.h"
+#define PROFILER_BUDGET_US 10000
+static btstack_run_loop_profiler_handler_t profiler_handlers[32];
+
+static uint32_t profiler_get_time_us(void){
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    return (uint32_t) ((now_ts.tv_sec * 1000000) + (now_ts.tv_nsec / 1000));
+}
+#endif
+
 int btstack_main(int argc, const char * argv[]);
 static void local_version_information_handler(uint8_t * packet);
 
@@ -137,6 +175,9 @@ static void sigint_handler(int param){
 
     printf("CTRL-C - SIGINT received, shutting down..\n");   
     log_info("sigint_handler: shutting down");
+#ifdef ENABLE_RUN_LOOP_PROFILER
+    btstack_run_loop_profiler_dump();
+#endif
 
     // reset anyway
     btstack_stdin_reset();
@@ -144,6 +185,9 @@ static void sigint_handler(int param){
     // power down
     hci_power_control(HCI_POWER_OFF);
     hci_close();
+#ifdef ENABLE_BTSTACK_TRACE
+    trace_export();
+#endif
     log_info("Good bye, see you.\n");    
     exit(0);
 }
@@ -236,6 +280,13 @@ int main(int argc, const char * argv[]){
 	/// GET STARTED with BTstack ///
 	btstack_memory_init();
     btstack_run_loop_init(btstack_run_loop_posix_get_instance());
+#ifdef ENABLE_BTSTACK_TRACE
+    btstack_trace_init(trace_events, sizeof(trace_events) / sizeof(btstack_trace_event_t), &trace_get_time_us);
+#endif
+#ifdef ENABLE_RUN_LOOP_PROFILER
+    btstack_run_loop_profiler_init(profiler_handlers, sizeof(profiler_handlers) / sizeof(btstack_run_loop_profiler_handler_t), &profiler_get_time_us);
+    btstack_run_loop_profiler_set_budget(PROFILER_BUDGET_US);
+#endif
 	    
     // use logger: format HCI_DUMP_PACKETLOGGER, HCI_DUMP_BLUEZ or HCI_DUMP_STDOUT
     const char * pklg_path = "/tmp/hci_dump.pklg";
@@ -57,7 +57,9 @@
 #include "btstack_debug.h"
 #include "btstack_event.h"
 #include "btstack_memory.h"
+#include "btstack_metrics.h"
 #include "btstack_run_loop.h"
+#include "btstack_trace.h"
 #include "gap.h"
 #include "hci.h"
 #include "hci_dump.h"
@@ -95,6 +97,7 @@ typedef struct {
 
 // global
 static btstack_packet_callback_registration_t hci_event_callback_registration;
+static uint8_t hci_event_mask[BTSTACK_EVENT_MASK_SIZE];
 static btstack_packet_callback_registration_t sm_event_callback_registration;
 static btstack_packet_handler_t               att_client_packet_handler = NULL;
 static btstack_linked_list_t                  service_handlers;
@@ -513,7 +516,9 @@ static int att_server_process_validated_request(att_server_t * att_server){
 
     l2cap_reserve_packet_buffer();
     uint8_t * att_response_buffer = l2cap_get_outgoing_buffer();
+    BTSTACK_TRACE_BEGIN(trace_start);
     uint16_t  att_response_size   = att_handle_request(&att_server->connection, att_server->request_buffer, att_server->request_size, att_response_buffer);
+    BTSTACK_TRACE_END(trace_start, BTSTACK_TRACEPOINT_ATT_REQUEST, att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL);
 
 #ifdef ENABLE_ATT_DELAYED_RESPONSE
     if ((att_response_size == ATT_READ_RESPONSE_PENDING) || (att_response_size == ATT_INTERNAL_WRITE_RESPONSE_PENDING)){
@@ -564,6 +569,7 @@ static int att_server_process_validated_request(att_server_t * att_server){
     {
         l2cap_send_prepared_connectionless(att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL, att_response_size);
     }
+    BTSTACK_TRACE_INSTANT(BTSTACK_TRACEPOINT_ATT_RESPONSE_SENT, att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL);
 
     // notify client about MTU exchange result
     if (att_response_buffer[0] == ATT_EXCHANGE_MTU_RESPONSE){
@@ -772,16 +778,21 @@ static void att_server_handle_att_pdu(att_server_t * att_server, uint8_t * packe
         return;
     }
 
+    BTSTACK_METRICS_INC(att_server_requests);
+
     // directly process command
     // note: signed write cannot be handled directly as authentication needs to be verified
     if (packet[0] == ATT_WRITE_COMMAND){
+        BTSTACK_TRACE_BEGIN(trace_start);
         att_handle_request(&att_server->connection, packet, size, NULL);
+        BTSTACK_TRACE_END(trace_start, BTSTACK_TRACEPOINT_ATT_REQUEST, att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL);
         return;
     }
 
     // check size
     if (size > sizeof(att_server->request_buffer)) {
         log_info("drop att pdu 0x%02x as size %u > att_server->request_buffer %u", packet[0], size, (int) sizeof(att_server->request_buffer));
+        BTSTACK_METRICS_INC(att_server_requests_dropped);
         return;
     }
 
@@ -800,6 +811,7 @@ static void att_server_handle_att_pdu(att_server_t * att_server, uint8_t * packe
     // last request still in processing?
     if (att_server->state != ATT_SERVER_IDLE){
         log_info("skip att pdu 0x%02x as server not idle (state %u)", packet[0], att_server->state);
+        BTSTACK_METRICS_INC(att_server_requests_dropped);
         return;
     }
 
@@ -1107,7 +1119,12 @@ void att_server_init(uint8_t const * db, att_read_callback_t read_callback, att_
     att_server_client_write_callback = write_callback;
 
     // register for HCI Events
+    static const uint8_t att_server_hci_event_codes[] = {
+        HCI_EVENT_LE_META, HCI_EVENT_ENCRYPTION_CHANGE, HCI_EVENT_ENCRYPTION_KEY_REFRESH_COMPLETE, HCI_EVENT_DISCONNECTION_COMPLETE,
+    };
+    btstack_event_mask_init(hci_event_mask, att_server_hci_event_codes, sizeof(att_server_hci_event_codes));
     hci_event_callback_registration.callback = &att_event_packet_handler;
+    hci_event_callback_registration.event_mask = hci_event_mask;
     hci_add_event_handler(&hci_event_callback_registration);
 
     // register for SM events
@@ -1176,11 +1193,15 @@ int att_server_request_to_send_indication(btstack_context_callback_registration_
 int att_server_notify(hci_con_handle_t con_handle, uint16_t attribute_handle, const uint8_t *value, uint16_t value_len){
     att_server_t * att_server = att_server_for_handle(con_handle);
     if (!att_server) return ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER;
-    if (!att_server_can_send_packet(att_server)) return BTSTACK_ACL_BUFFERS_FULL;
+    if (!att_server_can_send_packet(att_server)) {
+        BTSTACK_METRICS_INC(att_server_notifications_dropped);
+        return BTSTACK_ACL_BUFFERS_FULL;
+    }
 
     l2cap_reserve_packet_buffer();
     uint8_t * packet_buffer = l2cap_get_outgoing_buffer();
     uint16_t size = att_prepare_handle_value_notification(&att_server->connection, attribute_handle, value, value_len, packet_buffer);
+    BTSTACK_METRICS_INC(att_server_notifications_sent);
 	return l2cap_send_prepared_connectionless(att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL, size);
 }
 
@@ -1200,6 +1221,7 @@ int att_server_indicate(hci_con_handle_t con_handle, uint16_t attribute_handle,
     l2cap_reserve_packet_buffer();
     uint8_t * packet_buffer = l2cap_get_outgoing_buffer();
     uint16_t size = att_prepare_handle_value_indication(&att_server->connection, attribute_handle, value, value_len, packet_buffer);
+    BTSTACK_METRICS_INC(att_server_indications_sent);
 	l2cap_send_prepared_connectionless(att_server->connection.con_handle, L2CAP_CID_ATTRIBUTE_PROTOCOL, size);
     return 0;
 }
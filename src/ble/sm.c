@@ -274,6 +274,7 @@ static uint8_t sm_aes128_ciphertext[16];
 
 // to receive hci events
 static btstack_packet_callback_registration_t hci_event_callback_registration;
+static uint8_t hci_event_mask[BTSTACK_EVENT_MASK_SIZE];
 
 /* to dispatch sm event */
 static btstack_linked_list_t sm_event_handlers;
@@ -719,6 +720,8 @@ static void gap_random_address_update_handler(btstack_timer_source_t * timer){
 static void gap_random_address_update_start(void){
     btstack_run_loop_set_timer_handler(&gap_random_address_update_timer, gap_random_address_update_handler);
     btstack_run_loop_set_timer(&gap_random_address_update_timer, gap_random_adress_update_period);
+    // update doesn't need to be exact, allow to delay by 1/16 of period
+    btstack_run_loop_set_timer_slack(&gap_random_address_update_timer, (uint16_t) btstack_min(gap_random_adress_update_period / 16u, 0xffffu));
     btstack_run_loop_add_timer(&gap_random_address_update_timer);
 }
 
@@ -4379,8 +4382,15 @@ void sm_init(void){
 
     btstack_run_loop_set_timer_handler(&sm_run_timer, &sm_run_timer_handler);
 
-    // register for HCI Events from HCI
+    // register for handled HCI Events and events that allow to send commands
+    static const uint8_t sm_hci_event_codes[] = {
+        BTSTACK_EVENT_STATE, HCI_EVENT_LE_META, HCI_EVENT_ENCRYPTION_CHANGE, HCI_EVENT_ENCRYPTION_KEY_REFRESH_COMPLETE,
+        HCI_EVENT_DISCONNECTION_COMPLETE, HCI_EVENT_COMMAND_COMPLETE, HCI_EVENT_COMMAND_STATUS, HCI_EVENT_VENDOR_SPECIFIC,
+        HCI_EVENT_TRANSPORT_PACKET_SENT, HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS,
+    };
+    btstack_event_mask_init(hci_event_mask, sm_hci_event_codes, sizeof(sm_hci_event_codes));
     hci_event_callback_registration.callback = &sm_event_packet_handler;
+    hci_event_callback_registration.event_mask = hci_event_mask;
     hci_add_event_handler(&hci_event_callback_registration);
 
     // 
@@ -200,6 +200,9 @@ typedef enum {
 #define ERROR_CODE_CONNECTION_FAILED_TO_BE_ESTABLISHED     0x3E
 #define ERROR_CODE_MAC_CONNECTION_FAILED                   0x3F
 #define ERROR_CODE_COARSE_CLOCK_ADJUSTMENT_REJECTED_BUT_WILL_TRY_TO_ADJUST_USING_CLOCK_DRAGGING 0x40
+#define ERROR_CODE_TYPE0_SUBMAP_NOT_DEFINED                0x41
+#define ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER          0x42
+#define ERROR_CODE_LIMIT_REACHED                           0x43
 
 // BTstack defined ERRORS, mapped into BLuetooth status code range
 
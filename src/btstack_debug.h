@@ -94,14 +94,30 @@ void btstack_assert_failed(const char * file, uint16_t line_nr);
 #define HCI_DUMP_LOG(log_level, format, ...) hci_dump_log(log_level, "%s.%u: " format, BTSTACK_FILE__, __LINE__, ## __VA_ARGS__)
 #endif
 
+#ifdef ENABLE_LOG_DEFERRED
+#include "btstack_log_deferred.h"
+#define BTSTACK_LOG_STRINGIFY_(x) #x
+#define BTSTACK_LOG_STRINGIFY(x)  BTSTACK_LOG_STRINGIFY_(x)
+// file and line are part of the constant format string
+#define BTSTACK_LOG_DEFERRED(log_level, format, ...) btstack_log_deferred(log_level, BTSTACK_FILE__ "." BTSTACK_LOG_STRINGIFY(__LINE__) ": " format, ## __VA_ARGS__)
+#endif
+
 #ifdef ENABLE_LOG_DEBUG
+#ifdef ENABLE_LOG_DEFERRED
+#define log_debug(format, ...)  BTSTACK_LOG_DEFERRED(HCI_DUMP_LOG_LEVEL_DEBUG, format,  ## __VA_ARGS__)
+#else
 #define log_debug(format, ...)  HCI_DUMP_LOG(HCI_DUMP_LOG_LEVEL_DEBUG, format,  ## __VA_ARGS__)
+#endif
 #else
 #define log_debug(...) (void)(0)
 #endif
 
 #ifdef ENABLE_LOG_INFO
+#ifdef ENABLE_LOG_DEFERRED
+#define log_info(format, ...)  BTSTACK_LOG_DEFERRED(HCI_DUMP_LOG_LEVEL_INFO, format,  ## __VA_ARGS__)
+#else
 #define log_info(format, ...)  HCI_DUMP_LOG(HCI_DUMP_LOG_LEVEL_INFO, format,  ## __VA_ARGS__)
+#endif
 #else
 #define log_info(...) (void)(0)
 #endif
@@ -57,10 +57,15 @@
 // packet handler
 typedef void (*btstack_packet_handler_t) (uint8_t packet_type, uint16_t channel, uint8_t *packet, uint16_t size);
 
+// event mask with one bit per event code, see btstack_event_mask_init
+#define BTSTACK_EVENT_MASK_SIZE 32
+
 // packet callback supporting multiple registrations
 typedef struct {
     btstack_linked_item_t    item;
     btstack_packet_handler_t callback;
+    // optional, events not in mask are skipped by hci_add_event_handler registrations. NULL = all events
+    const uint8_t *          event_mask;
 } btstack_packet_callback_registration_t;
 
 // context callback supporting multiple registrations
@@ -644,6 +649,29 @@ typedef uint8_t sm_key_t[16];
 // array of advertisements, not handled by event accessor generator
 #define HCI_SUBEVENT_LE_DIRECT_ADVERTISING_REPORT          0x0B
 
+/**
+ * @format 11H11
+ * @param subevent_code
+ * @param status
+ * @param connection_handle
+ * @param tx_phy
+ * @param rx_phy
+ */
+#define HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE                0x0C
+
+// array of advertisements, not handled by event accessor generator
+#define HCI_SUBEVENT_LE_EXTENDED_ADVERTISING_REPORT        0x0D
+
+/**
+ * @format 111H1
+ * @param subevent_code
+ * @param status
+ * @param advertising_handle
+ * @param connection_handle
+ * @param num_completed_extended_advertising_events
+ */
+#define HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED         0x12
+
 
 /**
  * @format 1
@@ -668,6 +696,16 @@ typedef uint8_t sm_key_t[16];
  */
 #define BTSTACK_EVENT_DISCOVERABLE_ENABLED                 0x66
 
+/**
+ * @brief Run loop handler took longer than budget, see btstack_run_loop_profiler_set_budget
+ * @format 1244
+ * @param handler_type
+ * @param handler_index
+ * @param duration_us
+ * @param budget_us
+ */
+#define BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED     0x6A
+
 // Daemon Events
 
 /**
@@ -1386,6 +1424,35 @@ typedef uint8_t sm_key_t[16];
  */
 #define GAP_EVENT_RSSI_MEASUREMENT                            0xE5
 
+/**
+ * @format 21B1111121BJV
+ * @param advertising_event_type
+ * @param address_type
+ * @param address
+ * @param primary_phy
+ * @param secondary_phy
+ * @param advertising_sid
+ * @param tx_power
+ * @param rssi
+ * @param periodic_advertising_interval
+ * @param direct_address_type
+ * @param direct_address
+ * @param data_length
+ * @param data
+ */
+#define GAP_EVENT_EXTENDED_ADVERTISING_REPORT                 0xE6
+
+/**
+ * @format H1122
+ * @param con_handle
+ * @param tx_phy
+ * @param rx_phy
+ * @param max_tx_octets
+ * @param max_rx_octets
+ * @note emitted by ENABLE_LE_THROUGHPUT_POLICY when PHY and data length negotiation after connect is complete
+ */
+#define GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE               0xE7
+
 // Meta Events, see below for sub events
 #define HCI_EVENT_HSP_META                                 0xE8
 #define HCI_EVENT_HFP_META                                 0xE9
@@ -1117,6 +1117,43 @@ static inline uint8_t btstack_event_discoverable_enabled_get_discoverable(const
     return event[2];
 }
 
+/**
+ * @brief Get field handler_type from event BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ * @param event packet
+ * @return handler_type
+ * @note: btstack_type 1
+ */
+static inline uint8_t btstack_event_run_loop_handler_budget_exceeded_get_handler_type(const uint8_t * event){
+    return event[2];
+}
+/**
+ * @brief Get field handler_index from event BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ * @param event packet
+ * @return handler_index
+ * @note: btstack_type 2
+ */
+static inline uint16_t btstack_event_run_loop_handler_budget_exceeded_get_handler_index(const uint8_t * event){
+    return little_endian_read_16(event, 3);
+}
+/**
+ * @brief Get field duration_us from event BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ * @param event packet
+ * @return duration_us
+ * @note: btstack_type 4
+ */
+static inline uint32_t btstack_event_run_loop_handler_budget_exceeded_get_duration_us(const uint8_t * event){
+    return little_endian_read_32(event, 5);
+}
+/**
+ * @brief Get field budget_us from event BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ * @param event packet
+ * @return budget_us
+ * @note: btstack_type 4
+ */
+static inline uint32_t btstack_event_run_loop_handler_budget_exceeded_get_budget_us(const uint8_t * event){
+    return little_endian_read_32(event, 9);
+}
+
 /**
  * @brief Get field active from event HCI_EVENT_TRANSPORT_SLEEP_MODE
  * @param event packet
@@ -3325,6 +3362,170 @@ static inline uint8_t gap_event_rssi_measurement_get_rssi(const uint8_t * event)
     return event[4];
 }
 
+/**
+ * @brief Get field advertising_event_type from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return advertising_event_type
+ * @note: btstack_type 2
+ */
+static inline uint16_t gap_event_extended_advertising_report_get_advertising_event_type(const uint8_t * event){
+    return little_endian_read_16(event, 2);
+}
+/**
+ * @brief Get field address_type from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return address_type
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_address_type(const uint8_t * event){
+    return event[4];
+}
+/**
+ * @brief Get field address from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @param Pointer to storage for address
+ * @note: btstack_type B
+ */
+static inline void gap_event_extended_advertising_report_get_address(const uint8_t * event, bd_addr_t address){
+    reverse_bytes(&event[5], address, 6);
+}
+/**
+ * @brief Get field primary_phy from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return primary_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_primary_phy(const uint8_t * event){
+    return event[11];
+}
+/**
+ * @brief Get field secondary_phy from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return secondary_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_secondary_phy(const uint8_t * event){
+    return event[12];
+}
+/**
+ * @brief Get field advertising_sid from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return advertising_sid
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_advertising_sid(const uint8_t * event){
+    return event[13];
+}
+/**
+ * @brief Get field tx_power from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return tx_power
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_tx_power(const uint8_t * event){
+    return event[14];
+}
+/**
+ * @brief Get field rssi from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return rssi
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_rssi(const uint8_t * event){
+    return event[15];
+}
+/**
+ * @brief Get field periodic_advertising_interval from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return periodic_advertising_interval
+ * @note: btstack_type 2
+ */
+static inline uint16_t gap_event_extended_advertising_report_get_periodic_advertising_interval(const uint8_t * event){
+    return little_endian_read_16(event, 16);
+}
+/**
+ * @brief Get field direct_address_type from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return direct_address_type
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_direct_address_type(const uint8_t * event){
+    return event[18];
+}
+/**
+ * @brief Get field direct_address from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @param Pointer to storage for direct_address
+ * @note: btstack_type B
+ */
+static inline void gap_event_extended_advertising_report_get_direct_address(const uint8_t * event, bd_addr_t direct_address){
+    reverse_bytes(&event[19], direct_address, 6);
+}
+/**
+ * @brief Get field data_length from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return data_length
+ * @note: btstack_type J
+ */
+static inline uint8_t gap_event_extended_advertising_report_get_data_length(const uint8_t * event){
+    return event[25];
+}
+/**
+ * @brief Get field data from event GAP_EVENT_EXTENDED_ADVERTISING_REPORT
+ * @param event packet
+ * @return data
+ * @note: btstack_type V
+ */
+static inline const uint8_t * gap_event_extended_advertising_report_get_data(const uint8_t * event){
+    return &event[26];
+}
+
+/**
+ * @brief Get field con_handle from event GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE
+ * @param event packet
+ * @return con_handle
+ * @note: btstack_type H
+ */
+static inline hci_con_handle_t gap_event_le_throughput_policy_complete_get_con_handle(const uint8_t * event){
+    return little_endian_read_16(event, 2);
+}
+/**
+ * @brief Get field tx_phy from event GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE
+ * @param event packet
+ * @return tx_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_le_throughput_policy_complete_get_tx_phy(const uint8_t * event){
+    return event[4];
+}
+/**
+ * @brief Get field rx_phy from event GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE
+ * @param event packet
+ * @return rx_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t gap_event_le_throughput_policy_complete_get_rx_phy(const uint8_t * event){
+    return event[5];
+}
+/**
+ * @brief Get field max_tx_octets from event GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE
+ * @param event packet
+ * @return max_tx_octets
+ * @note: btstack_type 2
+ */
+static inline uint16_t gap_event_le_throughput_policy_complete_get_max_tx_octets(const uint8_t * event){
+    return little_endian_read_16(event, 6);
+}
+/**
+ * @brief Get field max_rx_octets from event GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE
+ * @param event packet
+ * @return max_rx_octets
+ * @note: btstack_type 2
+ */
+static inline uint16_t gap_event_le_throughput_policy_complete_get_max_rx_octets(const uint8_t * event){
+    return little_endian_read_16(event, 8);
+}
+
 /**
  * @brief Get field status from event HCI_SUBEVENT_LE_CONNECTION_COMPLETE
  * @param event packet
@@ -3748,6 +3949,80 @@ static inline uint8_t hci_subevent_le_enhanced_connection_complete_get_master_cl
     return event[32];
 }
 
+/**
+ * @brief Get field status from event HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE
+ * @param event packet
+ * @return status
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_phy_update_complete_get_status(const uint8_t * event){
+    return event[3];
+}
+/**
+ * @brief Get field connection_handle from event HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE
+ * @param event packet
+ * @return connection_handle
+ * @note: btstack_type H
+ */
+static inline hci_con_handle_t hci_subevent_le_phy_update_complete_get_connection_handle(const uint8_t * event){
+    return little_endian_read_16(event, 4);
+}
+/**
+ * @brief Get field tx_phy from event HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE
+ * @param event packet
+ * @return tx_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_phy_update_complete_get_tx_phy(const uint8_t * event){
+    return event[6];
+}
+/**
+ * @brief Get field rx_phy from event HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE
+ * @param event packet
+ * @return rx_phy
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_phy_update_complete_get_rx_phy(const uint8_t * event){
+    return event[7];
+}
+
+/**
+ * @brief Get field status from event HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED
+ * @param event packet
+ * @return status
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_advertising_set_terminated_get_status(const uint8_t * event){
+    return event[3];
+}
+/**
+ * @brief Get field advertising_handle from event HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED
+ * @param event packet
+ * @return advertising_handle
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_advertising_set_terminated_get_advertising_handle(const uint8_t * event){
+    return event[4];
+}
+/**
+ * @brief Get field connection_handle from event HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED
+ * @param event packet
+ * @return connection_handle
+ * @note: btstack_type H
+ */
+static inline hci_con_handle_t hci_subevent_le_advertising_set_terminated_get_connection_handle(const uint8_t * event){
+    return little_endian_read_16(event, 5);
+}
+/**
+ * @brief Get field num_completed_extended_advertising_events from event HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED
+ * @param event packet
+ * @return num_completed_extended_advertising_events
+ * @note: btstack_type 1
+ */
+static inline uint8_t hci_subevent_le_advertising_set_terminated_get_num_completed_extended_advertising_events(const uint8_t * event){
+    return event[7];
+}
+
 /**
  * @brief Get field status from event HSP_SUBEVENT_RFCOMM_CONNECTION_COMPLETE
  * @param event packet
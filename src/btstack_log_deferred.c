@@ -0,0 +1,286 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_log_deferred.c"
+
+/*
+ *  btstack_log_deferred.c
+ *
+ *  Arguments are serialized by walking the format string, which is considerably cheaper
+ *  than formatting the message. The ids of recently used format strings are kept in a
+ *  small direct-mapped cache, a format string is stored again after it was evicted.
+ */
+
+#include "btstack_log_deferred.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "btstack_config.h"
+#include "btstack_ring_buffer.h"
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+#include "hci_dump.h"
+
+// number of format strings cached, must be a power of two
+#ifndef BTSTACK_LOG_DEFERRED_FORMAT_CACHE_SIZE
+#define BTSTACK_LOG_DEFERRED_FORMAT_CACHE_SIZE 64
+#endif
+
+// max size of serialized arguments
+#ifndef BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN
+#define BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN 128
+#endif
+
+#define BTSTACK_LOG_DEFERRED_FORMAT_HEADER_LEN  5
+#define BTSTACK_LOG_DEFERRED_LOG_HEADER_LEN    10
+#define BTSTACK_LOG_DEFERRED_DROPPED_LEN        5
+
+typedef struct {
+    const char * format;
+    uint16_t     id;
+} btstack_log_deferred_format_t;
+
+static btstack_ring_buffer_t         log_deferred_ring_buffer;
+static bool                          log_deferred_active;
+static btstack_log_deferred_format_t log_deferred_formats[BTSTACK_LOG_DEFERRED_FORMAT_CACHE_SIZE];
+static uint16_t                      log_deferred_next_id;
+static uint32_t                      log_deferred_num_dropped;
+
+void btstack_log_deferred_init(uint8_t * storage, uint32_t storage_size){
+    btstack_ring_buffer_init(&log_deferred_ring_buffer, storage, storage_size);
+    memset(log_deferred_formats, 0, sizeof(log_deferred_formats));
+    log_deferred_next_id = 0;
+    log_deferred_num_dropped = 0;
+    log_deferred_active = true;
+}
+
+static uint16_t btstack_log_deferred_store_64(uint8_t * buffer, uint16_t pos, uint64_t value){
+    little_endian_store_32(buffer, pos,     (uint32_t) value);
+    little_endian_store_32(buffer, pos + 4, (uint32_t) (value >> 32));
+    return pos + 8u;
+}
+
+// serialize arguments according to format, stops if buffer is full
+static uint16_t btstack_log_deferred_store_args(uint8_t * buffer, const char * format, va_list argptr){
+    uint16_t pos = 0;
+    while (*format != 0){
+        if (*format++ != '%') continue;
+        if (*format == '%') {
+            format++;
+            continue;
+        }
+        // flags
+        while ((*format == '-') || (*format == '+') || (*format == ' ') || (*format == '#') || (*format == '0')){
+            format++;
+        }
+        // width and precision, negative precision is taken as if it was omitted
+        bool precision = false;
+        int  precision_value = -1;
+        while (true){
+            if (*format == '*'){
+                if ((pos + 4u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                int star_value = va_arg(argptr, int);
+                little_endian_store_32(buffer, pos, (uint32_t) star_value);
+                pos += 4u;
+                if (precision){
+                    precision_value = star_value;
+                }
+            } else if ((*format == '.') && !precision){
+                precision = true;
+                precision_value = 0;
+            } else if ((*format >= '0') && (*format <= '9')){
+                if (precision && (precision_value < 0xffff)){
+                    precision_value = (precision_value * 10) + (*format - '0');
+                }
+            } else {
+                break;
+            }
+            format++;
+        }
+        // length modifier
+        uint8_t num_long = 0;
+        bool size_t_arg  = false;
+        while ((*format == 'h') || (*format == 'l') || (*format == 'z') || (*format == 'j') || (*format == 't') || (*format == 'L')){
+            if (*format == 'l') {
+                num_long++;
+            }
+            if ((*format == 'z') || (*format == 'j') || (*format == 't')){
+                size_t_arg = true;
+            }
+            format++;
+        }
+        uint64_t value;
+        switch (*format){
+            case 'd':
+            case 'i':
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+            case 'c':
+                if ((num_long == 0u) && !size_t_arg){
+                    if ((pos + 4u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                    little_endian_store_32(buffer, pos, (uint32_t) va_arg(argptr, int));
+                    pos += 4u;
+                    break;
+                }
+                if (num_long == 1u){
+                    value = (uint64_t) va_arg(argptr, long);
+                } else if (num_long > 1u){
+                    value = (uint64_t) va_arg(argptr, long long);
+                } else {
+                    value = (uint64_t) va_arg(argptr, size_t);
+                }
+                if ((pos + 8u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                pos = btstack_log_deferred_store_64(buffer, pos, value);
+                break;
+            case 'p':
+                if ((pos + 8u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                pos = btstack_log_deferred_store_64(buffer, pos, (uint64_t) (uintptr_t) va_arg(argptr, void *));
+                break;
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                double number = va_arg(argptr, double);
+                if ((pos + 8u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                (void) memcpy(&value, &number, sizeof(value));
+                pos = btstack_log_deferred_store_64(buffer, pos, value);
+                break;
+            }
+            case 's': {
+                const char * string = va_arg(argptr, const char *);
+                if (string == NULL){
+                    string = "(null)";
+                }
+                if ((pos + 1u) > BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN) return pos;
+                // with precision, string does not need to be NUL-terminated
+                uint16_t len_max = (uint16_t) btstack_min(BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN - pos - 1u, 255u);
+                if (precision_value >= 0){
+                    len_max = (uint16_t) btstack_min(len_max, (uint32_t) precision_value);
+                }
+                const char * string_end = (const char *) memchr(string, 0, len_max);
+                uint16_t len = (string_end != NULL) ? (uint16_t) (string_end - string) : len_max;
+                buffer[pos++] = (uint8_t) len;
+                (void) memcpy(&buffer[pos], string, len);
+                pos += len;
+                break;
+            }
+            default:
+                // unsupported conversion, e.g. %n
+                return pos;
+        }
+        format++;
+    }
+    return pos;
+}
+
+void btstack_log_deferred_va_arg(int log_level, const char * format, va_list argptr){
+    if (!log_deferred_active) return;
+    if (!hci_dump_log_level_active(log_level)) return;
+
+    uint8_t record[BTSTACK_LOG_DEFERRED_LOG_HEADER_LEN + BTSTACK_LOG_DEFERRED_MAX_ARGS_LEN];
+    uint16_t args_len = btstack_log_deferred_store_args(&record[BTSTACK_LOG_DEFERRED_LOG_HEADER_LEN], format, argptr);
+    uint16_t record_len = BTSTACK_LOG_DEFERRED_LOG_HEADER_LEN + args_len;
+
+    // lookup format string id
+    btstack_log_deferred_format_t * entry = &log_deferred_formats[(((uintptr_t) format) ^ (((uintptr_t) format) >> 6)) & (BTSTACK_LOG_DEFERRED_FORMAT_CACHE_SIZE - 1)];
+    bool format_known = entry->format == format;
+    uint16_t format_len = 0;
+    uint32_t total_len = record_len;
+    if (!format_known){
+        format_len = (uint16_t) btstack_min(strlen(format), 0xffffu);
+        total_len += BTSTACK_LOG_DEFERRED_FORMAT_HEADER_LEN + format_len;
+    }
+    if (log_deferred_num_dropped > 0u){
+        total_len += BTSTACK_LOG_DEFERRED_DROPPED_LEN;
+    }
+    if (btstack_ring_buffer_bytes_free(&log_deferred_ring_buffer) < total_len){
+        log_deferred_num_dropped++;
+        return;
+    }
+
+    if (log_deferred_num_dropped > 0u){
+        uint8_t dropped[BTSTACK_LOG_DEFERRED_DROPPED_LEN];
+        dropped[0] = BTSTACK_LOG_DEFERRED_RECORD_TYPE_DROPPED;
+        little_endian_store_32(dropped, 1, log_deferred_num_dropped);
+        btstack_ring_buffer_write(&log_deferred_ring_buffer, dropped, sizeof(dropped));
+        log_deferred_num_dropped = 0;
+    }
+
+    if (!format_known){
+        uint8_t format_header[BTSTACK_LOG_DEFERRED_FORMAT_HEADER_LEN];
+        entry->format = format;
+        entry->id     = log_deferred_next_id++;
+        format_header[0] = BTSTACK_LOG_DEFERRED_RECORD_TYPE_FORMAT;
+        little_endian_store_16(format_header, 1, entry->id);
+        little_endian_store_16(format_header, 3, format_len);
+        btstack_ring_buffer_write(&log_deferred_ring_buffer, format_header, sizeof(format_header));
+        btstack_ring_buffer_write(&log_deferred_ring_buffer, (uint8_t *) format, format_len);
+    }
+
+    record[0] = BTSTACK_LOG_DEFERRED_RECORD_TYPE_LOG;
+    record[1] = (uint8_t) log_level;
+    little_endian_store_16(record, 2, entry->id);
+    little_endian_store_32(record, 4, btstack_run_loop_get_time_ms());
+    little_endian_store_16(record, 8, args_len);
+    btstack_ring_buffer_write(&log_deferred_ring_buffer, record, record_len);
+}
+
+void btstack_log_deferred(int log_level, const char * format, ...){
+    va_list argptr;
+    va_start(argptr, format);
+    btstack_log_deferred_va_arg(log_level, format, argptr);
+    va_end(argptr);
+}
+
+uint32_t btstack_log_deferred_read(uint8_t * buffer, uint32_t buffer_size){
+    if (!log_deferred_active) return 0;
+    uint32_t bytes_read = 0;
+    btstack_ring_buffer_read(&log_deferred_ring_buffer, buffer, buffer_size, &bytes_read);
+    return bytes_read;
+}
+
+uint32_t btstack_log_deferred_bytes_available(void){
+    if (!log_deferred_active) return 0;
+    return btstack_ring_buffer_bytes_available(&log_deferred_ring_buffer);
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/*
+ *  btstack_log_deferred.h
+ *
+ *  @Brief Deferred binary logging for log_info and log_debug
+ *
+ *  With ENABLE_LOG_DEFERRED, log_info and log_debug don't format their message. Instead, a reference
+ *  to the format string, a timestamp and the raw arguments are stored in a binary ring buffer.
+ *  Each format string is stored once together with a short id. The application reads the
+ *  binary stream via btstack_log_deferred_read, e.g. to store it in a file or to send it via UART,
+ *  and tool/btstack_log_deferred_decoder.py formats the messages offline.
+ *
+ *  Strings passed via %s are copied (up to 255 chars, or up to the precision for %.Ns and %.*s)
+ *  as they might not be valid later. Log levels disabled with hci_dump_enable_log_level are not stored.
+ *
+ *  Stream format (little endian):
+ *  - Format:  0x01, id (2), len (2), format string
+ *  - Log:     0x02, log level (1), id (2), timestamp ms (4), args len (2), args
+ *             - integer and char args: 4 bytes, with l, ll, z, j, t length modifier: 8 bytes
+ *             - %p, floating point: 8 bytes
+ *             - %s: len (1), chars
+ *  - Dropped: 0x03, number of log messages dropped as ring buffer was full (4)
+ */
+
+#ifndef BTSTACK_LOG_DEFERRED_H
+#define BTSTACK_LOG_DEFERRED_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdarg.h>
+
+#define BTSTACK_LOG_DEFERRED_RECORD_TYPE_FORMAT  0x01
+#define BTSTACK_LOG_DEFERRED_RECORD_TYPE_LOG     0x02
+#define BTSTACK_LOG_DEFERRED_RECORD_TYPE_DROPPED 0x03
+
+/* API_START */
+
+/**
+ * @brief Init deferred log with storage for binary ring buffer. Call after btstack_run_loop_init
+ * @note log messages are ignored before init
+ * @param storage
+ * @param storage_size
+ */
+void btstack_log_deferred_init(uint8_t * storage, uint32_t storage_size);
+
+/**
+ * @brief Store log message, used by log_info and log_debug with ENABLE_LOG_DEFERRED
+ * @param log_level
+ * @param format string, needs to be valid until the stream has been decoded, e.g. a string literal
+ */
+void btstack_log_deferred(int log_level, const char * format, ...)
+#ifdef __GNUC__
+__attribute__ ((format (__printf__, 2, 3)))
+#endif
+;
+
+/**
+ * @brief Store log message with va_list
+ * @param log_level
+ * @param format string
+ * @param argptr
+ */
+void btstack_log_deferred_va_arg(int log_level, const char * format, va_list argptr);
+
+/**
+ * @brief Read binary log stream
+ * @param buffer
+ * @param buffer_size
+ * @return number of bytes read
+ */
+uint32_t btstack_log_deferred_read(uint8_t * buffer, uint32_t buffer_size);
+
+/**
+ * @brief Get number of bytes in ring buffer
+ * @return bytes available for read
+ */
+uint32_t btstack_log_deferred_bytes_available(void);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // BTSTACK_LOG_DEFERRED_H
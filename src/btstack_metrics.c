@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_metrics.c"
+
+/*
+ *  btstack_metrics.c
+ */
+
+#include "btstack_metrics.h"
+
+#include <string.h>
+
+#include "btstack_run_loop.h"
+
+btstack_metrics_t btstack_metrics;
+static uint32_t   btstack_metrics_reset_ms;
+
+void btstack_metrics_get_snapshot(btstack_metrics_t * snapshot){
+    (void) memcpy(snapshot, &btstack_metrics, sizeof(btstack_metrics_t));
+    snapshot->period_ms = btstack_run_loop_get_time_ms() - btstack_metrics_reset_ms;
+}
+
+void btstack_metrics_reset(void){
+    (void) memset(&btstack_metrics, 0, sizeof(btstack_metrics_t));
+    btstack_metrics_reset_ms = btstack_run_loop_get_time_ms();
+}
+
+void btstack_metrics_histogram_add(btstack_metrics_histogram_t * histogram, uint32_t value){
+    histogram->count++;
+    histogram->sum += value;
+    if (value > histogram->max){
+        histogram->max = value;
+    }
+    uint8_t bucket = 0;
+    while ((value > 0u) && (bucket < (BTSTACK_METRICS_HISTOGRAM_NUM_BUCKETS - 1u))){
+        value >>= 1;
+        bucket++;
+    }
+    histogram->buckets[bucket]++;
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/*
+ *  btstack_metrics.h
+ *
+ *  @Brief Optional performance counters and histograms, enabled by ENABLE_BTSTACK_METRICS
+ *
+ *  Global counters are updated by HCI, L2CAP, ATT Server and RFCOMM. In addition, HCI counts
+ *  packets and bytes per connection, see hci_get_connection_metrics, and L2CAP per channel,
+ *  see l2cap_get_channel_metrics.
+ */
+
+#ifndef BTSTACK_METRICS_H
+#define BTSTACK_METRICS_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "btstack_config.h"
+
+// bucket 0: value 0, bucket i: value in [2^(i-1), 2^i), last bucket: all larger values
+#define BTSTACK_METRICS_HISTOGRAM_NUM_BUCKETS 8
+
+typedef struct {
+    uint32_t count;
+    uint32_t sum;
+    uint32_t max;
+    uint32_t buckets[BTSTACK_METRICS_HISTOGRAM_NUM_BUCKETS];
+} btstack_metrics_histogram_t;
+
+typedef struct {
+    // time since last reset
+    uint32_t period_ms;
+
+    // HCI
+    uint32_t hci_commands_sent;
+    uint32_t hci_events_received;
+    btstack_metrics_histogram_t hci_command_latency_ms;
+    uint32_t hci_acl_tx_packets;
+    uint32_t hci_acl_tx_bytes;
+    uint32_t hci_acl_rx_packets;
+    uint32_t hci_acl_rx_bytes;
+    uint32_t hci_sco_tx_packets;
+    uint32_t hci_sco_rx_packets;
+    // outgoing ACL packets not completed by Controller, sampled on send
+    btstack_metrics_histogram_t hci_acl_packets_in_flight;
+
+    // L2CAP
+    uint32_t l2cap_tx_packets;
+    uint32_t l2cap_tx_bytes;
+    uint32_t l2cap_rx_packets;
+    uint32_t l2cap_rx_bytes;
+    // credit-based channel ran out of credits with data pending
+    uint32_t l2cap_credit_stalls;
+    uint32_t l2cap_ertm_retransmissions;
+
+    // ATT Server
+    uint32_t att_server_requests;
+    uint32_t att_server_requests_dropped;
+    uint32_t att_server_notifications_sent;
+    uint32_t att_server_notifications_dropped;
+    uint32_t att_server_indications_sent;
+
+    // RFCOMM
+    uint32_t rfcomm_tx_packets;
+    uint32_t rfcomm_tx_bytes;
+    uint32_t rfcomm_rx_packets;
+    uint32_t rfcomm_rx_bytes;
+    // channel ran out of credits
+    uint32_t rfcomm_credit_stalls;
+} btstack_metrics_t;
+
+typedef struct {
+    uint32_t tx_packets;
+    uint32_t tx_bytes;
+    uint32_t rx_packets;
+    uint32_t rx_bytes;
+} btstack_metrics_connection_t;
+
+typedef struct {
+    uint32_t tx_packets;
+    uint32_t tx_bytes;
+    uint32_t rx_packets;
+    uint32_t rx_bytes;
+    uint32_t credit_stalls;
+} btstack_metrics_channel_t;
+
+#ifdef ENABLE_BTSTACK_METRICS
+extern btstack_metrics_t btstack_metrics;
+#define BTSTACK_METRICS_INC(field)                  btstack_metrics.field++
+#define BTSTACK_METRICS_ADD(field, value)           btstack_metrics.field += (value)
+#define BTSTACK_METRICS_HISTOGRAM_ADD(field, value) btstack_metrics_histogram_add(&btstack_metrics.field, value)
+#else
+#define BTSTACK_METRICS_INC(field)                  (void)(0)
+#define BTSTACK_METRICS_ADD(field, value)           (void)(0)
+#define BTSTACK_METRICS_HISTOGRAM_ADD(field, value) (void)(0)
+#endif
+
+/* API_START */
+
+/**
+ * @brief Get copy of global metrics
+ * @param snapshot
+ */
+void btstack_metrics_get_snapshot(btstack_metrics_t * snapshot);
+
+/**
+ * @brief Reset global metrics and start new period
+ * @note per connection and per channel metrics are not affected
+ */
+void btstack_metrics_reset(void);
+
+/**
+ * @brief Add value to histogram
+ * @param histogram
+ * @param value
+ */
+void btstack_metrics_histogram_add(btstack_metrics_histogram_t * histogram, uint32_t value);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // BTSTACK_METRICS_H
@@ -138,6 +138,15 @@ void * btstack_run_loop_get_timer_context(btstack_timer_source_t *ts){
     return ts->context;
 }
 
+void btstack_run_loop_set_timer_slack(btstack_timer_source_t *ts, uint16_t slack_ms){
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+    ts->slack_ms = slack_ms;
+#else
+    UNUSED(ts);
+    UNUSED(slack_ms);
+#endif
+}
+
 /**
  * Add timer to run_loop (keep list sorted)
  */
@@ -176,6 +185,15 @@ void btstack_run_loop_execute(void){
     the_run_loop->execute();
 }
 
+void btstack_run_loop_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration){
+    btstack_assert(the_run_loop != NULL);
+    if (the_run_loop->execute_on_main_thread){
+        the_run_loop->execute_on_main_thread(callback_registration);
+    } else {
+        log_error("btstack_run_loop_execute_on_main_thread not implemented");
+    }
+}
+
 // init must be called before any other run_loop call
 void btstack_run_loop_init(const btstack_run_loop_t * run_loop){
     btstack_assert(the_run_loop == NULL);
@@ -47,6 +47,7 @@
 #include "btstack_config.h"
 
 #include "btstack_bool.h"
+#include "btstack_defines.h"
 #include "btstack_linked_list.h"
 
 #include <stdint.h>
@@ -87,8 +88,18 @@ typedef struct btstack_data_source {
 
 typedef struct btstack_timer_source {
     btstack_linked_item_t item; 
+#ifdef ENABLE_RUN_LOOP_TIMER_HEAP
+    // pairing heap used by btstack_run_loop_base, item.next is the next sibling
+    struct btstack_timer_source * heap_child;
+    // parent for first child, previous sibling otherwise, NULL if not in heap
+    struct btstack_timer_source * heap_prev;
+#endif
     // timeout in system ticks (HAVE_EMBEDDED_TICK) or milliseconds (HAVE_EMBEDDED_TIME_MS)
     uint32_t timeout;
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+    // timer may fire up to slack_ms after timeout to share wake up with other timers
+    uint16_t slack_ms;
+#endif
     // will be called when timer fired
     void  (*process)(struct btstack_timer_source *ts); 
     void * context;
@@ -106,6 +117,7 @@ typedef struct btstack_run_loop {
 	void (*execute)(void);
 	void (*dump_timer)(void);
 	uint32_t (*get_time_ms)(void);
+	void (*execute_on_main_thread)(btstack_context_callback_registration_t * callback_registration);
 } btstack_run_loop_t;
 
 void btstack_run_loop_timer_dump(void);
@@ -139,6 +151,14 @@ void btstack_run_loop_set_timer_context(btstack_timer_source_t * ts, void * cont
  */
 void * btstack_run_loop_get_timer_context(btstack_timer_source_t * ts);
 
+/**
+ * @brief Allow timer to fire up to slack_ms after its timeout, so that timers with close timeouts are handled in a single wake up
+ * @note Only used with ENABLE_RUN_LOOP_TIMER_SLACK by btstack_run_loop_base, POSIX, epoll and embedded run loops
+ * @param ts
+ * @param slack_ms
+ */
+void btstack_run_loop_set_timer_slack(btstack_timer_source_t * ts, uint16_t slack_ms);
+
 /**
  * @brief Add timer source.
  */
@@ -220,6 +240,14 @@ int btstack_run_loop_remove_data_source(btstack_data_source_t * data_source);
  */
 void btstack_run_loop_execute(void);
 
+/**
+ * @brief Execute callback on the run loop thread. Can be called from any thread.
+ * @note The callback registration must not be modified or queued again until its callback was called
+ * @note Not supported by all run loop implementations
+ * @param callback_registration with callback and context
+ */
+void btstack_run_loop_execute_on_main_thread(btstack_context_callback_registration_t * callback_registration);
+
 /* API_END */
 
 #if defined __cplusplus
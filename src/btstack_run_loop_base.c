@@ -48,6 +48,7 @@
 #include "btstack_util.h"
 
 #include "btstack_run_loop_base.h"
+#include "btstack_run_loop_profiler.h"
 
 // private data (access only by run loop implementations)
 btstack_linked_list_t btstack_run_loop_base_timers;
@@ -74,6 +75,153 @@ void btstack_run_loop_base_disable_data_source_callbacks(btstack_data_source_t *
     ds->flags &= ~callback_types;
 }
 
+#ifdef ENABLE_RUN_LOOP_TIMER_HEAP
+
+// Timers are kept in a pairing heap with the earliest timeout at the root, stored in btstack_run_loop_base_timers.
+// Add is O(1), removing the first or any other timer is O(log n) amortized. Timers with the same timeout
+// fire in unspecified order
+
+#define TIMER_HEAP_NEXT(ts) ((btstack_timer_source_t *) (ts)->item.next)
+
+static btstack_timer_source_t * btstack_run_loop_base_heap_meld(btstack_timer_source_t * a, btstack_timer_source_t * b){
+    if (a == NULL) return b;
+    if (b == NULL) return a;
+    if (btstack_time_delta(b->timeout, a->timeout) < 0){
+        btstack_timer_source_t * tmp = a;
+        a = b;
+        b = tmp;
+    }
+    // b becomes first child of a
+    b->item.next = (btstack_linked_item_t *) a->heap_child;
+    if (a->heap_child != NULL){
+        a->heap_child->heap_prev = b;
+    }
+    b->heap_prev = a;
+    a->heap_child = b;
+    return a;
+}
+
+// two-pass pairing of sibling list, returns new root
+static btstack_timer_source_t * btstack_run_loop_base_heap_merge_pairs(btstack_timer_source_t * first){
+    // meld pairs from left to right, collect them in reverse order
+    btstack_timer_source_t * pairs = NULL;
+    while (first != NULL){
+        btstack_timer_source_t * a = first;
+        btstack_timer_source_t * b = TIMER_HEAP_NEXT(a);
+        first = (b != NULL) ? TIMER_HEAP_NEXT(b) : NULL;
+        a->item.next = NULL;
+        a->heap_prev = NULL;
+        if (b != NULL){
+            b->item.next = NULL;
+            b->heap_prev = NULL;
+        }
+        a = btstack_run_loop_base_heap_meld(a, b);
+        a->item.next = (btstack_linked_item_t *) pairs;
+        pairs = a;
+    }
+    // meld pairs from right to left
+    btstack_timer_source_t * root = NULL;
+    while (pairs != NULL){
+        btstack_timer_source_t * next = TIMER_HEAP_NEXT(pairs);
+        pairs->item.next = NULL;
+        root = btstack_run_loop_base_heap_meld(root, pairs);
+        pairs = next;
+    }
+    return root;
+}
+
+bool btstack_run_loop_base_remove_timer(btstack_timer_source_t *ts){
+    btstack_timer_source_t * root = (btstack_timer_source_t *) btstack_run_loop_base_timers;
+    if (ts == root){
+        root = btstack_run_loop_base_heap_merge_pairs(ts->heap_child);
+    } else {
+        if (ts->heap_prev == NULL) return false;
+        // unlink from parent or previous sibling
+        if (ts->heap_prev->heap_child == ts){
+            ts->heap_prev->heap_child = TIMER_HEAP_NEXT(ts);
+        } else {
+            ts->heap_prev->item.next = ts->item.next;
+        }
+        if (ts->item.next != NULL){
+            TIMER_HEAP_NEXT(ts)->heap_prev = ts->heap_prev;
+        }
+        root = btstack_run_loop_base_heap_meld(root, btstack_run_loop_base_heap_merge_pairs(ts->heap_child));
+    }
+    ts->item.next  = NULL;
+    ts->heap_prev  = NULL;
+    ts->heap_child = NULL;
+    btstack_run_loop_base_timers = (btstack_linked_list_t) root;
+    return true;
+}
+
+void btstack_run_loop_base_add_timer(btstack_timer_source_t *ts){
+    btstack_timer_source_t * root = (btstack_timer_source_t *) btstack_run_loop_base_timers;
+    // don't add timer that's already in there
+    if ((ts == root) || (ts->heap_prev != NULL)){
+        log_error( "btstack_run_loop_timer_add error: timer to add already in list!");
+        return;
+    }
+    ts->item.next  = NULL;
+    ts->heap_child = NULL;
+    btstack_run_loop_base_timers = (btstack_linked_list_t) btstack_run_loop_base_heap_meld(root, ts);
+}
+
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+static btstack_timer_source_t * btstack_run_loop_base_heap_parent(btstack_timer_source_t * ts){
+    while (ts->heap_prev->heap_child != ts){
+        ts = ts->heap_prev;
+    }
+    return ts->heap_prev;
+}
+
+// earliest timeout + slack, only subtrees with a timeout before the current result are visited
+static uint32_t btstack_run_loop_base_get_wake_up_time(void){
+    btstack_timer_source_t * root = (btstack_timer_source_t *) btstack_run_loop_base_timers;
+    uint32_t wake_up = root->timeout + root->slack_ms;
+    btstack_timer_source_t * ts = root->heap_child;
+    while (ts != NULL){
+        if (btstack_time_delta(ts->timeout, wake_up) < 0){
+            uint32_t deadline = ts->timeout + ts->slack_ms;
+            if (btstack_time_delta(deadline, wake_up) < 0){
+                wake_up = deadline;
+            }
+            if (ts->heap_child != NULL){
+                ts = ts->heap_child;
+                continue;
+            }
+        }
+        // continue with next sibling of timer or of its closest ancestor
+        while ((ts != NULL) && (ts->item.next == NULL)){
+            ts = btstack_run_loop_base_heap_parent(ts);
+            if (ts == root){
+                ts = NULL;
+            }
+        }
+        if (ts != NULL){
+            ts = TIMER_HEAP_NEXT(ts);
+        }
+    }
+    return wake_up;
+}
+#endif
+
+#ifdef ENABLE_LOG_INFO
+static void btstack_run_loop_base_heap_dump(btstack_timer_source_t * ts, uint16_t depth){
+    for (; ts != NULL; ts = TIMER_HEAP_NEXT(ts)){
+        log_info("timer depth %u (%p): timeout %u\n", depth, ts, ts->timeout);
+        btstack_run_loop_base_heap_dump(ts->heap_child, depth + 1u);
+    }
+}
+#endif
+
+void btstack_run_loop_base_dump_timer(void){
+#ifdef ENABLE_LOG_INFO
+    btstack_run_loop_base_heap_dump((btstack_timer_source_t *) btstack_run_loop_base_timers, 0);
+#endif
+}
+
+#else
+
 bool btstack_run_loop_base_remove_timer(btstack_timer_source_t *ts){
     return btstack_linked_list_remove(&btstack_run_loop_base_timers, (btstack_linked_item_t *) ts);
 }
@@ -95,16 +243,21 @@ void btstack_run_loop_base_add_timer(btstack_timer_source_t *ts){
     it->next = (btstack_linked_item_t *) ts;
 }
 
-void btstack_run_loop_base_process_timers(uint32_t now){
-    // process timers, exit when timeout is in the future
-    while (btstack_run_loop_base_timers) {
-        btstack_timer_source_t * ts = (btstack_timer_source_t *) btstack_run_loop_base_timers;
-        int32_t delta = btstack_time_delta(ts->timeout, now);
-        if (delta > 0) break;
-        btstack_run_loop_base_remove_timer(ts);
-        ts->process(ts);
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+// earliest timeout + slack, timers after the current result cannot lower it
+static uint32_t btstack_run_loop_base_get_wake_up_time(void){
+    btstack_timer_source_t * ts = (btstack_timer_source_t *) btstack_run_loop_base_timers;
+    uint32_t wake_up = ts->timeout + ts->slack_ms;
+    for (ts = (btstack_timer_source_t *) ts->item.next; ts != NULL; ts = (btstack_timer_source_t *) ts->item.next){
+        if (btstack_time_delta(ts->timeout, wake_up) >= 0) break;
+        uint32_t deadline = ts->timeout + ts->slack_ms;
+        if (btstack_time_delta(deadline, wake_up) < 0){
+            wake_up = deadline;
+        }
     }
+    return wake_up;
 }
+#endif
 
 void btstack_run_loop_base_dump_timer(void){
 #ifdef ENABLE_LOG_INFO
@@ -117,14 +270,36 @@ void btstack_run_loop_base_dump_timer(void){
 #endif
 
 }
+
+#endif
+
+void btstack_run_loop_base_process_timers(uint32_t now){
+    // process timers, exit when timeout is in the future
+    while (btstack_run_loop_base_timers) {
+        btstack_timer_source_t * ts = (btstack_timer_source_t *) btstack_run_loop_base_timers;
+        int32_t delta = btstack_time_delta(ts->timeout, now);
+        if (delta > 0) break;
+        btstack_run_loop_base_remove_timer(ts);
+        // timer might be freed by its handler
+        void (*process)(btstack_timer_source_t * timer) = ts->process;
+        BTSTACK_RUN_LOOP_PROFILER_BEGIN(profiler_start);
+        (*process)(ts);
+        BTSTACK_RUN_LOOP_PROFILER_END(profiler_start, BTSTACK_RUN_LOOP_PROFILER_HANDLER_TIMER, process);
+    }
+}
+
 /**
  * @brief Get time until first timer fires
  * @returns -1 if no timers, time until next timeout otherwise
  */
 int32_t btstack_run_loop_base_get_time_until_timeout(uint32_t now){
     if (btstack_run_loop_base_timers == NULL) return -1;
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+    uint32_t list_timeout = btstack_run_loop_base_get_wake_up_time();
+#else
     btstack_timer_source_t * ts = (btstack_timer_source_t *) btstack_run_loop_base_timers;
     uint32_t list_timeout  = ts->timeout;
+#endif
     int32_t delta = btstack_time_delta(list_timeout, now);
     if (delta < 0){
         delta = 0;
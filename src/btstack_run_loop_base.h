@@ -39,6 +39,9 @@
  *  btstack_run_loop_base.h
  *
  *  Portable implementation of timer and data source managment as base for platform specific implementations
+ *
+ *  Timers are kept in a sorted list by default. With ENABLE_RUN_LOOP_TIMER_HEAP, a pairing heap is used instead,
+ *  which makes adding and removing timers O(log n) for many active timers.
  */
 
 #ifndef BTSTACK_RUN_LOOP_BASE_H
@@ -89,6 +92,7 @@ void btstack_run_loop_base_dump_timer(void);
 
 /**
  * @brief Get time until first timer fires
+ * @note with ENABLE_RUN_LOOP_TIMER_SLACK, time until the earliest timeout + slack of all timers
  * @returns -1 if no timers, time until next timeout otherwise
  */
 int32_t btstack_run_loop_base_get_time_until_timeout(uint32_t now);
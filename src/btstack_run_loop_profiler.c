@@ -0,0 +1,205 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_run_loop_profiler.c"
+
+/*
+ *  btstack_run_loop_profiler.c
+ */
+
+#include "btstack_run_loop_profiler.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "btstack_debug.h"
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+
+static btstack_run_loop_profiler_handler_t * btstack_run_loop_profiler_storage;
+static uint16_t btstack_run_loop_profiler_storage_size;
+static uint16_t btstack_run_loop_profiler_num_handlers;
+static uint32_t btstack_run_loop_profiler_calls_dropped;
+static uint32_t (*btstack_run_loop_profiler_time_us)(void);
+
+static uint32_t btstack_run_loop_profiler_budget_us;
+static btstack_packet_handler_t btstack_run_loop_profiler_packet_handler;
+
+// time accounting, 32-bit timestamps are accumulated on each idle begin/end
+static uint32_t btstack_run_loop_profiler_last_us;
+static uint64_t btstack_run_loop_profiler_period_us;
+static uint64_t btstack_run_loop_profiler_idle_us;
+
+void btstack_run_loop_profiler_init(btstack_run_loop_profiler_handler_t * storage, uint16_t num_handlers, uint32_t (*get_time_us)(void)){
+    btstack_run_loop_profiler_storage      = storage;
+    btstack_run_loop_profiler_storage_size = num_handlers;
+    btstack_run_loop_profiler_time_us      = get_time_us;
+    btstack_run_loop_profiler_reset();
+}
+
+void btstack_run_loop_profiler_reset(void){
+    btstack_run_loop_profiler_num_handlers  = 0;
+    btstack_run_loop_profiler_calls_dropped = 0;
+    btstack_run_loop_profiler_period_us     = 0;
+    btstack_run_loop_profiler_idle_us       = 0;
+    btstack_run_loop_profiler_last_us       = btstack_run_loop_profiler_get_time_us();
+}
+
+void btstack_run_loop_profiler_set_budget(uint32_t budget_us){
+    btstack_run_loop_profiler_budget_us = budget_us;
+}
+
+void btstack_run_loop_profiler_register_packet_handler(btstack_packet_handler_t handler){
+    btstack_run_loop_profiler_packet_handler = handler;
+}
+
+uint32_t btstack_run_loop_profiler_get_time_us(void){
+    if (btstack_run_loop_profiler_time_us != NULL){
+        return (*btstack_run_loop_profiler_time_us)();
+    }
+    return btstack_run_loop_get_time_ms() * 1000u;
+}
+
+static uint16_t btstack_run_loop_profiler_get_index(btstack_run_loop_profiler_handler_type_t type, btstack_run_loop_profiler_function_t function){
+    uint16_t i;
+    for (i = 0; i < btstack_run_loop_profiler_num_handlers; i++){
+        btstack_run_loop_profiler_handler_t * handler = &btstack_run_loop_profiler_storage[i];
+        if ((handler->function == function) && (handler->type == (uint8_t) type)){
+            return i;
+        }
+    }
+    if (btstack_run_loop_profiler_num_handlers >= btstack_run_loop_profiler_storage_size){
+        return 0xffff;
+    }
+    btstack_run_loop_profiler_handler_t * handler = &btstack_run_loop_profiler_storage[btstack_run_loop_profiler_num_handlers];
+    (void) memset(handler, 0, sizeof(btstack_run_loop_profiler_handler_t));
+    handler->function = function;
+    handler->type     = (uint8_t) type;
+    return btstack_run_loop_profiler_num_handlers++;
+}
+
+static void btstack_run_loop_profiler_emit_budget_exceeded(btstack_run_loop_profiler_handler_type_t type, uint16_t index, uint32_t duration_us){
+    if (btstack_run_loop_profiler_packet_handler == NULL) return;
+    uint8_t event[13];
+    event[0] = BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED;
+    event[1] = sizeof(event) - 2u;
+    event[2] = (uint8_t) type;
+    little_endian_store_16(event, 3, index);
+    little_endian_store_32(event, 5, duration_us);
+    little_endian_store_32(event, 9, btstack_run_loop_profiler_budget_us);
+    (*btstack_run_loop_profiler_packet_handler)(HCI_EVENT_PACKET, 0, event, sizeof(event));
+}
+
+void btstack_run_loop_profiler_handler_complete(btstack_run_loop_profiler_handler_type_t type, btstack_run_loop_profiler_function_t function, uint32_t start_us){
+    uint32_t duration_us = btstack_run_loop_profiler_get_time_us() - start_us;
+
+    uint16_t index = btstack_run_loop_profiler_get_index(type, function);
+    if (index == 0xffffu){
+        btstack_run_loop_profiler_calls_dropped++;
+    } else {
+        btstack_run_loop_profiler_handler_t * handler = &btstack_run_loop_profiler_storage[index];
+        handler->count++;
+        handler->total_us += duration_us;
+        if (duration_us > handler->max_us){
+            handler->max_us = duration_us;
+        }
+        uint8_t bucket = 0;
+        uint32_t value = duration_us;
+        while ((value > 0u) && (bucket < (BTSTACK_RUN_LOOP_PROFILER_HISTOGRAM_NUM_BUCKETS - 1u))){
+            value >>= 1;
+            bucket++;
+        }
+        handler->buckets[bucket]++;
+    }
+
+    if ((btstack_run_loop_profiler_budget_us == 0u) || (duration_us <= btstack_run_loop_profiler_budget_us)) return;
+    if (index != 0xffffu){
+        btstack_run_loop_profiler_storage[index].budget_exceeded++;
+    }
+    log_error("run loop handler %p (type %u) took %u us, budget %u us",
+              (void *) (uintptr_t) function, (int) type, (unsigned int) duration_us, (unsigned int) btstack_run_loop_profiler_budget_us);
+    btstack_run_loop_profiler_emit_budget_exceeded(type, index, duration_us);
+}
+
+static uint32_t btstack_run_loop_profiler_update_period(void){
+    uint32_t now_us = btstack_run_loop_profiler_get_time_us();
+    uint32_t delta_us = now_us - btstack_run_loop_profiler_last_us;
+    btstack_run_loop_profiler_period_us += delta_us;
+    btstack_run_loop_profiler_last_us = now_us;
+    return delta_us;
+}
+
+void btstack_run_loop_profiler_idle_begin(void){
+    (void) btstack_run_loop_profiler_update_period();
+}
+
+void btstack_run_loop_profiler_idle_end(void){
+    btstack_run_loop_profiler_idle_us += btstack_run_loop_profiler_update_period();
+}
+
+void btstack_run_loop_profiler_get_stats(btstack_run_loop_profiler_stats_t * stats){
+    (void) btstack_run_loop_profiler_update_period();
+    stats->period_us     = btstack_run_loop_profiler_period_us;
+    stats->idle_us       = btstack_run_loop_profiler_idle_us;
+    stats->num_handlers  = btstack_run_loop_profiler_num_handlers;
+    stats->calls_dropped = btstack_run_loop_profiler_calls_dropped;
+    stats->utilization_permille = 0;
+    if (stats->period_us > 0u){
+        stats->utilization_permille = (uint16_t) (((stats->period_us - stats->idle_us) * 1000u) / stats->period_us);
+    }
+}
+
+const btstack_run_loop_profiler_handler_t * btstack_run_loop_profiler_get_handler(uint16_t index){
+    if (index >= btstack_run_loop_profiler_num_handlers) return NULL;
+    return &btstack_run_loop_profiler_storage[index];
+}
+
+void btstack_run_loop_profiler_dump(void){
+    btstack_run_loop_profiler_stats_t stats;
+    btstack_run_loop_profiler_get_stats(&stats);
+    log_info("run loop utilization %u.%u%% over %u ms, %u handlers, %u calls dropped",
+             stats.utilization_permille / 10u, stats.utilization_permille % 10u, (unsigned int) (stats.period_us / 1000u),
+             stats.num_handlers, (unsigned int) stats.calls_dropped);
+    uint16_t i;
+    for (i = 0; i < btstack_run_loop_profiler_num_handlers; i++){
+        const btstack_run_loop_profiler_handler_t * handler = &btstack_run_loop_profiler_storage[i];
+        log_info("handler %u: %p (type %u), count %u, total %u ms, avg %u us, max %u us, over budget %u", i,
+                 (void *) (uintptr_t) handler->function, handler->type, (unsigned int) handler->count,
+                 (unsigned int) (handler->total_us / 1000u), (unsigned int) (handler->total_us / handler->count),
+                 (unsigned int) handler->max_us, (unsigned int) handler->budget_exceeded);
+    }
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/*
+ *  btstack_run_loop_profiler.h
+ *
+ *  @Brief Optional run loop profiling, enabled by ENABLE_RUN_LOOP_PROFILER
+ *
+ *  The POSIX, epoll and embedded run loops measure the execution time of each data source, timer
+ *  and main thread callback. Measurements are kept per handler function in a table provided by the
+ *  application, together with a log2 histogram of the execution times. In addition, the time spent
+ *  waiting for events is measured to report the run loop utilization.
+ *
+ *  If a budget is set, handlers that take longer emit BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ *  to the registered packet handler.
+ *
+ *  Timestamps are provided by the function passed to btstack_run_loop_profiler_init, e.g.
+ *  clock_gettime(CLOCK_MONOTONIC) on POSIX or a cycle counter on embedded. Without it, the run loop
+ *  time in ms is used.
+ */
+
+#ifndef BTSTACK_RUN_LOOP_PROFILER_H
+#define BTSTACK_RUN_LOOP_PROFILER_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "btstack_config.h"
+#include "btstack_defines.h"
+
+// bucket 0: 0 us, bucket i: [2^(i-1), 2^i) us, last bucket: all larger values
+#define BTSTACK_RUN_LOOP_PROFILER_HISTOGRAM_NUM_BUCKETS 18
+
+typedef enum {
+    BTSTACK_RUN_LOOP_PROFILER_HANDLER_DATA_SOURCE = 0,
+    BTSTACK_RUN_LOOP_PROFILER_HANDLER_TIMER,
+    BTSTACK_RUN_LOOP_PROFILER_HANDLER_CALLBACK,
+} btstack_run_loop_profiler_handler_type_t;
+
+// handlers are identified by their function
+typedef void (*btstack_run_loop_profiler_function_t)(void);
+
+typedef struct {
+    btstack_run_loop_profiler_function_t function;
+    uint8_t  type;
+    uint32_t count;
+    uint64_t total_us;
+    uint32_t max_us;
+    uint32_t budget_exceeded;
+    uint32_t buckets[BTSTACK_RUN_LOOP_PROFILER_HISTOGRAM_NUM_BUCKETS];
+} btstack_run_loop_profiler_handler_t;
+
+typedef struct {
+    // time since init or last reset
+    uint64_t period_us;
+    // time spent waiting for events
+    uint64_t idle_us;
+    // (period - idle) / period
+    uint16_t utilization_permille;
+    uint16_t num_handlers;
+    // handler calls not recorded as table was full
+    uint32_t calls_dropped;
+} btstack_run_loop_profiler_stats_t;
+
+#ifdef ENABLE_RUN_LOOP_PROFILER
+#define BTSTACK_RUN_LOOP_PROFILER_BEGIN(start)                  uint32_t start = btstack_run_loop_profiler_get_time_us()
+#define BTSTACK_RUN_LOOP_PROFILER_END(start, type, function)    btstack_run_loop_profiler_handler_complete(type, (btstack_run_loop_profiler_function_t) (function), start)
+#define BTSTACK_RUN_LOOP_PROFILER_IDLE_BEGIN()                  btstack_run_loop_profiler_idle_begin()
+#define BTSTACK_RUN_LOOP_PROFILER_IDLE_END()                    btstack_run_loop_profiler_idle_end()
+#else
+#define BTSTACK_RUN_LOOP_PROFILER_BEGIN(start)                  (void)(0)
+#define BTSTACK_RUN_LOOP_PROFILER_END(start, type, function)    (void)(0)
+#define BTSTACK_RUN_LOOP_PROFILER_IDLE_BEGIN()                  (void)(0)
+#define BTSTACK_RUN_LOOP_PROFILER_IDLE_END()                    (void)(0)
+#endif
+
+/* API_START */
+
+/**
+ * @brief Init run loop profiler
+ * @param storage for per handler measurements
+ * @param num_handlers in storage
+ * @param get_time_us returns monotonic time in us, or NULL to use run loop time
+ */
+void btstack_run_loop_profiler_init(btstack_run_loop_profiler_handler_t * storage, uint16_t num_handlers, uint32_t (*get_time_us)(void));
+
+/**
+ * @brief Clear all measurements and start new period
+ */
+void btstack_run_loop_profiler_reset(void);
+
+/**
+ * @brief Set execution time budget for a single handler call
+ * @param budget_us or 0 to disable
+ */
+void btstack_run_loop_profiler_set_budget(uint32_t budget_us);
+
+/**
+ * @brief Register packet handler for BTSTACK_EVENT_RUN_LOOP_HANDLER_BUDGET_EXCEEDED
+ * @param handler
+ */
+void btstack_run_loop_profiler_register_packet_handler(btstack_packet_handler_t handler);
+
+/**
+ * @brief Get current time used for measurements
+ * @return time in us
+ */
+uint32_t btstack_run_loop_profiler_get_time_us(void);
+
+/**
+ * @brief Record handler call, called by run loop
+ * @param type
+ * @param function of handler
+ * @param start_us as returned by btstack_run_loop_profiler_get_time_us
+ */
+void btstack_run_loop_profiler_handler_complete(btstack_run_loop_profiler_handler_type_t type, btstack_run_loop_profiler_function_t function, uint32_t start_us);
+
+/**
+ * @brief Run loop starts waiting for events, called by run loop
+ */
+void btstack_run_loop_profiler_idle_begin(void);
+
+/**
+ * @brief Run loop stops waiting for events, called by run loop
+ */
+void btstack_run_loop_profiler_idle_end(void);
+
+/**
+ * @brief Get run loop utilization
+ * @param stats
+ */
+void btstack_run_loop_profiler_get_stats(btstack_run_loop_profiler_stats_t * stats);
+
+/**
+ * @brief Get measurements for handler
+ * @param index < num_handlers from btstack_run_loop_profiler_get_stats
+ * @return handler or NULL if index invalid
+ */
+const btstack_run_loop_profiler_handler_t * btstack_run_loop_profiler_get_handler(uint16_t index);
+
+/**
+ * @brief Log utilization and measurements for all handlers
+ */
+void btstack_run_loop_profiler_dump(void);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // BTSTACK_RUN_LOOP_PROFILER_H
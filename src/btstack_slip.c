@@ -44,6 +44,7 @@
 
 #include "btstack_slip.h"
 #include "btstack_debug.h"
+#include "btstack_util.h"
 
 typedef enum {
 	SLIP_ENCODER_DEFAULT,
@@ -128,6 +129,34 @@ uint8_t btstack_slip_encoder_get_byte(void){
 	}
 }
 
+/**
+ * @brief Get encoded bytes
+ * @param buffer to store encoded bytes
+ * @param max_len of buffer
+ * @return number of bytes stored
+ */
+uint16_t btstack_slip_encoder_get_bytes(uint8_t * buffer, uint16_t max_len){
+	uint16_t pos = 0;
+	while (pos < max_len){
+		if (encoder_state == SLIP_ENCODER_DEFAULT){
+			// fast path: copy bytes that don't need to be escaped
+			const uint8_t * data = encoder_data;
+			uint16_t len = (uint16_t) btstack_min(encoder_len, max_len - pos);
+			uint16_t i;
+			for (i = 0; i < len; i++){
+				uint8_t next_byte = data[i];
+				if ((next_byte == BTSTACK_SLIP_SOF) || (next_byte == 0xdbu)) break;
+				buffer[pos++] = next_byte;
+			}
+			encoder_data += i;
+			encoder_len  -= i;
+			if ((encoder_len == 0u) || (pos == max_len)) break;
+		}
+		buffer[pos++] = btstack_slip_encoder_get_byte();
+	}
+	return pos;
+}
+
 // Decoder
 
 static void btstack_slip_decoder_reset(void){
@@ -221,6 +250,30 @@ void btstack_slip_decoder_process(uint8_t input){
     }
 }
 
+/**
+ * @brief Process received bytes until frame is complete
+ * @param data
+ * @param len
+ * @return number of bytes processed
+ */
+uint16_t btstack_slip_decoder_process_block(const uint8_t * data, uint16_t len){
+	uint16_t pos = 0;
+	while ((pos < len) && (decoder_state != SLIP_DECODER_COMPLETE)){
+		if (decoder_state == SLIP_DECODER_ACTIVE){
+			// fast path: copy bytes that are neither SOF nor escaped
+			while ((pos < len) && (decoder_pos < decoder_max_size)){
+				uint8_t input = data[pos];
+				if ((input == BTSTACK_SLIP_SOF) || (input == 0xdbu)) break;
+				decoder_buffer[decoder_pos++] = input;
+				pos++;
+			}
+			if (pos == len) break;
+		}
+		btstack_slip_decoder_process(data[pos++]);
+	}
+	return pos;
+}
+
 /**
  * @brief Get size of decoded frame
  * @return size of frame. Size = 0 => frame not complete
@@ -72,6 +72,14 @@ int  btstack_slip_encoder_has_data(void);
  */
 uint8_t btstack_slip_encoder_get_byte(void);
 
+/**
+ * @brief Get encoded bytes, escape sequence might be split across calls
+ * @param buffer to store encoded bytes
+ * @param max_len of buffer
+ * @return number of bytes stored. Less than max_len if encoder has no more data
+ */
+uint16_t btstack_slip_encoder_get_bytes(uint8_t * buffer, uint16_t max_len);
+
 // DECODER
 
 /**
@@ -88,6 +96,14 @@ void btstack_slip_decoder_init(uint8_t * buffer, uint16_t max_size);
 
 void btstack_slip_decoder_process(uint8_t input);
 
+/**
+ * @brief Process received bytes until frame is complete
+ * @param data
+ * @param len
+ * @return number of bytes processed. If frame is complete, remaining bytes have to be processed after re-init
+ */
+uint16_t btstack_slip_decoder_process_block(const uint8_t * data, uint16_t len);
+
 /**
  * @brief Get size of decoded frame
  * @return size of frame. Size = 0 => frame not complete
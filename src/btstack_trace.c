@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+#define BTSTACK_FILE__ "btstack_trace.c"
+
+/*
+ *  btstack_trace.c
+ */
+
+#include "btstack_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bluetooth.h"
+#include "btstack_run_loop.h"
+#include "btstack_util.h"
+
+typedef struct {
+    const char * name;
+    const char * category;
+} btstack_tracepoint_info_t;
+
+static const btstack_tracepoint_info_t btstack_tracepoint_info[BTSTACK_TRACEPOINT_NUM] = {
+    { "Transport RX",      "transport" },
+    { "HCI Dispatch",      "hci"       },
+    { "L2CAP Deliver",     "l2cap"     },
+    { "ATT Request",       "att"       },
+    { "ATT Response Sent", "att"       },
+};
+
+static btstack_trace_event_t * btstack_trace_storage;
+static uint16_t btstack_trace_storage_size;
+static uint16_t btstack_trace_write_index;
+static uint16_t btstack_trace_num_events;
+static uint32_t btstack_trace_num_events_overwritten;
+static uint32_t (*btstack_trace_time_us)(void);
+
+void btstack_trace_init(btstack_trace_event_t * storage, uint16_t num_events, uint32_t (*get_time_us)(void)){
+    btstack_trace_storage      = storage;
+    btstack_trace_storage_size = num_events;
+    btstack_trace_time_us      = get_time_us;
+    btstack_trace_reset();
+}
+
+void btstack_trace_reset(void){
+    btstack_trace_write_index = 0;
+    btstack_trace_num_events  = 0;
+    btstack_trace_num_events_overwritten = 0;
+}
+
+uint32_t btstack_trace_get_time_us(void){
+    if (btstack_trace_time_us != NULL){
+        return (*btstack_trace_time_us)();
+    }
+    return btstack_run_loop_get_time_ms() * 1000u;
+}
+
+static void btstack_trace_store(btstack_tracepoint_t tracepoint, btstack_trace_phase_t phase, uint16_t con_handle, uint16_t cid, uint32_t timestamp_us, uint32_t duration_us){
+    if (btstack_trace_storage_size == 0u) return;
+    btstack_trace_event_t * event = &btstack_trace_storage[btstack_trace_write_index];
+    event->timestamp_us = timestamp_us;
+    event->duration_us  = duration_us;
+    event->con_handle   = con_handle;
+    event->cid          = cid;
+    event->tracepoint   = (uint8_t) tracepoint;
+    event->phase        = (uint8_t) phase;
+    btstack_trace_write_index++;
+    if (btstack_trace_write_index == btstack_trace_storage_size){
+        btstack_trace_write_index = 0;
+    }
+    if (btstack_trace_num_events < btstack_trace_storage_size){
+        btstack_trace_num_events++;
+    } else {
+        btstack_trace_num_events_overwritten++;
+    }
+}
+
+void btstack_trace_complete(btstack_tracepoint_t tracepoint, uint16_t con_handle, uint16_t cid, uint32_t start_us){
+    uint32_t duration_us = btstack_trace_get_time_us() - start_us;
+    btstack_trace_store(tracepoint, BTSTACK_TRACE_PHASE_COMPLETE, con_handle, cid, start_us, duration_us);
+}
+
+void btstack_trace_complete_for_packet(btstack_tracepoint_t tracepoint, uint8_t packet_type, const uint8_t * packet, uint16_t size, uint32_t start_us){
+    uint16_t con_handle = HCI_CON_HANDLE_INVALID;
+    switch (packet_type){
+        case HCI_ACL_DATA_PACKET:
+        case HCI_SCO_DATA_PACKET:
+            if (size >= 2u){
+                con_handle = little_endian_read_16(packet, 0) & 0x0fffu;
+            }
+            break;
+        default:
+            break;
+    }
+    btstack_trace_complete(tracepoint, con_handle, 0, start_us);
+}
+
+void btstack_trace_instant(btstack_tracepoint_t tracepoint, uint16_t con_handle, uint16_t cid){
+    btstack_trace_store(tracepoint, BTSTACK_TRACE_PHASE_INSTANT, con_handle, cid, btstack_trace_get_time_us(), 0);
+}
+
+uint16_t btstack_trace_get_num_events(void){
+    return btstack_trace_num_events;
+}
+
+uint32_t btstack_trace_get_num_events_overwritten(void){
+    return btstack_trace_num_events_overwritten;
+}
+
+static void btstack_trace_write_string(btstack_trace_write_t write, void * context, const char * string){
+    (*write)(context, string, (uint16_t) strlen(string));
+}
+
+static int btstack_trace_format_event(char * buffer, uint16_t buffer_size, const btstack_trace_event_t * event){
+    const btstack_tracepoint_info_t * info = &btstack_tracepoint_info[event->tracepoint];
+    int pos;
+    if (event->phase == (uint8_t) BTSTACK_TRACE_PHASE_INSTANT){
+        pos = snprintf(buffer, buffer_size, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%lu,\"pid\":1,\"tid\":1,\"args\":{",
+                       info->name, info->category, (unsigned long) event->timestamp_us);
+    } else {
+        pos = snprintf(buffer, buffer_size, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":1,\"args\":{",
+                       info->name, info->category, (unsigned long) event->timestamp_us, (unsigned long) event->duration_us);
+    }
+    const char * separator = "";
+    if (event->con_handle != HCI_CON_HANDLE_INVALID){
+        pos += snprintf(&buffer[pos], buffer_size - pos, "\"con_handle\":%u", event->con_handle);
+        separator = ",";
+    }
+    if (event->cid != 0u){
+        pos += snprintf(&buffer[pos], buffer_size - pos, "%s\"cid\":%u", separator, event->cid);
+    }
+    pos += snprintf(&buffer[pos], buffer_size - pos, "}}");
+    return pos;
+}
+
+void btstack_trace_export_chrome_json(btstack_trace_write_t write, void * context){
+    char buffer[200];
+    btstack_trace_write_string(write, context, "{\"traceEvents\":[\n");
+    uint16_t read_index = btstack_trace_write_index;
+    if (btstack_trace_num_events < btstack_trace_storage_size){
+        read_index = 0;
+    }
+    uint16_t i;
+    for (i = 0; i < btstack_trace_num_events; i++){
+        int len = btstack_trace_format_event(buffer, sizeof(buffer), &btstack_trace_storage[read_index]);
+        (*write)(context, buffer, (uint16_t) len);
+        if (i < (btstack_trace_num_events - 1u)){
+            btstack_trace_write_string(write, context, ",\n");
+        }
+        read_index++;
+        if (read_index == btstack_trace_storage_size){
+            read_index = 0;
+        }
+    }
+    (void) snprintf(buffer, sizeof(buffer), "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"events_overwritten\":%lu}}\n",
+                    (unsigned long) btstack_trace_num_events_overwritten);
+    btstack_trace_write_string(write, context, buffer);
+}
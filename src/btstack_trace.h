@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/*
+ *  btstack_trace.h
+ *
+ *  @Brief Optional latency tracepoints, enabled by ENABLE_BTSTACK_TRACE
+ *
+ *  Tracepoints in the HCI Transport (H4, libusb), HCI, L2CAP and ATT Server record a timestamp
+ *  together with the connection handle and channel id into a ring buffer provided by the application.
+ *  When the buffer is full, the oldest events are overwritten. The recorded events can be exported
+ *  as Chrome trace_event JSON and viewed with chrome://tracing or https://ui.perfetto.dev.
+ *
+ *  Timestamps are provided by the function passed to btstack_trace_init, e.g. clock_gettime(CLOCK_MONOTONIC)
+ *  on POSIX. Without it, the run loop time in ms is used.
+ */
+
+#ifndef BTSTACK_TRACE_H
+#define BTSTACK_TRACE_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "btstack_config.h"
+
+typedef enum {
+    // packet received by HCI Transport and forwarded to HCI
+    BTSTACK_TRACEPOINT_TRANSPORT_RX = 0,
+    // packet processed by HCI
+    BTSTACK_TRACEPOINT_HCI_DISPATCH,
+    // data delivered to L2CAP channel or fixed channel
+    BTSTACK_TRACEPOINT_L2CAP_DELIVER,
+    // ATT request handled by ATT DB
+    BTSTACK_TRACEPOINT_ATT_REQUEST,
+    // ATT response sent (instant)
+    BTSTACK_TRACEPOINT_ATT_RESPONSE_SENT,
+    BTSTACK_TRACEPOINT_NUM
+} btstack_tracepoint_t;
+
+typedef enum {
+    BTSTACK_TRACE_PHASE_COMPLETE = 0,
+    BTSTACK_TRACE_PHASE_INSTANT
+} btstack_trace_phase_t;
+
+typedef struct {
+    uint32_t timestamp_us;
+    uint32_t duration_us;
+    // HCI_CON_HANDLE_INVALID if not known
+    uint16_t con_handle;
+    // 0 if not known
+    uint16_t cid;
+    uint8_t  tracepoint;
+    uint8_t  phase;
+} btstack_trace_event_t;
+
+/**
+ * @brief Write function used by btstack_trace_export_chrome_json
+ * @param context
+ * @param data
+ * @param size
+ */
+typedef void (*btstack_trace_write_t)(void * context, const char * data, uint16_t size);
+
+#ifdef ENABLE_BTSTACK_TRACE
+#define BTSTACK_TRACE_BEGIN(start)                                  uint32_t start = btstack_trace_get_time_us()
+#define BTSTACK_TRACE_END(start, tracepoint, con_handle, cid)       btstack_trace_complete(tracepoint, con_handle, cid, start)
+#define BTSTACK_TRACE_PACKET_END(start, tracepoint, packet_type, packet, size) btstack_trace_complete_for_packet(tracepoint, packet_type, packet, size, start)
+#define BTSTACK_TRACE_INSTANT(tracepoint, con_handle, cid)          btstack_trace_instant(tracepoint, con_handle, cid)
+#else
+#define BTSTACK_TRACE_BEGIN(start)                                  (void)(0)
+#define BTSTACK_TRACE_END(start, tracepoint, con_handle, cid)       (void)(0)
+#define BTSTACK_TRACE_PACKET_END(start, tracepoint, packet_type, packet, size) (void)(0)
+#define BTSTACK_TRACE_INSTANT(tracepoint, con_handle, cid)          (void)(0)
+#endif
+
+/* API_START */
+
+/**
+ * @brief Init trace buffer
+ * @param storage for events
+ * @param num_events in storage
+ * @param get_time_us returns monotonic time in us, or NULL to use run loop time
+ */
+void btstack_trace_init(btstack_trace_event_t * storage, uint16_t num_events, uint32_t (*get_time_us)(void));
+
+/**
+ * @brief Discard all recorded events
+ */
+void btstack_trace_reset(void);
+
+/**
+ * @brief Get current time used for timestamps
+ * @return time in us
+ */
+uint32_t btstack_trace_get_time_us(void);
+
+/**
+ * @brief Record event with duration
+ * @param tracepoint
+ * @param con_handle or HCI_CON_HANDLE_INVALID
+ * @param cid or 0
+ * @param start_us as returned by btstack_trace_get_time_us
+ */
+void btstack_trace_complete(btstack_tracepoint_t tracepoint, uint16_t con_handle, uint16_t cid, uint32_t start_us);
+
+/**
+ * @brief Record event with duration for HCI packet, con handle is taken from ACL and SCO packets
+ * @param tracepoint
+ * @param packet_type
+ * @param packet
+ * @param size
+ * @param start_us as returned by btstack_trace_get_time_us
+ */
+void btstack_trace_complete_for_packet(btstack_tracepoint_t tracepoint, uint8_t packet_type, const uint8_t * packet, uint16_t size, uint32_t start_us);
+
+/**
+ * @brief Record instant event
+ * @param tracepoint
+ * @param con_handle or HCI_CON_HANDLE_INVALID
+ * @param cid or 0
+ */
+void btstack_trace_instant(btstack_tracepoint_t tracepoint, uint16_t con_handle, uint16_t cid);
+
+/**
+ * @brief Get number of recorded events
+ * @return num events
+ */
+uint16_t btstack_trace_get_num_events(void);
+
+/**
+ * @brief Get number of events overwritten since init or reset
+ * @return num events
+ */
+uint32_t btstack_trace_get_num_events_overwritten(void);
+
+/**
+ * @brief Export recorded events as Chrome trace_event JSON, oldest first
+ * @param write function
+ * @param context passed to write function
+ */
+void btstack_trace_export_chrome_json(btstack_trace_write_t write, void * context);
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // BTSTACK_TRACE_H
@@ -143,6 +143,18 @@ typedef struct {
      */
     void (*set_wakeup_handler)(void (*wakeup_handler)(void));
 
+    // support for reading all available bytes, optional - NULL if not supported
+
+    /**
+     * set callback for bytes received. NULL disables callback
+     */
+    void (*set_bytes_received)(void (*bytes_handler)(uint16_t num_bytes));
+
+    /**
+     * receive bytes - bytes received callback is called as soon as at least one and up to max_len bytes have been read
+     */
+    void (*receive_bytes)(uint8_t *buffer, uint16_t max_len);
+
 } btstack_uart_block_t;
 
 // common implementations
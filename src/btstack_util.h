@@ -288,6 +288,32 @@ int count_set_bits_uint32(uint32_t x);
 uint8_t btstack_crc8_check(uint8_t *data, uint16_t len, uint8_t check_sum);
 uint8_t btstack_crc8_calc(uint8_t *data, uint16_t len);
 
+/**
+ * @brief Update CRC16-CCITT (reflected, polynomial 0x8408) with data, e.g. used by H5 data integrity check
+ * @note ENABLE_CRC16_CCITT_SLICE_BY_4 processes 4 bytes per step using 2 kB of tables
+ * @param crc initial value or result of previous call
+ * @param data
+ * @param len
+ * @return crc
+ */
+uint16_t btstack_crc16_ccitt_update(uint16_t crc, const uint8_t * data, uint16_t len);
+
+/**
+ * @brief Init event mask for packet callback registration with list of event codes
+ * @param event_mask of BTSTACK_EVENT_MASK_SIZE bytes
+ * @param event_codes
+ * @param num_event_codes
+ */
+void btstack_event_mask_init(uint8_t * event_mask, const uint8_t * event_codes, uint16_t num_event_codes);
+
+/**
+ * @brief Check if event code is set in event mask
+ * @param event_mask
+ * @param event_code
+ * @return true if set
+ */
+bool btstack_event_mask_contains(const uint8_t * event_mask, uint8_t event_code);
+
 /* API_END */
 
 #if defined __cplusplus
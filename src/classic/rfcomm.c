@@ -48,6 +48,7 @@
 #include "btstack_debug.h"
 #include "btstack_event.h"
 #include "btstack_memory.h"
+#include "btstack_metrics.h"
 #include "btstack_util.h"
 #include "classic/core.h"
 #include "classic/rfcomm.h"
@@ -1455,6 +1456,9 @@ static void rfcomm_channel_packet_handler_uih(rfcomm_multiplexer_t *multiplexer,
             channel->credits_incoming--;
         }
         
+        BTSTACK_METRICS_INC(rfcomm_rx_packets);
+        BTSTACK_METRICS_ADD(rfcomm_rx_bytes, size - payload_offset - 1);
+
         // deliver payload
         (channel->packet_handler)(RFCOMM_DATA_PACKET, channel->rfcomm_cid,
                               &packet[payload_offset], size-payload_offset-1);
@@ -2312,6 +2316,12 @@ int rfcomm_send_prepared(uint16_t rfcomm_cid, uint16_t len){
         log_error("rfcomm_send_prepared: error %d", result);
         return result;
     }
+
+    BTSTACK_METRICS_INC(rfcomm_tx_packets);
+    BTSTACK_METRICS_ADD(rfcomm_tx_bytes, len);
+    if (len && (channel->credits_outgoing == 0u)){
+        BTSTACK_METRICS_INC(rfcomm_credit_stalls);
+    }
     
     return result;
 }
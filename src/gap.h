@@ -104,6 +104,43 @@ typedef enum {
     GAP_RANDOM_ADDRESS_RESOLVABLE,
 } gap_random_address_type_t;
 
+// LE Extended Advertising Parameters, see HCI LE Set Extended Advertising Parameters Command
+typedef struct {
+    uint16_t  advertising_event_properties;
+    uint32_t  primary_advertising_interval_min;
+    uint32_t  primary_advertising_interval_max;
+    uint8_t   primary_advertising_channel_map;
+    uint8_t   own_address_type;
+    uint8_t   peer_address_type;
+    bd_addr_t peer_address;
+    uint8_t   advertising_filter_policy;
+    int8_t    advertising_tx_power;
+    uint8_t   primary_advertising_phy;
+    uint8_t   secondary_advertising_max_skip;
+    uint8_t   secondary_advertising_phy;
+    uint8_t   advertising_sid;
+    uint8_t   scan_request_notification_enable;
+} le_extended_advertising_parameters_t;
+
+// LE Advertising Set, storage provided by application
+typedef struct {
+    btstack_linked_item_t item;
+    uint8_t   advertising_handle;
+    uint8_t   tasks;
+    bool      enabled;
+    bool      active;
+    le_extended_advertising_parameters_t params;
+    bd_addr_t random_address;
+    const uint8_t * adv_data;
+    uint16_t  adv_data_len;
+    uint16_t  adv_data_pos;
+    const uint8_t * scan_data;
+    uint16_t  scan_data_len;
+    uint16_t  scan_data_pos;
+    uint16_t  enable_timeout;
+    uint8_t   enable_max_events;
+} le_advertising_set_t;
+
 // Authorization state
 typedef enum {
     AUTHORIZATION_UNKNOWN,
@@ -299,6 +336,33 @@ void gap_set_scan_params(uint8_t scan_type, uint16_t scan_interval, uint16_t sca
  */
 void gap_set_scan_parameters(uint8_t scan_type, uint16_t scan_interval, uint16_t scan_window);
 
+/**
+ * @brief Set PHYs used for LE Extended Scanning. Requires ENABLE_LE_EXTENDED_ADVERTISING
+ * @param scan_phys bitmask: 0x01 = LE 1M, 0x04 = LE Coded
+ */
+void gap_set_scan_phys(uint8_t scan_phys);
+
+/**
+ * @brief Set PHYs used to initiate LE connections. Requires ENABLE_LE_EXTENDED_ADVERTISING
+ * @param initiating_phys bitmask: 0x01 = LE 1M, 0x02 = LE 2M, 0x04 = LE Coded
+ */
+void gap_set_connection_phys(uint8_t initiating_phys);
+
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+/**
+ * @brief Set time window for advertising report filter. Reports with unchanged address, event type and data
+ *        are only delivered once per time window. Requires ENABLE_LE_ADVERTISING_REPORT_FILTER
+ * @param timeout_ms, 0 disables filter
+ */
+void gap_set_advertising_report_filter_timeout(uint32_t timeout_ms);
+
+/**
+ * @brief Get number of advertising reports dropped by advertising report filter
+ * @return num reports filtered
+ */
+uint32_t gap_get_advertising_reports_filtered(void);
+#endif
+
 /**
  * @brief Start LE Scan 
  */
@@ -374,6 +438,79 @@ void gap_advertisements_enable(int enabled);
  */
 void gap_scan_response_set_data(uint8_t scan_response_data_length, uint8_t * scan_response_data);
 
+/**
+ * @brief Setup LE Extended Advertising Set. Requires ENABLE_LE_EXTENDED_ADVERTISING
+ * @note Advertising sets are only used if the Controller supports LE Extended Advertising
+ * @note One of the advertising sets supported by the Controller is used for legacy advertising
+ * @param storage for advertising set, has to stay valid until its removal has been confirmed, see gap_extended_advertising_remove
+ * @param advertising_parameters
+ * @param out_advertising_handle
+ * @return status, ERROR_CODE_MEMORY_CAPACITY_EXCEEDED if Controller does not support more advertising sets
+ */
+uint8_t gap_extended_advertising_setup(le_advertising_set_t * storage, const le_extended_advertising_parameters_t * advertising_parameters, uint8_t * out_advertising_handle);
+
+/**
+ * @brief Set Extended Advertising Parameters for advertising set
+ * @param advertising_handle
+ * @param advertising_parameters
+ * @return status
+ */
+uint8_t gap_extended_advertising_set_params(uint8_t advertising_handle, const le_extended_advertising_parameters_t * advertising_parameters);
+
+/**
+ * @brief Set random address for advertising set
+ * @param advertising_handle
+ * @param random_address
+ * @return status
+ */
+uint8_t gap_extended_advertising_set_random_address(uint8_t advertising_handle, const bd_addr_t random_address);
+
+/**
+ * @brief Set Advertising Data for advertising set
+ * @param advertising_handle
+ * @param advertising_data_length
+ * @param advertising_data
+ * @note data is not copied, pointer has to stay valid. Data larger than a single HCI Command is sent in fragments
+ * @return status
+ */
+uint8_t gap_extended_advertising_set_adv_data(uint8_t advertising_handle, uint16_t advertising_data_length, const uint8_t * advertising_data);
+
+/**
+ * @brief Set Scan Response Data for advertising set
+ * @param advertising_handle
+ * @param scan_response_data_length
+ * @param scan_response_data
+ * @note data is not copied, pointer has to stay valid. Data larger than a single HCI Command is sent in fragments
+ * @return status
+ */
+uint8_t gap_extended_advertising_set_scan_response_data(uint8_t advertising_handle, uint16_t scan_response_data_length, const uint8_t * scan_response_data);
+
+/**
+ * @brief Start advertising set
+ * @param advertising_handle
+ * @param timeout in 10ms, or 0 == no timeout
+ * @param num_extended_advertising_events max number of extended advertising events, or 0 == no limit
+ * @note HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED is emitted if advertising stops on timeout, max events, or connection
+ * @return status
+ */
+uint8_t gap_extended_advertising_start(uint8_t advertising_handle, uint16_t timeout, uint8_t num_extended_advertising_events);
+
+/**
+ * @brief Stop advertising set
+ * @param advertising_handle
+ * @return status
+ */
+uint8_t gap_extended_advertising_stop(uint8_t advertising_handle);
+
+/**
+ * @brief Remove advertising set from Controller
+ * @note Removal is queued: advertising is stopped first, then the set is removed with HCI_LE_Remove_Advertising_Set.
+ *       Storage can be reused after HCI_EVENT_COMMAND_COMPLETE for HCI_OPCODE_HCI_LE_REMOVE_ADVERTISING_SET
+ * @param advertising_handle
+ * @return status
+ */
+uint8_t gap_extended_advertising_remove(uint8_t advertising_handle);
+
 /**
  * @brief Set connection parameters for outgoing connections
  * @param conn_scan_interval (unit: 0.625 msec), default: 60 ms
@@ -70,11 +70,13 @@
 #include "btstack_event.h"
 #include "btstack_linked_list.h"
 #include "btstack_memory.h"
+#include "btstack_trace.h"
 #include "bluetooth_company_id.h"
 #include "bluetooth_data_types.h"
 #include "gap.h"
 #include "hci.h"
 #include "hci_cmd.h"
+#include "hci_cmd_serializer.h"
 #include "hci_dump.h"
 #include "ad_parser.h"
 
@@ -91,6 +93,16 @@
 #ifndef HCI_HOST_SCO_PACKET_LEN
 #error "ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL requires to define HCI_HOST_SCO_PACKET_LEN"
 #endif
+// batching of Host Number Of Completed Packets, see hci_set_host_num_completed_packets_policy
+#ifndef HCI_HOST_NUM_COMPLETED_PACKETS_THRESHOLD
+#define HCI_HOST_NUM_COMPLETED_PACKETS_THRESHOLD ((HCI_HOST_ACL_PACKET_NUM + 1) / 2)
+#endif
+#ifndef HCI_HOST_NUM_COMPLETED_BYTES_THRESHOLD
+#define HCI_HOST_NUM_COMPLETED_BYTES_THRESHOLD ((HCI_HOST_ACL_PACKET_NUM * HCI_HOST_ACL_PACKET_LEN + 1) / 2)
+#endif
+#ifndef HCI_HOST_NUM_COMPLETED_PACKETS_MAX_DELAY_MS
+#define HCI_HOST_NUM_COMPLETED_PACKETS_MAX_DELAY_MS 10
+#endif
 #endif
 
 #define HCI_CONNECTION_TIMEOUT_MS 10000
@@ -155,8 +167,16 @@ static void hci_emit_dedicated_bonding_result(bd_addr_t address, uint8_t status)
 static void hci_emit_event(uint8_t * event, uint16_t size, int dump);
 static void hci_emit_acl_packet(uint8_t * packet, uint16_t size);
 static void hci_run(void);
+static uint8_t * hci_cmd_packet_buffer(void);
 static int  hci_is_le_connection(hci_connection_t * connection);
 static int  hci_number_free_acl_slots_for_connection_type( bd_addr_type_t address_type);
+static void hci_connection_packets_completed(hci_connection_t * conn, uint16_t num_packets);
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+static void hci_acl_tx_queue_drop(hci_connection_t * connection);
+#endif
+#ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+static void hci_host_num_completed_packets_add(hci_connection_t * conn, uint16_t size, bool flush);
+#endif
 
 #ifdef ENABLE_CLASSIC
 static int hci_have_usb_transport(void);
@@ -169,6 +189,20 @@ void le_handle_advertisement_report(uint8_t *packet, uint16_t size);
 static uint8_t hci_whitelist_remove(bd_addr_type_t address_type, const bd_addr_t address);
 static hci_connection_t * gap_get_outgoing_connection(void);
 #endif
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+static bool hci_le_extended_advertising_supported(void);
+#endif
+#ifdef ENABLE_LE_CENTRAL
+static int hci_le_send_scan_parameters(void);
+#endif
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+static void hci_le_handle_advertising_set_terminated(uint8_t advertising_handle);
+#endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+static void hci_emit_le_throughput_policy_complete(hci_connection_t * conn);
+static void hci_le_throughput_policy_task_done(hci_connection_t * conn, uint8_t w4_task);
+static void hci_le_throughput_policy_timeout_handler(btstack_timer_source_t * timer);
+#endif
 #endif
 
 // the STACK is here
@@ -185,6 +219,46 @@ static const char * default_classic_name = "BTstack 00:00:00:00:00:00";
 static uint8_t disable_l2cap_timeouts = 0;
 #endif
 
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+static hci_connection_lookup_slot_t * hci_connection_lookup_slot_for_handle(hci_con_handle_t con_handle){
+    // controllers assign handles sequentially, which distributes well
+    return &hci_stack->connections_by_handle[con_handle % HCI_CONNECTION_LOOKUP_TABLE_SIZE];
+}
+
+static hci_connection_lookup_slot_t * hci_connection_lookup_slot_for_address(const bd_addr_t addr, bd_addr_type_t addr_type){
+    uint32_t hash = (uint32_t) addr_type;
+    int i;
+    for (i = 0; i < BD_ADDR_LEN; i++){
+        hash = (hash * 31u) + addr[i];
+    }
+    return &hci_stack->connections_by_address[hash % HCI_CONNECTION_LOOKUP_TABLE_SIZE];
+}
+
+static void hci_connection_lookup_slot_add(hci_connection_lookup_slot_t * slot, hci_connection_t * conn){
+    if (slot->connection == NULL){
+        slot->connection = conn;
+    } else {
+        slot->num_overflow++;
+    }
+}
+
+static void hci_connection_lookup_slot_remove(hci_connection_lookup_slot_t * slot, hci_connection_t * conn){
+    if (slot->connection == conn){
+        slot->connection = NULL;
+    } else if (slot->num_overflow > 0){
+        slot->num_overflow--;
+    }
+}
+
+// connection found via list was counted as overflow, move it into free slot
+static void hci_connection_lookup_slot_promote(hci_connection_lookup_slot_t * slot, hci_connection_t * conn){
+    if (slot->connection != NULL) return;
+    if (slot->num_overflow == 0) return;
+    slot->connection = conn;
+    slot->num_overflow--;
+}
+#endif
+
 /**
  * create connection for given address
  *
@@ -217,11 +291,58 @@ static hci_connection_t * create_connection_for_bd_addr_and_type(const bd_addr_t
 #endif
 #ifdef ENABLE_LE_LIMIT_ACL_FRAGMENT_BY_MAX_OCTETS
     conn->le_max_tx_octets = 27;
+#endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+    conn->le_throughput_policy_tasks = 0;
+    btstack_run_loop_set_timer_handler(&conn->le_throughput_policy_timer, hci_le_throughput_policy_timeout_handler);
+    btstack_run_loop_set_timer_context(&conn->le_throughput_policy_timer, conn);
+    conn->le_tx_phy = 1;
+    conn->le_rx_phy = 1;
+    conn->le_tx_octets = 27;
+    conn->le_rx_octets = 27;
 #endif
     btstack_linked_list_add(&hci_stack->connections, (btstack_linked_item_t *) conn);
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    hci_connection_lookup_slot_add(hci_connection_lookup_slot_for_address(addr, addr_type), conn);
+#endif
     return conn;
 }
 
+/**
+ * set con handle for connection and update lookup table
+ */
+static void hci_connection_set_handle(hci_connection_t * conn, hci_con_handle_t con_handle){
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    if (conn->con_handle != HCI_CON_HANDLE_INVALID){
+        hci_connection_lookup_slot_remove(hci_connection_lookup_slot_for_handle(conn->con_handle), conn);
+    }
+    if (con_handle != HCI_CON_HANDLE_INVALID){
+        hci_connection_lookup_slot_add(hci_connection_lookup_slot_for_handle(con_handle), conn);
+    }
+#endif
+    conn->con_handle = con_handle;
+}
+
+/**
+ * remove connection from list and lookup table, and free it
+ */
+static void hci_connection_free(hci_connection_t * conn){
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    hci_connection_set_handle(conn, HCI_CON_HANDLE_INVALID);
+    hci_connection_lookup_slot_remove(hci_connection_lookup_slot_for_address(conn->address, conn->address_type), conn);
+#endif
+    // outstanding packets are discarded by controller
+    hci_connection_packets_completed(conn, conn->num_packets_sent);
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    hci_acl_tx_queue_drop(conn);
+#endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+    btstack_run_loop_remove_timer(&conn->le_throughput_policy_timer);
+#endif
+    btstack_linked_list_remove(&hci_stack->connections, (btstack_linked_item_t *) conn);
+    btstack_memory_hci_connection_free( conn );
+}
+
 
 /**
  * get le connection parameter range
@@ -289,11 +410,22 @@ void hci_connections_get_iterator(btstack_linked_list_iterator_t *it){
  * @return connection OR NULL, if not found
  */
 hci_connection_t * hci_connection_for_handle(hci_con_handle_t con_handle){
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    if (con_handle == HCI_CON_HANDLE_INVALID) return NULL;
+    hci_connection_lookup_slot_t * slot = hci_connection_lookup_slot_for_handle(con_handle);
+    if ((slot->connection != NULL) && (slot->connection->con_handle == con_handle)){
+        return slot->connection;
+    }
+    if (slot->num_overflow == 0) return NULL;
+#endif
     btstack_linked_list_iterator_t it;
     btstack_linked_list_iterator_init(&it, &hci_stack->connections);
     while (btstack_linked_list_iterator_has_next(&it)){
         hci_connection_t * item = (hci_connection_t *) btstack_linked_list_iterator_next(&it);
         if ( item->con_handle == con_handle ) {
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+            hci_connection_lookup_slot_promote(slot, item);
+#endif
             return item;
         }
     } 
@@ -306,12 +438,22 @@ hci_connection_t * hci_connection_for_handle(hci_con_handle_t con_handle){
  * @return connection OR NULL, if not found
  */
 hci_connection_t * hci_connection_for_bd_addr_and_type(const bd_addr_t  addr, bd_addr_type_t addr_type){
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    hci_connection_lookup_slot_t * slot = hci_connection_lookup_slot_for_address(addr, addr_type);
+    if ((slot->connection != NULL) && (slot->connection->address_type == addr_type) && (memcmp(addr, slot->connection->address, 6) == 0)){
+        return slot->connection;
+    }
+    if (slot->num_overflow == 0) return NULL;
+#endif
     btstack_linked_list_iterator_t it;
     btstack_linked_list_iterator_init(&it, &hci_stack->connections);
     while (btstack_linked_list_iterator_has_next(&it)){
         hci_connection_t * connection = (hci_connection_t *) btstack_linked_list_iterator_next(&it);
         if (connection->address_type != addr_type)  continue;
         if (memcmp(addr, connection->address, 6) != 0) continue;
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+        hci_connection_lookup_slot_promote(slot, connection);
+#endif
         return connection;   
     } 
     return NULL;
@@ -465,21 +607,70 @@ static int nr_hci_connections(void){
     return count;
 }
 
+/**
+ * get counter for outgoing packets by connection type, sum of num_packets_sent of all connections of this type
+ */
+static uint16_t * hci_packets_sent_counter_for_connection(hci_connection_t * connection){
+    if (hci_is_le_connection(connection)){
+        return &hci_stack->acl_packets_sent_le;
+    }
+    switch (connection->address_type){
+        case BD_ADDR_TYPE_ACL:
+            return &hci_stack->acl_packets_sent_classic;
+        case BD_ADDR_TYPE_SCO:
+            return &hci_stack->sco_packets_sent;
+        default:
+            return NULL;
+    }
+}
+
+static void hci_connection_packet_sent(hci_connection_t * connection){
+    connection->num_packets_sent++;
+    uint16_t * counter = hci_packets_sent_counter_for_connection(connection);
+    if (counter != NULL){
+        (*counter)++;
+    }
+    if (connection->address_type != BD_ADDR_TYPE_SCO){
+        hci_stack->acl_packets_sent_total++;
+    }
+}
+
+#ifdef ENABLE_BTSTACK_METRICS
+static void hci_metrics_acl_packet_sent(hci_connection_t * connection, uint16_t size){
+    connection->metrics.tx_packets++;
+    connection->metrics.tx_bytes += size;
+    BTSTACK_METRICS_INC(hci_acl_tx_packets);
+    BTSTACK_METRICS_ADD(hci_acl_tx_bytes, size);
+    BTSTACK_METRICS_HISTOGRAM_ADD(hci_acl_packets_in_flight, hci_stack->acl_packets_sent_classic + hci_stack->acl_packets_sent_le);
+}
+
+static void hci_metrics_command_done(void){
+    if (!hci_stack->metrics_command_pending) return;
+    hci_stack->metrics_command_pending = false;
+    BTSTACK_METRICS_HISTOGRAM_ADD(hci_command_latency_ms, btstack_run_loop_get_time_ms() - hci_stack->metrics_command_sent_ms);
+}
+#endif
+
+static void hci_connection_packets_completed(hci_connection_t * connection, uint16_t num_packets){
+    if (connection->num_packets_sent < num_packets){
+        log_error("hci_number_completed_packets, more packet slots freed then sent.");
+        num_packets = connection->num_packets_sent;
+    }
+    connection->num_packets_sent -= num_packets;
+    uint16_t * counter = hci_packets_sent_counter_for_connection(connection);
+    if (counter != NULL){
+        *counter -= btstack_min(*counter, num_packets);
+    }
+    if (connection->address_type != BD_ADDR_TYPE_SCO){
+        hci_stack->acl_packets_completed_total += num_packets;
+    }
+}
+
 static int hci_number_free_acl_slots_for_connection_type(bd_addr_type_t address_type){
     
-    unsigned int num_packets_sent_classic = 0;
-    unsigned int num_packets_sent_le = 0;
+    unsigned int num_packets_sent_classic = hci_stack->acl_packets_sent_classic;
+    unsigned int num_packets_sent_le = hci_stack->acl_packets_sent_le;
 
-    btstack_linked_item_t *it;
-    for (it = (btstack_linked_item_t *) hci_stack->connections; it != NULL; it = it->next){
-        hci_connection_t * connection = (hci_connection_t *) it;
-        if (hci_is_le_connection(connection)){
-            num_packets_sent_le += connection->num_packets_sent;
-        }
-        if (connection->address_type == BD_ADDR_TYPE_ACL){
-            num_packets_sent_classic += connection->num_packets_sent;
-        }
-    }
     log_debug("ACL classic buffers: %u used of %u", num_packets_sent_classic, hci_stack->acl_packets_total_num);
     int free_slots_classic = hci_stack->acl_packets_total_num - num_packets_sent_classic;
     int free_slots_le = 0;
@@ -521,6 +712,29 @@ static int hci_number_free_acl_slots_for_connection_type(bd_addr_type_t address_
     }
 }
 
+void hci_get_acl_buffer_stats(hci_acl_buffer_stats_t * stats){
+    stats->acl_packets_total_num     = hci_stack->acl_packets_total_num;
+    stats->acl_packets_in_flight     = hci_stack->acl_packets_sent_classic;
+    stats->le_acl_packets_total_num  = hci_stack->le_acl_packets_total_num;
+    stats->le_acl_packets_in_flight  = hci_stack->acl_packets_sent_le;
+    stats->acl_packets_sent          = hci_stack->acl_packets_sent_total;
+    stats->acl_packets_completed     = hci_stack->acl_packets_completed_total;
+}
+
+void hci_reset_acl_buffer_stats(void){
+    hci_stack->acl_packets_sent_total      = 0;
+    hci_stack->acl_packets_completed_total = 0;
+}
+
+#ifdef ENABLE_BTSTACK_METRICS
+uint8_t hci_get_connection_metrics(hci_con_handle_t con_handle, btstack_metrics_connection_t * metrics){
+    hci_connection_t * connection = hci_connection_for_handle(con_handle);
+    if (connection == NULL) return ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER;
+    *metrics = connection->metrics;
+    return ERROR_CODE_SUCCESS;
+}
+#endif
+
 int hci_number_free_acl_slots_for_handle(hci_con_handle_t con_handle){
     // get connection type
     hci_connection_t * connection = hci_connection_for_handle(con_handle);
@@ -533,15 +747,10 @@ int hci_number_free_acl_slots_for_handle(hci_con_handle_t con_handle){
 
 #ifdef ENABLE_CLASSIC
 static int hci_number_free_sco_slots(void){
-    unsigned int num_sco_packets_sent  = 0;
+    unsigned int num_sco_packets_sent  = hci_stack->sco_packets_sent;
     btstack_linked_item_t *it;
     if (hci_stack->synchronous_flow_control_enabled){
         // explicit flow control
-        for (it = (btstack_linked_item_t *) hci_stack->connections; it ; it = it->next){
-            hci_connection_t * connection = (hci_connection_t *) it;
-            if (connection->address_type != BD_ADDR_TYPE_SCO) continue;
-            num_sco_packets_sent += connection->num_packets_sent;
-        }
         if (num_sco_packets_sent > hci_stack->sco_packets_total_num){
             log_info("hci_number_free_sco_slots:packets (%u) > total packets (%u)", num_sco_packets_sent, hci_stack->sco_packets_total_num);
             return 0;
@@ -564,6 +773,9 @@ static int hci_number_free_sco_slots(void){
 // only used to send HCI Host Number Completed Packets
 static int hci_can_send_comand_packet_transport(void){
     if (hci_stack->hci_packet_buffer_reserved) return 0;
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    if (hci_stack->acl_fragmentation_tx_active) return 0;
+#endif
 
     // check for async hci transport implementations
     if (hci_stack->hci_transport->can_send_packet_now){
@@ -586,9 +798,33 @@ static int hci_transport_can_send_prepared_packet_now(uint8_t packet_type){
     return hci_stack->hci_transport->can_send_packet_now(packet_type);
 }
 
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+// queued packets that will use controller buffers of given connection type
+static int hci_acl_tx_queue_num_packets_for_connection_type(bd_addr_type_t address_type){
+    if (hci_stack->le_acl_packets_total_num == 0){
+        // classic buffers are used for LE, too
+        return hci_stack->acl_tx_queued_classic + hci_stack->acl_tx_queued_le;
+    }
+    if (address_type == BD_ADDR_TYPE_ACL){
+        return hci_stack->acl_tx_queued_classic;
+    }
+    return hci_stack->acl_tx_queued_le;
+}
+
+// packet can be queued if there's a free buffer and queued packets don't exceed free controller buffers
+static int hci_acl_tx_queue_can_add(bd_addr_type_t address_type){
+    if (hci_stack->acl_tx_buffers_free == NULL) return 0;
+    return hci_number_free_acl_slots_for_connection_type(address_type) > hci_acl_tx_queue_num_packets_for_connection_type(address_type);
+}
+#endif
+
 static int hci_can_send_prepared_acl_packet_for_address_type(bd_addr_type_t address_type){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    return hci_acl_tx_queue_can_add(address_type);
+#else
     if (!hci_transport_can_send_prepared_packet_now(HCI_ACL_DATA_PACKET)) return 0;
     return hci_number_free_acl_slots_for_connection_type(address_type) > 0;
+#endif
 }
 
 int hci_can_send_acl_le_packet_now(void){
@@ -596,11 +832,28 @@ int hci_can_send_acl_le_packet_now(void){
     return hci_can_send_prepared_acl_packet_for_address_type(BD_ADDR_TYPE_LE_PUBLIC);
 }
 
-int hci_can_send_prepared_acl_packet_now(hci_con_handle_t con_handle) {
+// check if next ACL fragment can be passed to HCI Transport
+static int hci_can_send_acl_fragment_now(hci_con_handle_t con_handle){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    if (hci_stack->hci_packet_buffer_tx_active) return 0;
+#endif
     if (!hci_transport_can_send_prepared_packet_now(HCI_ACL_DATA_PACKET)) return 0;
     return hci_number_free_acl_slots_for_handle(con_handle) > 0;
 }
 
+int hci_can_send_prepared_acl_packet_now(hci_con_handle_t con_handle) {
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    hci_connection_t * connection = hci_connection_for_handle(con_handle);
+    if (!connection){
+        log_error("hci_can_send_prepared_acl_packet_now: handle 0x%04x not in connection list", con_handle);
+        return 0;
+    }
+    return hci_acl_tx_queue_can_add(connection->address_type);
+#else
+    return hci_can_send_acl_fragment_now(con_handle);
+#endif
+}
+
 int hci_can_send_acl_packet_now(hci_con_handle_t con_handle){
     if (hci_stack->hci_packet_buffer_reserved) return 0;
     return hci_can_send_prepared_acl_packet_now(con_handle);
@@ -613,6 +866,9 @@ int hci_can_send_acl_classic_packet_now(void){
 }
 
 int hci_can_send_prepared_sco_packet_now(void){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    if (hci_stack->acl_fragmentation_tx_active) return 0;
+#endif
     if (!hci_transport_can_send_prepared_packet_now(HCI_SCO_DATA_PACKET)) return 0;
     if (hci_have_usb_transport()){
         return hci_stack->sco_can_send_now;
@@ -656,6 +912,67 @@ static int hci_transport_synchronous(void){
     return hci_stack->hci_transport->can_send_packet_now == NULL;
 }
 
+// command or SCO packet in packet buffer is passed to transport
+static void hci_packet_buffer_tx_start(void){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    // track packet until HCI_EVENT_TRANSPORT_PACKET_SENT, ACL packets are not sent meanwhile
+    hci_stack->hci_packet_buffer_tx_active = hci_transport_synchronous() ? 0u : 1u;
+#endif
+}
+
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+static void hci_acl_tx_queue_init(void){
+    int i;
+    hci_stack->acl_tx_buffers_free = NULL;
+    for (i = 0; i < HCI_ACL_TX_QUEUE_NUM_BUFFERS; i++){
+        btstack_linked_list_add(&hci_stack->acl_tx_buffers_free, (btstack_linked_item_t *) &hci_stack->acl_tx_buffers[i]);
+    }
+    hci_stack->acl_tx_buffer_active   = NULL;
+    hci_stack->hci_packet_buffer_tx_active = 0;
+    hci_stack->acl_tx_queued_classic  = 0;
+    hci_stack->acl_tx_queued_le       = 0;
+    hci_stack->acl_tx_last_con_handle = HCI_CON_HANDLE_INVALID;
+}
+
+static uint8_t * hci_acl_tx_buffer_packet(hci_acl_tx_buffer_t * buffer){
+    return &buffer->data[HCI_OUTGOING_PRE_BUFFER_SIZE];
+}
+
+static uint8_t * hci_acl_tx_queued_counter_for_connection(hci_connection_t * connection){
+    if (hci_is_le_connection(connection)){
+        return &hci_stack->acl_tx_queued_le;
+    }
+    return &hci_stack->acl_tx_queued_classic;
+}
+
+static void hci_acl_tx_queue_drop(hci_connection_t * connection){
+    uint8_t * num_queued = hci_acl_tx_queued_counter_for_connection(connection);
+    while (connection->acl_tx_queue != NULL){
+        btstack_linked_item_t * buffer = btstack_linked_list_pop(&connection->acl_tx_queue);
+        btstack_linked_list_add(&hci_stack->acl_tx_buffers_free, buffer);
+        (*num_queued)--;
+    }
+}
+#endif
+
+// buffer with outgoing ACL packet that is currently fragmented
+static uint8_t * hci_acl_fragmentation_packet_buffer(void){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    return hci_acl_tx_buffer_packet(hci_stack->acl_tx_buffer_active);
+#else
+    return hci_stack->hci_packet_buffer;
+#endif
+}
+
+static void hci_acl_fragmentation_release_packet_buffer(void){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    btstack_linked_list_add(&hci_stack->acl_tx_buffers_free, (btstack_linked_item_t *) hci_stack->acl_tx_buffer_active);
+    hci_stack->acl_tx_buffer_active = NULL;
+#else
+    hci_release_packet_buffer();
+#endif
+}
+
 static int hci_send_acl_packet_fragments(hci_connection_t *connection){
 
     // log_info("hci_send_acl_packet_fragments  %u/%u (con 0x%04x)", hci_stack->acl_fragmentation_pos, hci_stack->acl_fragmentation_total_size, connection->con_handle);
@@ -674,6 +991,7 @@ static int hci_send_acl_packet_fragments(hci_connection_t *connection){
 
     log_debug("hci_send_acl_packet_fragments entered");
 
+    uint8_t * packet_buffer = hci_acl_fragmentation_packet_buffer();
     int err;
     // multiple packets could be send on a synchronous HCI transport
     while (true){
@@ -693,16 +1011,16 @@ static int hci_send_acl_packet_fragments(hci_connection_t *connection){
 
         // copy handle_and_flags if not first fragment and update packet boundary flags to be 01 (continuing fragmnent)
         if (acl_header_pos > 0u){
-            uint16_t handle_and_flags = little_endian_read_16(hci_stack->hci_packet_buffer, 0);
+            uint16_t handle_and_flags = little_endian_read_16(packet_buffer, 0);
             handle_and_flags = (handle_and_flags & 0xcfffu) | (1u << 12u);
-            little_endian_store_16(hci_stack->hci_packet_buffer, acl_header_pos, handle_and_flags);
+            little_endian_store_16(packet_buffer, acl_header_pos, handle_and_flags);
         }
 
         // update header len
-        little_endian_store_16(hci_stack->hci_packet_buffer, acl_header_pos + 2u, current_acl_data_packet_length);
+        little_endian_store_16(packet_buffer, acl_header_pos + 2u, current_acl_data_packet_length);
 
         // count packet
-        connection->num_packets_sent++;
+        hci_connection_packet_sent(connection);
         log_debug("hci_send_acl_packet_fragments loop before send (more fragments %d)", more_fragments);
 
         // update state for next fragment (if any) as "transport done" might be sent during send_packet already
@@ -716,8 +1034,11 @@ static int hci_send_acl_packet_fragments(hci_connection_t *connection){
         }
 
         // send packet
-        uint8_t * packet = &hci_stack->hci_packet_buffer[acl_header_pos];
+        uint8_t * packet = &packet_buffer[acl_header_pos];
         const int size = current_acl_data_packet_length + 4;
+#ifdef ENABLE_BTSTACK_METRICS
+        hci_metrics_acl_packet_sent(connection, size);
+#endif
         hci_dump_packet(HCI_ACL_DATA_PACKET, 0, packet, size);
         hci_stack->acl_fragmentation_tx_active = 1;
         err = hci_stack->hci_transport->send_packet(HCI_ACL_DATA_PACKET, packet, size);
@@ -728,7 +1049,7 @@ static int hci_send_acl_packet_fragments(hci_connection_t *connection){
         if (!more_fragments) break;
 
         // can send more?
-        if (!hci_can_send_prepared_acl_packet_now(connection->con_handle)) return err;
+        if (!hci_can_send_acl_fragment_now(connection->con_handle)) return err;
     }
 
     log_debug("hci_send_acl_packet_fragments loop over");
@@ -736,13 +1057,56 @@ static int hci_send_acl_packet_fragments(hci_connection_t *connection){
     // release buffer now for synchronous transport
     if (hci_transport_synchronous()){
         hci_stack->acl_fragmentation_tx_active = 0;
-        hci_release_packet_buffer();
+        hci_acl_fragmentation_release_packet_buffer();
         hci_emit_transport_packet_sent();
     }
 
     return err;
 }
 
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+// round-robin: first connection after the last served one with queued packets and free controller buffers
+static hci_connection_t * hci_acl_tx_queue_next_connection(void){
+    if (hci_stack->hci_packet_buffer_tx_active) return NULL;
+    if (!hci_transport_can_send_prepared_packet_now(HCI_ACL_DATA_PACKET)) return NULL;
+    hci_connection_t * first_ready = NULL;
+    bool after_last = false;
+    btstack_linked_item_t * it;
+    for (it = (btstack_linked_item_t *) hci_stack->connections; it != NULL; it = it->next){
+        hci_connection_t * connection = (hci_connection_t *) it;
+        bool ready = (connection->acl_tx_queue != NULL) && (hci_number_free_acl_slots_for_connection_type(connection->address_type) > 0);
+        if (ready){
+            if (after_last) return connection;
+            if (first_ready == NULL){
+                first_ready = connection;
+            }
+        }
+        if (connection->con_handle == hci_stack->acl_tx_last_con_handle){
+            after_last = true;
+        }
+    }
+    return first_ready;
+}
+
+static bool hci_acl_tx_queue_run(void){
+    if (hci_stack->acl_tx_buffer_active != NULL) return false;
+    hci_connection_t * connection = hci_acl_tx_queue_next_connection();
+    if (connection == NULL) return false;
+
+    hci_acl_tx_buffer_t * buffer = (hci_acl_tx_buffer_t *) btstack_linked_list_pop(&connection->acl_tx_queue);
+    (*hci_acl_tx_queued_counter_for_connection(connection))--;
+    hci_stack->acl_tx_buffer_active   = buffer;
+    hci_stack->acl_tx_last_con_handle = connection->con_handle;
+
+    // setup data
+    hci_stack->acl_fragmentation_total_size = buffer->size;
+    hci_stack->acl_fragmentation_pos = 4;   // start of L2CAP packet
+
+    hci_send_acl_packet_fragments(connection);
+    return true;
+}
+#endif
+
 // pre: caller has reserved the packet buffer
 int hci_send_acl_packet_buffer(int size){
 
@@ -778,11 +1142,34 @@ int hci_send_acl_packet_buffer(int size){
 
     // hci_dump_packet( HCI_ACL_DATA_PACKET, 0, packet, size);
 
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    if (size > HCI_ACL_BUFFER_SIZE){
+        log_error("hci_send_acl_packet_buffer size %u > HCI_ACL_BUFFER_SIZE", size);
+        hci_release_packet_buffer();
+        hci_emit_transport_packet_sent();
+        return 0;
+    }
+
+    // copy into queue buffer and release packet buffer, allowing upper layers to prepare next packet right away
+    hci_acl_tx_buffer_t * buffer = (hci_acl_tx_buffer_t *) btstack_linked_list_pop(&hci_stack->acl_tx_buffers_free);
+    (void)memcpy(hci_acl_tx_buffer_packet(buffer), packet, size);
+    buffer->size = (uint16_t) size;
+    btstack_linked_list_add_tail(&connection->acl_tx_queue, (btstack_linked_item_t *) buffer);
+    (*hci_acl_tx_queued_counter_for_connection(connection))++;
+    hci_release_packet_buffer();
+
+    // send if transport idle
+    hci_acl_tx_queue_run();
+
+    hci_emit_transport_packet_sent();
+    return 0;
+#else
     // setup data
     hci_stack->acl_fragmentation_total_size = size;
     hci_stack->acl_fragmentation_pos = 4;   // start of L2CAP packet
 
     return hci_send_acl_packet_fragments(connection);
+#endif
 }
 
 #ifdef ENABLE_CLASSIC
@@ -824,14 +1211,16 @@ int hci_send_sco_packet_buffer(int size){
             hci_stack->sco_can_send_now = 0;
         } else {
             if (hci_stack->synchronous_flow_control_enabled){
-                connection->num_packets_sent++;
+                hci_connection_packet_sent(connection);
             } else {
                 connection->sco_tx_ready--;
             }
         }
     }
 
+    BTSTACK_METRICS_INC(hci_sco_tx_packets);
     hci_dump_packet( HCI_SCO_DATA_PACKET, 0, packet, size);
+    hci_packet_buffer_tx_start();
     int err = hci_stack->hci_transport->send_packet(HCI_SCO_DATA_PACKET, packet, size);
 
     if (hci_transport_synchronous()){
@@ -863,14 +1252,20 @@ static void acl_handler(uint8_t *packet, uint16_t size){
         return;
     }
 
+#ifdef ENABLE_BTSTACK_METRICS
+    conn->metrics.rx_packets++;
+    conn->metrics.rx_bytes += size;
+    BTSTACK_METRICS_INC(hci_acl_rx_packets);
+    BTSTACK_METRICS_ADD(hci_acl_rx_bytes, size);
+#endif
+
 #ifdef ENABLE_CLASSIC
     // update idle timestamp
     hci_connection_timestamp(conn);
 #endif
 
 #ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
-    hci_stack->host_completed_packets = 1;
-    conn->num_packets_completed++;
+    hci_host_num_completed_packets_add(conn, size, false);
 #endif
 
     // handle different packet types
@@ -957,8 +1352,7 @@ static void hci_shutdown_connection(hci_connection_t *conn){
 
     btstack_run_loop_remove_timer(&conn->timeout);
     
-    btstack_linked_list_remove(&hci_stack->connections, (btstack_linked_item_t *) conn);
-    btstack_memory_hci_connection_free( conn );
+    hci_connection_free(conn);
     
     // now it's gone
     hci_emit_nr_connections_changed();
@@ -1085,6 +1479,107 @@ void gap_le_get_own_address(uint8_t * addr_type, bd_addr_t addr){
 }
 
 #ifdef ENABLE_LE_CENTRAL
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+// max number of slots probed for an advertiser before the oldest entry is replaced
+#define LE_ADVERTISING_REPORT_FILTER_MAX_PROBES 8
+
+static void hci_le_advertising_report_filter_reset(void){
+    memset(hci_stack->le_advertising_report_cache, 0, sizeof(hci_stack->le_advertising_report_cache));
+}
+
+// FNV-1a over advertising data
+static uint32_t hci_le_advertising_report_data_hash(const uint8_t * data, uint8_t data_length){
+    uint32_t hash = 2166136261u;
+    uint8_t i;
+    for (i = 0; i < data_length; i++){
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static uint16_t hci_le_advertising_report_key_hash(uint8_t event_type, uint8_t address_type, const bd_addr_t address){
+    uint32_t hash = ((uint32_t) event_type << 8) | address_type;
+    uint8_t i;
+    for (i = 0; i < 6u; i++){
+        hash = (hash * 31u) + address[i];
+    }
+    return (uint16_t) (hash % LE_ADVERTISING_REPORT_FILTER_SIZE);
+}
+
+// returns true if report is unchanged since last delivery within time window
+// entries are kept per event type, as e.g. ADV_IND and SCAN_RSP of an advertiser alternate during active scanning
+static bool hci_le_advertising_report_filter(uint8_t event_type, uint8_t address_type, const uint8_t * address_le,
+                                             uint8_t data_length, const uint8_t * data){
+    if (hci_stack->le_advertising_report_filter_timeout_ms == 0u) return false;
+
+    bd_addr_t address;
+    reverse_bd_addr(address_le, address);
+    uint32_t data_hash = hci_le_advertising_report_data_hash(data, data_length);
+    uint32_t now       = btstack_run_loop_get_time_ms();
+
+    // find entry for advertiser and event type, or free/oldest slot
+    uint16_t index  = hci_le_advertising_report_key_hash(event_type, address_type, address);
+    hci_le_advertising_report_cache_entry_t * victim = NULL;
+    uint16_t probe;
+    for (probe = 0; probe < LE_ADVERTISING_REPORT_FILTER_MAX_PROBES; probe++){
+        hci_le_advertising_report_cache_entry_t * entry = &hci_stack->le_advertising_report_cache[index];
+        if (!entry->valid){
+            // entries are only cleared all at once, so key isn't stored in a later slot
+            victim = entry;
+            break;
+        }
+        if ((entry->event_type == event_type) && (entry->address_type == address_type) && (bd_addr_cmp(entry->address, address) == 0)){
+            bool unchanged = entry->data_hash == data_hash;
+            bool expired   = (now - entry->time_ms) >= hci_stack->le_advertising_report_filter_timeout_ms;
+            if (unchanged && !expired){
+                hci_stack->le_advertising_reports_filtered++;
+                return true;
+            }
+            entry->data_hash  = data_hash;
+            entry->time_ms    = now;
+            return false;
+        }
+        if ((victim == NULL) || ((int32_t)(entry->time_ms - victim->time_ms) < 0)){
+            victim = entry;
+        }
+        index++;
+        if (index == LE_ADVERTISING_REPORT_FILTER_SIZE){
+            index = 0;
+        }
+    }
+
+    // new advertiser or event type
+    victim->valid        = true;
+    victim->address_type = address_type;
+    (void)memcpy(victim->address, address, 6);
+    victim->data_hash    = data_hash;
+    victim->event_type   = event_type;
+    victim->time_ms      = now;
+    return false;
+}
+#endif
+
+// address in little endian as in HCI event
+static void le_emit_advertising_report(uint8_t event_type, uint8_t address_type, const uint8_t * address_le, int8_t rssi,
+                                       uint8_t data_length, const uint8_t * data){
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+    if (hci_le_advertising_report_filter(event_type, address_type, address_le, data_length, data)) return;
+#endif
+    uint8_t event[12 + LE_ADVERTISING_DATA_SIZE]; // use upper bound to avoid var size automatic var
+    uint16_t pos = 0;
+    event[pos++] = GAP_EVENT_ADVERTISING_REPORT;
+    event[pos++] = 10u + data_length;
+    event[pos++] = event_type;
+    event[pos++] = address_type;
+    (void)memcpy(&event[pos], address_le, 6);
+    pos += 6;
+    event[pos++] = (uint8_t) rssi;
+    event[pos++] = data_length;
+    (void)memcpy(&event[pos], data, data_length);
+    pos += data_length;
+    hci_emit_event(event, pos, 1);
+}
+
 void le_handle_advertisement_report(uint8_t *packet, uint16_t size){
 
     int offset = 3;
@@ -1093,31 +1588,71 @@ void le_handle_advertisement_report(uint8_t *packet, uint16_t size){
 
     int i;
     // log_info("HCI: handle adv report with num reports: %d", num_reports);
-    uint8_t event[12 + LE_ADVERTISING_DATA_SIZE]; // use upper bound to avoid var size automatic var
     for (i=0; (i<num_reports) && (offset < size);i++){
         // sanity checks on data_length:
         uint8_t data_length = packet[offset + 8];
         if (data_length > LE_ADVERTISING_DATA_SIZE) return;
         if ((offset + 9u + data_length + 1u) > size)    return;
-        // setup event
-        uint8_t event_size = 10u + data_length;
-        int pos = 0;
-        event[pos++] = GAP_EVENT_ADVERTISING_REPORT;
-        event[pos++] = event_size;
-        (void)memcpy(&event[pos], &packet[offset], 1 + 1 + 6); // event type + address type + address
-        offset += 8;
-        pos += 8;
-        event[pos++] = packet[offset + 1 + data_length]; // rssi
-        event[pos++] = data_length;
-        offset++;
-        (void)memcpy(&event[pos], &packet[offset], data_length);
-        pos +=    data_length;
-        offset += data_length + 1u; // rssi
-        hci_emit_event(event, pos, 1);
+        // event type, address type, address, data length, data, rssi
+        le_emit_advertising_report(packet[offset], packet[offset + 1], &packet[offset + 2], (int8_t) packet[offset + 9 + data_length],
+                                   data_length, &packet[offset + 9]);
+        offset += 9u + data_length + 1u;
+    }
+}
+
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+// map extended advertising event type of legacy PDU to advertising event type of LE Advertising Report, 0xff if invalid
+static uint8_t le_legacy_advertising_event_type(uint16_t extended_event_type){
+    switch (extended_event_type & 0x1fu){
+        case 0x13:  // ADV_IND
+            return 0;
+        case 0x15:  // ADV_DIRECT_IND
+            return 1;
+        case 0x12:  // ADV_SCAN_IND
+            return 2;
+        case 0x10:  // ADV_NONCONN_IND
+            return 3;
+        case 0x1b:  // SCAN_RSP to ADV_IND
+        case 0x1a:  // SCAN_RSP to ADV_SCAN_IND
+            return 4;
+        default:
+            return 0xff;
+    }
+}
+
+static void le_handle_extended_advertisement_report(uint8_t *packet, uint16_t size){
+    uint16_t offset = 3;
+    uint8_t num_reports = packet[offset];
+    offset += 1;
+
+    uint8_t i;
+    uint8_t event[2 + 24 + 229]; // max data length within single HCI Event
+    for (i=0; (i<num_reports) && (offset < size);i++){
+        // sanity checks on data_length:
+        if ((offset + 24u) > size) return;
+        uint8_t data_length = packet[offset + 23];
+        if ((offset + 24u + data_length) > size) return;
+        uint16_t event_type = little_endian_read_16(packet, offset);
+        if ((event_type & 0x10u) != 0u){
+            // legacy PDU, report as GAP_EVENT_ADVERTISING_REPORT
+            uint8_t legacy_event_type = le_legacy_advertising_event_type(event_type);
+            if ((legacy_event_type != 0xffu) && (data_length <= LE_ADVERTISING_DATA_SIZE)){
+                le_emit_advertising_report(legacy_event_type, packet[offset + 2], &packet[offset + 3], (int8_t) packet[offset + 13],
+                                           data_length, &packet[offset + 24]);
+            }
+        } else {
+            // report fields are stored in same order as in HCI Event
+            event[0] = GAP_EVENT_EXTENDED_ADVERTISING_REPORT;
+            event[1] = 24u + data_length;
+            (void)memcpy(&event[2], &packet[offset], 24u + data_length);
+            hci_emit_event(event, 2u + 24u + data_length, 1);
+        }
+        offset += 24u + data_length;
     }
 }
 #endif
 #endif
+#endif
 
 #ifdef ENABLE_BLE
 #ifdef ENABLE_LE_PERIPHERAL
@@ -1311,6 +1846,7 @@ static void hci_initializing_run(void){
                     int size = 3u + hci_stack->hci_packet_buffer[2u];
                     hci_stack->last_cmd_opcode = little_endian_read_16(hci_stack->hci_packet_buffer, 0);
                     hci_dump_packet(HCI_COMMAND_DATA_PACKET, 0, hci_stack->hci_packet_buffer, size);
+                    hci_packet_buffer_tx_start();
                     hci_stack->hci_transport->send_packet(HCI_COMMAND_DATA_PACKET, hci_stack->hci_packet_buffer, size);
                     break;
                 }
@@ -1514,8 +2050,20 @@ static void hci_initializing_run(void){
             break;
         case HCI_INIT_LE_SET_EVENT_MASK:
             hci_stack->substate = HCI_INIT_W4_LE_SET_EVENT_MASK;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+            if (hci_le_extended_advertising_supported()){
+                hci_send_cmd(&hci_le_set_event_mask, 0xA19FF, 0x0); // bits 0-8, 11, 12, 17, 19
+                break;
+            }
+#endif
             hci_send_cmd(&hci_le_set_event_mask, 0x809FF, 0x0); // bits 0-8, 11, 19 
             break;
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+        case HCI_INIT_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS:
+            hci_stack->substate = HCI_INIT_W4_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS;
+            hci_send_cmd(&hci_le_read_number_of_supported_advertising_sets);
+            break;
+#endif
         case HCI_INIT_WRITE_LE_HOST_SUPPORTED:
             // LE Supported Host = 1, Simultaneous Host = 0
             hci_stack->substate = HCI_INIT_W4_WRITE_LE_HOST_SUPPORTED;
@@ -1541,7 +2089,7 @@ static void hci_initializing_run(void){
             break;
         case HCI_INIT_LE_SET_SCAN_PARAMETERS:
             hci_stack->substate = HCI_INIT_W4_LE_SET_SCAN_PARAMETERS;
-            hci_send_cmd(&hci_le_set_scan_parameters, hci_stack->le_scan_type, hci_stack->le_scan_interval, hci_stack->le_scan_window, hci_stack->le_own_addr_type, hci_stack->le_scan_filter_policy);
+            hci_le_send_scan_parameters();
             break;
 #endif
         default:
@@ -1816,6 +2364,18 @@ static void hci_initializing_event_handler(const uint8_t * packet, uint16_t size
             return;
 #endif  /* ENABLE_LE_DATA_LENGTH_EXTENSION */
 
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+        case HCI_INIT_W4_LE_SET_EVENT_MASK:
+            // skip read number of supported advertising sets if extended advertising is not supported
+            if (hci_le_extended_advertising_supported()) break;
+            hci_stack->substate = HCI_INIT_W4_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS;
+            hci_initializing_next_state();
+            if (hci_stack->substate == HCI_INIT_DONE){
+                hci_init_done();
+            }
+            return;
+#endif
+
 #endif  /* ENABLE_BLE */
 
         case HCI_INIT_W4_WRITE_INQUIRY_MODE:
@@ -1895,8 +2455,7 @@ static void hci_handle_connection_failed(hci_connection_t * conn, uint8_t status
 #endif
     
     // connection failed, remove entry
-    btstack_linked_list_remove(&hci_stack->connections, (btstack_linked_item_t *) conn);
-    btstack_memory_hci_connection_free( conn );
+    hci_connection_free(conn);
 
 #ifdef ENABLE_CLASSIC
     // notify client if dedicated bonding
@@ -1991,9 +2550,11 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
     UNUSED(size);
 
     uint16_t manufacturer;
-#ifdef ENABLE_CLASSIC
+#if defined(ENABLE_CLASSIC) || defined(ENABLE_LE_THROUGHPUT_POLICY)
     hci_con_handle_t handle;
     hci_connection_t * conn;
+#endif
+#ifdef ENABLE_CLASSIC
     uint8_t status;
 #endif
     // get num cmd packets - limit to 1 to reduce complexity
@@ -2045,6 +2606,13 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
             log_info("hci_le_read_buffer_size: size %u, count %u", hci_stack->le_data_packets_length, hci_stack->le_acl_packets_total_num);
             break;
 #endif
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+        case HCI_OPCODE_HCI_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS:
+            if (packet[5] != ERROR_CODE_SUCCESS) break;
+            hci_stack->le_num_supported_advertising_sets = packet[6];
+            log_info("hci_le_read_number_of_supported_advertising_sets: %u", hci_stack->le_num_supported_advertising_sets);
+            break;
+#endif
 #ifdef ENABLE_LE_DATA_LENGTH_EXTENSION
         case HCI_OPCODE_HCI_LE_READ_MAXIMUM_DATA_LENGTH:
             hci_stack->le_supported_max_tx_octets = little_endian_read_16(packet, 6);
@@ -2052,6 +2620,17 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
             log_info("hci_le_read_maximum_data_length: tx octets %u, tx time %u us", hci_stack->le_supported_max_tx_octets, hci_stack->le_supported_max_tx_time);
             break;
 #endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+        case HCI_OPCODE_HCI_LE_SET_DATA_LENGTH:
+            // on success, wait for LE Data Length Change
+            if (packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE] == ERROR_CODE_SUCCESS) break;
+            handle = little_endian_read_16(packet, OFFSET_OF_DATA_IN_COMMAND_COMPLETE + 1);
+            conn = hci_connection_for_handle(handle);
+            if (conn != NULL){
+                hci_le_throughput_policy_task_done(conn, LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH);
+            }
+            break;
+#endif
 #ifdef ENABLE_LE_CENTRAL
         case HCI_OPCODE_HCI_LE_READ_WHITE_LIST_SIZE:
             hci_stack->le_whitelist_capacity = packet[6];
@@ -2114,7 +2693,11 @@ static void handle_command_complete_event(uint8_t * packet, uint16_t size){
             hci_stack->local_supported_commands[1] =
                 ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+ 2u] & 0x40u) >> 6u) |  // bit  8 = Octet  2, bit 6 / Read Remote Extended Features
                 ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+32u] & 0x08u) >> 2u) |  // bit  9 = Octet 32, bit 3 / Write Secure Connections Host
-                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+35u] & 0x02u) << 1u);   // bit 10 = Octet 35, bit 1 / LE Set Address Resolution Enable
+                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+35u] & 0x02u) << 1u) |  // bit 10 = Octet 35, bit 1 / LE Set Address Resolution Enable
+                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+37u] & 0x40u) >> 3u) |  // bit 11 = Octet 37, bit 6 / LE Set Extended Scan Enable
+                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+36u] & 0x20u) >> 1u) |  // bit 12 = Octet 36, bit 5 / LE Set Extended Advertising Enable
+                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+33u] & 0x40u) >> 1u) |  // bit 13 = Octet 33, bit 6 / LE Set Data Length
+                ((packet[OFFSET_OF_DATA_IN_COMMAND_COMPLETE+1u+35u] & 0x40u)     );    // bit 14 = Octet 35, bit 6 / LE Set PHY
             log_info("Local supported commands summary %02x - %02x", hci_stack->local_supported_commands[0],  hci_stack->local_supported_commands[1]);
             break;
 #ifdef ENABLE_CLASSIC
@@ -2176,8 +2759,7 @@ static void event_handle_le_connection_complete(const uint8_t * packet){
 		// outgoing le connection establishment is done
 		if (conn){
 			// remove entry
-			btstack_linked_list_remove(&hci_stack->connections, (btstack_linked_item_t *) conn);
-			btstack_memory_hci_connection_free( conn );
+			hci_connection_free(conn);
 		}
 		return;
 	}
@@ -2196,7 +2778,13 @@ static void event_handle_le_connection_complete(const uint8_t * packet){
 	} else {
 #ifdef ENABLE_LE_PERIPHERAL
 		// if we're slave, it was an incoming connection, advertisements have stopped
-		hci_stack->le_advertisements_active = false;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+		// with advertising sets, LE Advertising Set Terminated indicates which set has stopped
+		if (!hci_le_extended_advertising_supported())
+#endif
+		{
+			hci_stack->le_advertisements_active = false;
+		}
 #endif
 	}
 
@@ -2212,9 +2800,20 @@ static void event_handle_le_connection_complete(const uint8_t * packet){
 
 	conn->state = OPEN;
 	conn->role  = packet[6];
-	conn->con_handle             = hci_subevent_le_connection_complete_get_connection_handle(packet);
+	hci_connection_set_handle(conn, hci_subevent_le_connection_complete_get_connection_handle(packet));
 	conn->le_connection_interval = hci_subevent_le_connection_complete_get_conn_interval(packet);
 
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+	// request max data length first, then LE 2M PHY
+	conn->le_throughput_policy_tasks = 0;
+	if ((hci_stack->local_supported_commands[1] & (1u << 5)) != 0u){
+		conn->le_throughput_policy_tasks |= LE_THROUGHPUT_POLICY_TASKS_SET_DATA_LENGTH;
+	}
+	if ((hci_stack->local_supported_commands[1] & (1u << 6)) != 0u){
+		conn->le_throughput_policy_tasks |= LE_THROUGHPUT_POLICY_TASKS_SET_PHY;
+	}
+#endif
+
 #ifdef ENABLE_LE_PERIPHERAL
 	if (packet[6] == HCI_ROLE_SLAVE){
 		hci_update_advertisements_enabled_for_current_roles();
@@ -2243,6 +2842,8 @@ static void event_handler(uint8_t *packet, uint16_t size){
         return;
     }
 
+    BTSTACK_METRICS_INC(hci_events_received);
+
     bd_addr_type_t addr_type;
     hci_con_handle_t handle;
     hci_connection_t * conn;
@@ -2259,10 +2860,16 @@ static void event_handler(uint8_t *packet, uint16_t size){
     switch (hci_event_packet_get_type(packet)) {
                         
         case HCI_EVENT_COMMAND_COMPLETE:
+#ifdef ENABLE_BTSTACK_METRICS
+            hci_metrics_command_done();
+#endif
             handle_command_complete_event(packet, size);
             break;
             
         case HCI_EVENT_COMMAND_STATUS:
+#ifdef ENABLE_BTSTACK_METRICS
+            hci_metrics_command_done();
+#endif
             // get num cmd packets - limit to 1 to reduce complexity
             hci_stack->num_cmd_packets = packet[3] ? 1 : 0;
 
@@ -2277,6 +2884,11 @@ static void event_handler(uint8_t *packet, uint16_t size){
             if (HCI_EVENT_IS_COMMAND_STATUS(packet, hci_le_create_connection)){
                 create_connection_cmd = 1;
             }
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+            if (hci_event_command_status_get_command_opcode(packet) == HCI_OPCODE_HCI_LE_EXTENDED_CREATE_CONNECTION){
+                create_connection_cmd = 1;
+            }
+#endif
 #endif
             if (create_connection_cmd) {
                 uint8_t status = hci_event_command_status_get_status(packet);
@@ -2302,6 +2914,16 @@ static void event_handler(uint8_t *packet, uint16_t size){
                     }
                 }
             }
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+            // LE PHY Update Complete will not follow if LE Set PHY failed
+            if ((hci_event_command_status_get_command_opcode(packet) == HCI_OPCODE_HCI_LE_SET_PHY) &&
+                (hci_event_command_status_get_status(packet) != ERROR_CODE_SUCCESS)){
+                conn = hci_connection_for_handle(hci_stack->le_throughput_policy_con_handle);
+                if (conn != NULL){
+                    hci_le_throughput_policy_task_done(conn, LE_THROUGHPUT_POLICY_TASKS_W4_PHY_UPDATE);
+                }
+            }
+#endif
             break;
 
         case HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS:{
@@ -2321,12 +2943,7 @@ static void event_handler(uint8_t *packet, uint16_t size){
                     continue;
                 }
                 
-                if (conn->num_packets_sent >= num_packets){
-                    conn->num_packets_sent -= num_packets;
-                } else {
-                    log_error("hci_number_completed_packets, more packet slots freed then sent.");
-                    conn->num_packets_sent = 0;
-                }
+                hci_connection_packets_completed(conn, num_packets);
                 // log_info("hci_number_completed_packet %u processed for handle %u, outstanding %u", num_packets, handle, conn->num_packets_sent);
 
 #ifdef ENABLE_CLASSIC
@@ -2392,7 +3009,7 @@ static void event_handler(uint8_t *packet, uint16_t size){
             if (conn) {
                 if (!packet[2]){
                     conn->state = OPEN;
-                    conn->con_handle = little_endian_read_16(packet, 3);
+                    hci_connection_set_handle(conn, little_endian_read_16(packet, 3));
 
                     // queue get remote feature
                     conn->bonding_flags |= BONDING_REQUEST_REMOTE_FEATURES_PAGE_0;
@@ -2431,7 +3048,7 @@ static void event_handler(uint8_t *packet, uint16_t size){
                 break;
             }
             conn->state = OPEN;
-            conn->con_handle = little_endian_read_16(packet, 3);            
+            hci_connection_set_handle(conn, little_endian_read_16(packet, 3));            
 
 #ifdef ENABLE_SCO_OVER_HCI
             // update SCO
@@ -2648,13 +3265,13 @@ static void event_handler(uint8_t *packet, uint16_t size){
             handle = little_endian_read_16(packet, 3);
             // drop outgoing ACL fragments if it is for closed connection and release buffer if tx not active
             if (hci_stack->acl_fragmentation_total_size > 0u) {
-                if (handle == READ_ACL_CONNECTION_HANDLE(hci_stack->hci_packet_buffer)){
+                if (handle == READ_ACL_CONNECTION_HANDLE(hci_acl_fragmentation_packet_buffer())){
                     int release_buffer = hci_stack->acl_fragmentation_tx_active == 0u;
                     log_info("drop fragmented ACL data for closed connection, release buffer %u", release_buffer);
                     hci_stack->acl_fragmentation_total_size = 0;
                     hci_stack->acl_fragmentation_pos = 0;
                     if (release_buffer){
-                        hci_release_packet_buffer();
+                        hci_acl_fragmentation_release_packet_buffer();
                     }
                 }
             }
@@ -2707,9 +3324,25 @@ static void event_handler(uint8_t *packet, uint16_t size){
                 log_error("Synchronous HCI Transport shouldn't send HCI_EVENT_TRANSPORT_PACKET_SENT");
                 return; // instead of break: to avoid re-entering hci_run()
             }
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+            // ACL packets are sent from queue buffers, commands and SCO packets from the packet buffer. As the event
+            // does not indicate the packet type, only one of them is passed to the transport at a time
+            if (hci_stack->acl_fragmentation_tx_active){
+                hci_stack->acl_fragmentation_tx_active = 0;
+                if (hci_stack->acl_fragmentation_total_size == 0u){
+                    hci_acl_fragmentation_release_packet_buffer();
+                }
+            } else if (hci_stack->hci_packet_buffer_tx_active){
+                hci_stack->hci_packet_buffer_tx_active = 0;
+                hci_release_packet_buffer();
+            } else {
+                log_error("HCI_EVENT_TRANSPORT_PACKET_SENT without outgoing packet");
+            }
+#else
             hci_stack->acl_fragmentation_tx_active = 0;
             if (hci_stack->acl_fragmentation_total_size) break;
             hci_release_packet_buffer();
+#endif
             
             // L2CAP receives this event via the hci_emit_event below
 
@@ -2743,6 +3376,17 @@ static void event_handler(uint8_t *packet, uint16_t size){
                     if (!hci_stack->le_scanning_enabled) break;
                     le_handle_advertisement_report(packet, size);
                     break;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+                case HCI_SUBEVENT_LE_EXTENDED_ADVERTISING_REPORT:
+                    if (!hci_stack->le_scanning_enabled) break;
+                    le_handle_extended_advertisement_report(packet, size);
+                    break;
+#endif
+#endif
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+                case HCI_SUBEVENT_LE_ADVERTISING_SET_TERMINATED:
+                    hci_le_handle_advertising_set_terminated(hci_subevent_le_advertising_set_terminated_get_advertising_handle(packet));
+                    break;
 #endif
                 case HCI_SUBEVENT_LE_CONNECTION_COMPLETE:
 					event_handle_le_connection_complete(packet);
@@ -2782,13 +3426,32 @@ static void event_handler(uint8_t *packet, uint16_t size){
                         }
                     }
                     break;
-#ifdef ENABLE_LE_LIMIT_ACL_FRAGMENT_BY_MAX_OCTETS
+#if defined(ENABLE_LE_LIMIT_ACL_FRAGMENT_BY_MAX_OCTETS) || defined(ENABLE_LE_THROUGHPUT_POLICY)
                 case HCI_SUBEVENT_LE_DATA_LENGTH_CHANGE:
                     handle = hci_subevent_le_data_length_change_get_connection_handle(packet);
                     conn = hci_connection_for_handle(handle);
                     if (conn) {
+#ifdef ENABLE_LE_LIMIT_ACL_FRAGMENT_BY_MAX_OCTETS
                         conn->le_max_tx_octets = hci_subevent_le_data_length_change_get_max_tx_octets(packet);
+#endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+                        conn->le_tx_octets = hci_subevent_le_data_length_change_get_max_tx_octets(packet);
+                        conn->le_rx_octets = hci_subevent_le_data_length_change_get_max_rx_octets(packet);
+                        hci_le_throughput_policy_task_done(conn, LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH);
+#endif
+                    }
+                    break;
+#endif
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+                case HCI_SUBEVENT_LE_PHY_UPDATE_COMPLETE:
+                    handle = hci_subevent_le_phy_update_complete_get_connection_handle(packet);
+                    conn = hci_connection_for_handle(handle);
+                    if (conn == NULL) break;
+                    if (hci_subevent_le_phy_update_complete_get_status(packet) == ERROR_CODE_SUCCESS){
+                        conn->le_tx_phy = hci_subevent_le_phy_update_complete_get_tx_phy(packet);
+                        conn->le_rx_phy = hci_subevent_le_phy_update_complete_get_rx_phy(packet);
                     }
+                    hci_le_throughput_policy_task_done(conn, LE_THROUGHPUT_POLICY_TASKS_W4_PHY_UPDATE);
                     break;
 #endif
                 default:
@@ -2816,6 +3479,17 @@ static void event_handler(uint8_t *packet, uint16_t size){
     // notify upper stack
 	hci_emit_event(packet, size, 0);   // don't dump, already happened in packet handler
 
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+    // controller supports neither LE Set Data Length nor LE Set PHY, policy complete after LE Connection Complete
+    if ((hci_event_packet_get_type(packet) == HCI_EVENT_LE_META) && (packet[2] == HCI_SUBEVENT_LE_CONNECTION_COMPLETE) &&
+        (hci_subevent_le_connection_complete_get_status(packet) == ERROR_CODE_SUCCESS)){
+        hci_connection_t * le_conn = hci_connection_for_handle(hci_subevent_le_connection_complete_get_connection_handle(packet));
+        if ((le_conn != NULL) && (le_conn->le_throughput_policy_tasks == 0u)){
+            hci_emit_le_throughput_policy_complete(le_conn);
+        }
+    }
+#endif
+
     // moved here to give upper stack a chance to close down everything with hci_connection_t intact
     if ((hci_event_packet_get_type(packet) == HCI_EVENT_DISCONNECTION_COMPLETE) && (packet[2] == 0)){
 		handle = little_endian_read_16(packet, 3);
@@ -2874,6 +3548,8 @@ static void sco_handler(uint8_t * packet, uint16_t size){
     hci_connection_t * conn     = hci_connection_for_handle(con_handle);
     if (!conn) return;
 
+    BTSTACK_METRICS_INC(hci_sco_rx_packets);
+
     // CSR 8811 prefixes 60 byte SCO packet in transparent mode with 20 zero bytes -> skip first 20 payload bytes
     if (hci_stack->manufacturer == BLUETOOTH_COMPANY_ID_CAMBRIDGE_SILICON_RADIO){
         if ((size == 83) && ((hci_stack->sco_voice_setting_active & 0x03) == 0x03)){
@@ -2920,8 +3596,8 @@ static void sco_handler(uint8_t * packet, uint16_t size){
     }
 
 #ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
-    conn->num_packets_completed++;
-    hci_stack->host_completed_packets = 1;
+    // report SCO packets right away, they arrive periodically and the Controller has only few SCO buffers
+    hci_host_num_completed_packets_add(conn, size, true);
     hci_run();
 #endif    
 }
@@ -2929,6 +3605,7 @@ static void sco_handler(uint8_t * packet, uint16_t size){
 
 static void packet_handler(uint8_t packet_type, uint8_t *packet, uint16_t size){
     hci_dump_packet(packet_type, 1, packet, size);
+    BTSTACK_TRACE_BEGIN(trace_start);
     switch (packet_type) {
         case HCI_EVENT_PACKET:
             event_handler(packet, size);
@@ -2944,6 +3621,7 @@ static void packet_handler(uint8_t packet_type, uint8_t *packet, uint16_t size){
         default:
             break;
     }
+    BTSTACK_TRACE_PACKET_END(trace_start, BTSTACK_TRACEPOINT_HCI_DISPATCH, packet_type, packet, size);
 }
 
 /**
@@ -2971,6 +3649,16 @@ void hci_register_sco_packet_handler(btstack_packet_handler_t handler){
 static void hci_state_reset(void){
     // no connections yet
     hci_stack->connections = NULL;
+    hci_stack->acl_packets_sent_classic = 0;
+    hci_stack->acl_packets_sent_le = 0;
+    hci_stack->sco_packets_sent = 0;
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    hci_acl_tx_queue_init();
+#endif
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    memset(hci_stack->connections_by_handle,  0, sizeof(hci_stack->connections_by_handle));
+    memset(hci_stack->connections_by_address, 0, sizeof(hci_stack->connections_by_address));
+#endif
 
     // keep discoverable/connectable as this has been requested by the client(s)
     // hci_stack->discoverable = 0;
@@ -2987,6 +3675,17 @@ static void hci_state_reset(void){
 
     hci_stack->secure_connections_active = false;
 
+#ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+    // no completed packets to report
+    hci_stack->host_completed_packets = 0;
+    hci_stack->host_completed_packets_pending = 0;
+    hci_stack->host_completed_bytes_pending = 0;
+    if (hci_stack->host_completed_packets_timer_active){
+        hci_stack->host_completed_packets_timer_active = false;
+        btstack_run_loop_remove_timer(&hci_stack->host_completed_packets_timer);
+    }
+#endif
+
     // LE
 #ifdef ENABLE_BLE
     memset(hci_stack->le_random_address, 0, 6);
@@ -2998,6 +3697,33 @@ static void hci_state_reset(void){
     hci_stack->le_connecting_request = LE_CONNECTING_IDLE;
     hci_stack->le_whitelist_capacity = 0;
 #endif
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+    // advertising sets have to be configured again
+    hci_stack->le_advertisements_extended_params_set = false;
+    hci_stack->le_num_supported_advertising_sets = 0;
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->le_advertising_sets);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        le_advertising_set_t * advertising_set = (le_advertising_set_t *) btstack_linked_list_iterator_next(&it);
+        advertising_set->active = false;
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_REMOVE) != 0u){
+            btstack_linked_list_iterator_remove(&it);
+            continue;
+        }
+        advertising_set->tasks = LE_ADVERTISEMENT_TASKS_SET_PARAMS;
+        if ((advertising_set->params.own_address_type == BD_ADDR_TYPE_LE_RANDOM) || (advertising_set->params.own_address_type == 3u)){
+            advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+        }
+        if (advertising_set->adv_data_len > 0u){
+            advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_ADV_DATA;
+        }
+        if (advertising_set->scan_data_len > 0u){
+            advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA;
+        }
+        advertising_set->adv_data_pos  = 0;
+        advertising_set->scan_data_pos = 0;
+    }
+#endif
 }
 
 #ifdef ENABLE_CLASSIC
@@ -3091,12 +3817,25 @@ void hci_init(const hci_transport_t *transport, const void *config){
     hci_stack->le_scan_type     =   0x1; // active
     hci_stack->le_scan_interval = 0x1e0; // 300 ms
     hci_stack->le_scan_window   =  0x30; //  30 ms
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    hci_stack->le_scan_phys       = 0x01; // LE 1M
+    hci_stack->le_connection_phys = 0x01; // LE 1M
+#endif
+
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+    hci_stack->le_advertising_report_filter_timeout_ms = LE_ADVERTISING_REPORT_FILTER_TIMEOUT_MS;
+#endif
 #endif
 
 #ifdef ENABLE_LE_PERIPHERAL
     hci_stack->le_max_number_peripheral_connections = 1; // only single connection as peripheral
 #endif
 
+#ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+    hci_set_host_num_completed_packets_policy(HCI_HOST_NUM_COMPLETED_PACKETS_THRESHOLD, HCI_HOST_NUM_COMPLETED_BYTES_THRESHOLD,
+                                              HCI_HOST_NUM_COMPLETED_PACKETS_MAX_DELAY_MS);
+#endif
+
     // connection parameter range used to answer connection parameter update requests in l2cap
     hci_stack->le_connection_parameter_range.le_conn_interval_min =          6; 
     hci_stack->le_connection_parameter_range.le_conn_interval_max =       3200;
@@ -3517,6 +4256,58 @@ void gap_local_bd_addr(bd_addr_t address_buffer){
 }
 
 #ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+static void hci_host_num_completed_packets_timeout_handler(btstack_timer_source_t * ts){
+    UNUSED(ts);
+    hci_stack->host_completed_packets_timer_active = false;
+    if (hci_stack->host_completed_packets_pending == 0u) return;
+    if (hci_stack->host_completed_packets == 0u){
+        hci_stack->host_completed_packets = 1;
+        hci_stack->host_num_completed_packets_stats.num_flushes_by_timer++;
+    }
+    hci_run();
+}
+
+// report packet as completed, either after enough packets/bytes have been received or after max delay
+static void hci_host_num_completed_packets_add(hci_connection_t * conn, uint16_t size, bool flush){
+    conn->num_packets_completed++;
+    hci_stack->host_completed_packets_pending++;
+    hci_stack->host_completed_bytes_pending += size;
+
+    // report already scheduled
+    if (hci_stack->host_completed_packets != 0u) return;
+
+    if (flush ||
+        (hci_stack->host_completed_packets_pending >= hci_stack->host_completed_packets_threshold) ||
+        (hci_stack->host_completed_bytes_pending   >= hci_stack->host_completed_bytes_threshold)   ||
+        (hci_stack->host_completed_packets_max_delay_ms == 0u)){
+        hci_stack->host_completed_packets = 1;
+        hci_stack->host_num_completed_packets_stats.num_flushes_by_threshold++;
+        return;
+    }
+
+    if (hci_stack->host_completed_packets_timer_active) return;
+    hci_stack->host_completed_packets_timer_active = true;
+    btstack_run_loop_set_timer_handler(&hci_stack->host_completed_packets_timer, hci_host_num_completed_packets_timeout_handler);
+    btstack_run_loop_set_timer(&hci_stack->host_completed_packets_timer, hci_stack->host_completed_packets_max_delay_ms);
+    btstack_run_loop_add_timer(&hci_stack->host_completed_packets_timer);
+}
+
+void hci_set_host_num_completed_packets_policy(uint16_t packets_threshold, uint32_t bytes_threshold, uint16_t max_delay_ms){
+    // limit to half of the host buffers to keep the Controller sending
+    uint16_t max_packets_threshold = (HCI_HOST_ACL_PACKET_NUM + 1) / 2;
+    hci_stack->host_completed_packets_threshold = btstack_max(1, btstack_min(packets_threshold, max_packets_threshold));
+    hci_stack->host_completed_bytes_threshold   = btstack_max(1, bytes_threshold);
+    hci_stack->host_completed_packets_max_delay_ms = max_delay_ms;
+}
+
+void hci_get_host_num_completed_packets_stats(hci_host_num_completed_packets_stats_t * stats){
+    *stats = hci_stack->host_num_completed_packets_stats;
+}
+
+void hci_reset_host_num_completed_packets_stats(void){
+    memset(&hci_stack->host_num_completed_packets_stats, 0, sizeof(hci_host_num_completed_packets_stats_t));
+}
+
 static void hci_host_num_completed_packets(void){
 
     // create packet manually as arrays are not supported and num_commands should not get reduced
@@ -3549,8 +4340,17 @@ static void hci_host_num_completed_packets(void){
     packet[3] = num_handles;
 
     hci_stack->host_completed_packets = 0;
+    hci_stack->host_num_completed_packets_stats.num_commands++;
+    hci_stack->host_num_completed_packets_stats.num_packets += hci_stack->host_completed_packets_pending;
+    hci_stack->host_completed_packets_pending = 0;
+    hci_stack->host_completed_bytes_pending = 0;
+    if (hci_stack->host_completed_packets_timer_active){
+        hci_stack->host_completed_packets_timer_active = false;
+        btstack_run_loop_remove_timer(&hci_stack->host_completed_packets_timer);
+    }
 
     hci_dump_packet(HCI_COMMAND_DATA_PACKET, 0, packet, size);
+    hci_packet_buffer_tx_start();
     hci_stack->hci_transport->send_packet(HCI_COMMAND_DATA_PACKET, packet, size);
 
     // release packet buffer for synchronous transport implementations    
@@ -3571,10 +4371,10 @@ static void hci_halting_timeout_handler(btstack_timer_source_t * ds){
 
 static bool hci_run_acl_fragments(void){
     if (hci_stack->acl_fragmentation_total_size > 0u) {
-        hci_con_handle_t con_handle = READ_ACL_CONNECTION_HANDLE(hci_stack->hci_packet_buffer);
+        hci_con_handle_t con_handle = READ_ACL_CONNECTION_HANDLE(hci_acl_fragmentation_packet_buffer());
         hci_connection_t *connection = hci_connection_for_handle(con_handle);
         if (connection) {
-            if (hci_can_send_prepared_acl_packet_now(con_handle)){
+            if (hci_can_send_acl_fragment_now(con_handle)){
                 hci_send_acl_packet_fragments(connection);
                 return true;
             }
@@ -3583,8 +4383,19 @@ static bool hci_run_acl_fragments(void){
             log_info("hci_run: fragmented ACL packet no connection -> discard fragment");
             hci_stack->acl_fragmentation_total_size = 0;
             hci_stack->acl_fragmentation_pos = 0;
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+            if (hci_stack->acl_fragmentation_tx_active == 0u){
+                hci_acl_fragmentation_release_packet_buffer();
+            }
+#endif
         }
     }
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    // start next queued packet, number of queued packets is limited by free controller buffers
+    if (hci_stack->acl_fragmentation_total_size == 0u){
+        return hci_acl_tx_queue_run();
+    }
+#endif
     return false;
 }
 
@@ -3656,6 +4467,297 @@ static bool hci_run_general_gap_classic(void){
 #endif
 
 #ifdef ENABLE_BLE
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+static bool hci_le_extended_advertising_supported(void){
+    // LE Set Extended Scan Enable + LE Set Extended Advertising Enable
+    return (hci_stack->local_supported_commands[1] & 0x18u) == 0x18u;
+}
+#endif
+
+#ifdef ENABLE_LE_CENTRAL
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+static uint16_t hci_le_set_extended_scan_parameters_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_PARAMETERS);
+    uint16_t pos = 3;
+    hci_cmd_buffer[pos++] = hci_stack->le_own_addr_type;
+    hci_cmd_buffer[pos++] = hci_stack->le_scan_filter_policy;
+    hci_cmd_buffer[pos++] = hci_stack->le_scan_phys;
+    // same parameters for LE 1M and LE Coded
+    uint8_t phy_mask;
+    for (phy_mask = 0x01; phy_mask <= 0x04u; phy_mask <<= 2){
+        if ((hci_stack->le_scan_phys & phy_mask) == 0u) continue;
+        hci_cmd_buffer[pos++] = hci_stack->le_scan_type;
+        little_endian_store_16(hci_cmd_buffer, pos, hci_stack->le_scan_interval);
+        pos += 2;
+        little_endian_store_16(hci_cmd_buffer, pos, hci_stack->le_scan_window);
+        pos += 2;
+    }
+    hci_cmd_buffer[2] = (uint8_t) (pos - 3u);
+    return pos;
+}
+
+static uint16_t hci_le_extended_create_connection_serialize(uint8_t * hci_cmd_buffer, uint8_t initiator_filter_policy,
+                                                            bd_addr_type_t peer_address_type, const bd_addr_t peer_address){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_EXTENDED_CREATE_CONNECTION);
+    uint16_t pos = 3;
+    hci_cmd_buffer[pos++] = initiator_filter_policy;
+    hci_cmd_buffer[pos++] = hci_stack->le_own_addr_type;
+    hci_cmd_buffer[pos++] = (uint8_t) peer_address_type;
+    reverse_bd_addr(peer_address, &hci_cmd_buffer[pos]);
+    pos += 6;
+    hci_cmd_buffer[pos++] = hci_stack->le_connection_phys;
+    // same parameters for LE 1M, LE 2M, and LE Coded
+    uint8_t phy_mask;
+    for (phy_mask = 0x01; phy_mask <= 0x04u; phy_mask <<= 1){
+        if ((hci_stack->le_connection_phys & phy_mask) == 0u) continue;
+        little_endian_store_16(hci_cmd_buffer, pos,      hci_stack->le_connection_scan_interval);
+        little_endian_store_16(hci_cmd_buffer, pos +  2, hci_stack->le_connection_scan_window);
+        little_endian_store_16(hci_cmd_buffer, pos +  4, hci_stack->le_connection_interval_min);
+        little_endian_store_16(hci_cmd_buffer, pos +  6, hci_stack->le_connection_interval_max);
+        little_endian_store_16(hci_cmd_buffer, pos +  8, hci_stack->le_connection_latency);
+        little_endian_store_16(hci_cmd_buffer, pos + 10, hci_stack->le_supervision_timeout);
+        little_endian_store_16(hci_cmd_buffer, pos + 12, hci_stack->le_minimum_ce_length);
+        little_endian_store_16(hci_cmd_buffer, pos + 14, hci_stack->le_maximum_ce_length);
+        pos += 16;
+    }
+    hci_cmd_buffer[2] = (uint8_t) (pos - 3u);
+    return pos;
+}
+#endif
+
+static int hci_le_send_scan_parameters(void){
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        return hci_send_cmd_packet_buffer(hci_le_set_extended_scan_parameters_serialize(hci_cmd_packet_buffer()));
+    }
+#endif
+    return hci_send_cmd_packet_buffer(hci_le_set_scan_parameters_serialize(hci_cmd_packet_buffer(), hci_stack->le_scan_type,
+                 hci_stack->le_scan_interval, hci_stack->le_scan_window, hci_stack->le_own_addr_type, hci_stack->le_scan_filter_policy));
+}
+
+static int hci_le_send_scan_enable(uint8_t enable){
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        return hci_send_cmd_packet_buffer(hci_le_set_extended_scan_enable_serialize(hci_cmd_packet_buffer(), enable, 0, 0, 0));
+    }
+#endif
+    return hci_send_cmd_packet_buffer(hci_le_set_scan_enable_serialize(hci_cmd_packet_buffer(), enable, 0));
+}
+
+static int hci_le_send_create_connection(uint8_t initiator_filter_policy, bd_addr_type_t peer_address_type, const bd_addr_t peer_address){
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        return hci_send_cmd_packet_buffer(hci_le_extended_create_connection_serialize(hci_cmd_packet_buffer(),
+                     initiator_filter_policy, peer_address_type, peer_address));
+    }
+#endif
+    return hci_send_cmd_packet_buffer(hci_le_create_connection_serialize(hci_cmd_packet_buffer(),
+                 hci_stack->le_connection_scan_interval,    // conn scan interval
+                 hci_stack->le_connection_scan_window,      // conn scan windows
+                 initiator_filter_policy,                   // use whitelist
+                 peer_address_type,                         // peer address type
+                 peer_address,                              // peer bd addr
+                 hci_stack->le_own_addr_type,               // our addr type:
+                 hci_stack->le_connection_interval_min,     // conn interval min
+                 hci_stack->le_connection_interval_max,     // conn interval max
+                 hci_stack->le_connection_latency,          // conn latency
+                 hci_stack->le_supervision_timeout,         // conn latency
+                 hci_stack->le_minimum_ce_length,           // min ce length
+                 hci_stack->le_maximum_ce_length            // max ce length
+    ));
+}
+#endif
+
+#ifdef ENABLE_LE_PERIPHERAL
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+// advertising event properties for legacy advertising type, see LE Set Extended Advertising Parameters Command
+static const uint16_t hci_le_legacy_advertising_event_properties[] = {
+    0x13,   // ADV_IND
+    0x1d,   // ADV_DIRECT_IND (high duty cycle)
+    0x12,   // ADV_SCAN_IND
+    0x10,   // ADV_NONCONN_IND
+    0x15,   // ADV_DIRECT_IND (low duty cycle)
+};
+#endif
+
+static int hci_le_send_advertising_parameters(void){
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        // use advertising set 0 for legacy advertising, defaults as in LE Set Advertising Parameters
+        uint8_t  advertising_type = btstack_min(hci_stack->le_advertisements_type, 4);
+        uint16_t interval_min = (hci_stack->le_advertisements_interval_min != 0u) ? hci_stack->le_advertisements_interval_min : 0x0800;
+        uint16_t interval_max = (hci_stack->le_advertisements_interval_max != 0u) ? hci_stack->le_advertisements_interval_max : 0x0800;
+        uint8_t  channel_map  = (hci_stack->le_advertisements_channel_map  != 0u) ? hci_stack->le_advertisements_channel_map  : 0x07;
+        hci_stack->le_advertisements_extended_params_set = true;
+        if (hci_stack->le_own_addr_type != BD_ADDR_TYPE_LE_PUBLIC){
+            hci_stack->le_advertisements_todo |= LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+        }
+        return hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_parameters_serialize(hci_cmd_packet_buffer(), 0,
+                     hci_le_legacy_advertising_event_properties[advertising_type], interval_min, interval_max, channel_map,
+                     hci_stack->le_own_addr_type, hci_stack->le_advertisements_direct_address_type,
+                     hci_stack->le_advertisements_direct_address, hci_stack->le_advertisements_filter_policy,
+                     0x7f,  // no preference for tx power
+                     0x01,  // LE 1M
+                     0,     // secondary max skip
+                     0x01,  // LE 1M
+                     0,     // advertising sid
+                     0));   // no scan request notification
+    }
+#endif
+    return hci_send_cmd(&hci_le_set_advertising_parameters,
+                 hci_stack->le_advertisements_interval_min,
+                 hci_stack->le_advertisements_interval_max,
+                 hci_stack->le_advertisements_type,
+                 hci_stack->le_own_addr_type,
+                 hci_stack->le_advertisements_direct_address_type,
+                 hci_stack->le_advertisements_direct_address,
+                 hci_stack->le_advertisements_channel_map,
+                 hci_stack->le_advertisements_filter_policy);
+}
+
+static int hci_le_send_advertising_data(bool scan_response, uint8_t data_len, const uint8_t * data){
+    uint8_t data_clean[31];
+    memset(data_clean, 0, sizeof(data_clean));
+    (void)memcpy(data_clean, data, data_len);
+    btstack_replace_bd_addr_placeholder(data_clean, data_len, hci_stack->local_bd_addr);
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        // advertising set 0, complete data, controller should not fragment
+        if (scan_response){
+            return hci_send_cmd_packet_buffer(hci_le_set_extended_scan_response_data_serialize(hci_cmd_packet_buffer(), 0, 3, 1, data_len, data_clean));
+        } else {
+            return hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_data_serialize(hci_cmd_packet_buffer(), 0, 3, 1, data_len, data_clean));
+        }
+    }
+#endif
+    if (scan_response){
+        return hci_send_cmd(&hci_le_set_scan_response_data, data_len, data_clean);
+    } else {
+        return hci_send_cmd(&hci_le_set_advertising_data, data_len, data_clean);
+    }
+}
+
+static int hci_le_send_advertise_enable(uint8_t enable){
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    if (hci_le_extended_advertising_supported()){
+        return hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_enable_serialize(hci_cmd_packet_buffer(), enable, 1, 0, 0, 0));
+    }
+#endif
+    return hci_send_cmd(&hci_le_set_advertise_enable, enable);
+}
+
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+static le_advertising_set_t * hci_advertising_set_for_handle(uint8_t advertising_handle){
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->le_advertising_sets);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        le_advertising_set_t * item = (le_advertising_set_t *) btstack_linked_list_iterator_next(&it);
+        if (item->advertising_handle == advertising_handle) return item;
+    }
+    return NULL;
+}
+
+static void hci_le_handle_advertising_set_terminated(uint8_t advertising_handle){
+    if (advertising_handle == 0u){
+        hci_stack->le_advertisements_active = false;
+        return;
+    }
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return;
+    advertising_set->active  = false;
+    advertising_set->enabled = false;
+}
+
+// send next fragment of advertising or scan response data, returns true if all data has been sent
+static bool hci_le_send_extended_advertising_data_fragment(bool scan_response, uint8_t advertising_handle,
+                                                           const uint8_t * data, uint16_t data_len, uint16_t * data_pos){
+    uint16_t max_fragment_len = btstack_min(251, HCI_OUTGOING_PACKET_BUFFER_SIZE - 7);
+    uint16_t remaining_len    = data_len - *data_pos;
+    uint8_t  fragment_len     = (uint8_t) btstack_min(remaining_len, max_fragment_len);
+    uint8_t  operation;
+    if (*data_pos == 0u){
+        operation = (fragment_len == remaining_len) ? 3 : 1;    // complete : first
+    } else {
+        operation = (fragment_len == remaining_len) ? 2 : 0;    // last : intermediate
+    }
+    const uint8_t * fragment = &data[*data_pos];
+    *data_pos += fragment_len;
+    if (scan_response){
+        hci_send_cmd_packet_buffer(hci_le_set_extended_scan_response_data_serialize(hci_cmd_packet_buffer(),
+                     advertising_handle, operation, 1, fragment_len, fragment));
+    } else {
+        hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_data_serialize(hci_cmd_packet_buffer(),
+                     advertising_handle, operation, 1, fragment_len, fragment));
+    }
+    return *data_pos == data_len;
+}
+
+static bool hci_run_general_gap_le_advertising_sets(void){
+    const uint8_t modification_tasks = LE_ADVERTISEMENT_TASKS_SET_PARAMS | LE_ADVERTISEMENT_TASKS_SET_ADDRESS |
+                                       LE_ADVERTISEMENT_TASKS_SET_ADV_DATA | LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA |
+                                       LE_ADVERTISEMENT_TASKS_REMOVE;
+    btstack_linked_list_iterator_t it;
+    btstack_linked_list_iterator_init(&it, &hci_stack->le_advertising_sets);
+    while (btstack_linked_list_iterator_has_next(&it)){
+        le_advertising_set_t * advertising_set = (le_advertising_set_t *) btstack_linked_list_iterator_next(&it);
+        uint8_t handle = advertising_set->advertising_handle;
+
+        // stop if disabled or modification required
+        if (advertising_set->active && (!advertising_set->enabled || ((advertising_set->tasks & modification_tasks) != 0u))){
+            advertising_set->active = false;
+            hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_enable_serialize(hci_cmd_packet_buffer(), 0, 1, handle, 0, 0));
+            return true;
+        }
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_REMOVE) != 0u){
+            btstack_linked_list_iterator_remove(&it);
+            hci_send_cmd_packet_buffer(hci_le_remove_advertising_set_serialize(hci_cmd_packet_buffer(), handle));
+            return true;
+        }
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_SET_PARAMS) != 0u){
+            advertising_set->tasks &= ~LE_ADVERTISEMENT_TASKS_SET_PARAMS;
+            const le_extended_advertising_parameters_t * params = &advertising_set->params;
+            hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_parameters_serialize(hci_cmd_packet_buffer(), handle,
+                         params->advertising_event_properties, params->primary_advertising_interval_min,
+                         params->primary_advertising_interval_max, params->primary_advertising_channel_map,
+                         params->own_address_type, params->peer_address_type, params->peer_address,
+                         params->advertising_filter_policy, (uint8_t) params->advertising_tx_power,
+                         params->primary_advertising_phy, params->secondary_advertising_max_skip,
+                         params->secondary_advertising_phy, params->advertising_sid,
+                         params->scan_request_notification_enable));
+            return true;
+        }
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_SET_ADDRESS) != 0u){
+            advertising_set->tasks &= ~LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+            hci_send_cmd_packet_buffer(hci_le_set_advertising_set_random_address_serialize(hci_cmd_packet_buffer(), handle,
+                         advertising_set->random_address));
+            return true;
+        }
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_SET_ADV_DATA) != 0u){
+            if (hci_le_send_extended_advertising_data_fragment(false, handle, advertising_set->adv_data,
+                                                               advertising_set->adv_data_len, &advertising_set->adv_data_pos)){
+                advertising_set->tasks &= ~LE_ADVERTISEMENT_TASKS_SET_ADV_DATA;
+            }
+            return true;
+        }
+        if ((advertising_set->tasks & LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA) != 0u){
+            if (hci_le_send_extended_advertising_data_fragment(true, handle, advertising_set->scan_data,
+                                                               advertising_set->scan_data_len, &advertising_set->scan_data_pos)){
+                advertising_set->tasks &= ~LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA;
+            }
+            return true;
+        }
+        if (advertising_set->enabled && !advertising_set->active){
+            advertising_set->active = true;
+            hci_send_cmd_packet_buffer(hci_le_set_extended_advertising_enable_serialize(hci_cmd_packet_buffer(), 1, 1, handle,
+                         advertising_set->enable_timeout, advertising_set->enable_max_events));
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+#endif
+
 static bool hci_run_general_gap_le(void){
 
     // advertisements, active scanning, and creating connections requires random address to be set if using private address
@@ -3759,7 +4861,7 @@ static bool hci_run_general_gap_le(void){
 #ifdef ENABLE_LE_CENTRAL
     if (scanning_stop){
         hci_stack->le_scanning_active = false;
-        hci_send_cmd(&hci_le_set_scan_enable, 0, 0);
+        hci_le_send_scan_enable(0);
         return true;
     }
 #endif
@@ -3767,7 +4869,7 @@ static bool hci_run_general_gap_le(void){
 #ifdef ENABLE_LE_CENTRAL
     if (connecting_stop){
         if (hci_stack->le_connecting_state != LE_CONNECTING_CANCEL){
-            hci_send_cmd(&hci_le_create_connection_cancel);
+            hci_send_cmd_packet_buffer(hci_le_create_connection_cancel_serialize(hci_cmd_packet_buffer()));
             return true;
         }
     }
@@ -3776,7 +4878,7 @@ static bool hci_run_general_gap_le(void){
 #ifdef ENABLE_LE_PERIPHERAL
     if (advertising_stop){
         hci_stack->le_advertisements_active = false;
-        hci_send_cmd(&hci_le_set_advertise_enable, 0);
+        hci_le_send_advertise_enable(0);
         return true;
     }
 #endif
@@ -3786,44 +4888,43 @@ static bool hci_run_general_gap_le(void){
 #ifdef ENABLE_LE_CENTRAL
     if (hci_stack->le_scanning_param_update){
         hci_stack->le_scanning_param_update = false;
-        hci_send_cmd(&hci_le_set_scan_parameters, hci_stack->le_scan_type, hci_stack->le_scan_interval, hci_stack->le_scan_window,
-                     hci_stack->le_own_addr_type, hci_stack->le_scan_filter_policy);
+        hci_le_send_scan_parameters();
         return true;
     }
 #endif
 
 #ifdef ENABLE_LE_PERIPHERAL
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    // advertising set 0 has to be created before its data can be set or it can be enabled
+    if (hci_le_extended_advertising_supported() && !hci_stack->le_advertisements_extended_params_set &&
+        ((hci_stack->le_advertisements_todo != 0u) || hci_stack->le_advertisements_enabled_for_current_roles)){
+        hci_stack->le_advertisements_todo |= LE_ADVERTISEMENT_TASKS_SET_PARAMS;
+    }
+#endif
     if (hci_stack->le_advertisements_todo & LE_ADVERTISEMENT_TASKS_SET_PARAMS){
         hci_stack->le_advertisements_todo &= ~LE_ADVERTISEMENT_TASKS_SET_PARAMS;
-        hci_send_cmd(&hci_le_set_advertising_parameters,
-                     hci_stack->le_advertisements_interval_min,
-                     hci_stack->le_advertisements_interval_max,
-                     hci_stack->le_advertisements_type,
-                     hci_stack->le_own_addr_type,
-                     hci_stack->le_advertisements_direct_address_type,
-                     hci_stack->le_advertisements_direct_address,
-                     hci_stack->le_advertisements_channel_map,
-                     hci_stack->le_advertisements_filter_policy);
+        hci_le_send_advertising_parameters();
         return true;
     }
+    if (hci_stack->le_advertisements_todo & LE_ADVERTISEMENT_TASKS_SET_ADDRESS){
+        hci_stack->le_advertisements_todo &= ~LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+        if (hci_le_extended_advertising_supported() && hci_stack->le_advertisements_extended_params_set &&
+            (hci_stack->le_own_addr_type != BD_ADDR_TYPE_LE_PUBLIC)){
+            hci_send_cmd_packet_buffer(hci_le_set_advertising_set_random_address_serialize(hci_cmd_packet_buffer(), 0,
+                         hci_stack->le_random_address));
+            return true;
+        }
+#endif
+    }
     if (hci_stack->le_advertisements_todo & LE_ADVERTISEMENT_TASKS_SET_ADV_DATA){
         hci_stack->le_advertisements_todo &= ~LE_ADVERTISEMENT_TASKS_SET_ADV_DATA;
-        uint8_t adv_data_clean[31];
-        memset(adv_data_clean, 0, sizeof(adv_data_clean));
-        (void)memcpy(adv_data_clean, hci_stack->le_advertisements_data,
-                     hci_stack->le_advertisements_data_len);
-        btstack_replace_bd_addr_placeholder(adv_data_clean, hci_stack->le_advertisements_data_len, hci_stack->local_bd_addr);
-        hci_send_cmd(&hci_le_set_advertising_data, hci_stack->le_advertisements_data_len, adv_data_clean);
+        hci_le_send_advertising_data(false, hci_stack->le_advertisements_data_len, hci_stack->le_advertisements_data);
         return true;
     }
     if (hci_stack->le_advertisements_todo & LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA){
         hci_stack->le_advertisements_todo &= ~LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA;
-        uint8_t scan_data_clean[31];
-        memset(scan_data_clean, 0, sizeof(scan_data_clean));
-        (void)memcpy(scan_data_clean, hci_stack->le_scan_response_data,
-                     hci_stack->le_scan_response_data_len);
-        btstack_replace_bd_addr_placeholder(scan_data_clean, hci_stack->le_scan_response_data_len, hci_stack->local_bd_addr);
-        hci_send_cmd(&hci_le_set_scan_response_data, hci_stack->le_scan_response_data_len, scan_data_clean);
+        hci_le_send_advertising_data(true, hci_stack->le_scan_response_data_len, hci_stack->le_scan_response_data);
         return true;
     }
 #endif
@@ -3949,7 +5050,7 @@ static bool hci_run_general_gap_le(void){
     // re-start scanning
     if ((hci_stack->le_scanning_enabled && !hci_stack->le_scanning_active)){
         hci_stack->le_scanning_active = true;
-        hci_send_cmd(&hci_le_set_scan_enable, 1, 0);
+        hci_le_send_scan_enable(1);
         return true;
     }
 #endif
@@ -3959,20 +5060,7 @@ static bool hci_run_general_gap_le(void){
     if ( (hci_stack->le_connecting_state == LE_CONNECTING_IDLE) && (hci_stack->le_connecting_request == LE_CONNECTING_WHITELIST)){
         bd_addr_t null_addr;
         memset(null_addr, 0, 6);
-        hci_send_cmd(&hci_le_create_connection,
-                     hci_stack->le_connection_scan_interval,    // scan interval: 60 ms
-                     hci_stack->le_connection_scan_window,    // scan interval: 30 ms
-                     1,         // use whitelist
-                     0,         // peer address type
-                     null_addr, // peer bd addr
-                     hci_stack->le_own_addr_type, // our addr type:
-                     hci_stack->le_connection_interval_min,    // conn interval min
-                     hci_stack->le_connection_interval_max,    // conn interval max
-                     hci_stack->le_connection_latency,         // conn latency
-                     hci_stack->le_supervision_timeout,        // conn latency
-                     hci_stack->le_minimum_ce_length,          // min ce length
-                     hci_stack->le_maximum_ce_length           // max ce length
-        );
+        hci_le_send_create_connection(1, BD_ADDR_TYPE_LE_PUBLIC, null_addr);    // use whitelist
         return true;
     }
 #endif
@@ -3982,11 +5070,17 @@ static bool hci_run_general_gap_le(void){
     if (hci_stack->le_advertisements_enabled_for_current_roles && !hci_stack->le_advertisements_active){
         // check if advertisements should be enabled given
         hci_stack->le_advertisements_active = true;
-        hci_send_cmd(&hci_le_set_advertise_enable, 1);
+        hci_le_send_advertise_enable(1);
         return true;
     }
 #endif
 
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+    if (hci_le_extended_advertising_supported()){
+        if (hci_run_general_gap_le_advertising_sets()) return true;
+    }
+#endif
+
     return false;
 }
 #endif
@@ -4009,20 +5103,7 @@ static bool hci_run_general_pending_commands(void){
 #ifdef ENABLE_BLE
 #ifdef ENABLE_LE_CENTRAL
                         log_info("sending hci_le_create_connection");
-                        hci_send_cmd(&hci_le_create_connection,
-                                     hci_stack->le_connection_scan_interval,    // conn scan interval
-                                     hci_stack->le_connection_scan_window,      // conn scan windows
-                                     0,         // don't use whitelist
-                                     connection->address_type, // peer address type
-                                     connection->address,      // peer bd addr
-                                     hci_stack->le_own_addr_type, // our addr type:
-                                     hci_stack->le_connection_interval_min,    // conn interval min
-                                     hci_stack->le_connection_interval_max,    // conn interval max
-                                     hci_stack->le_connection_latency,         // conn latency
-                                     hci_stack->le_supervision_timeout,        // conn latency
-                                     hci_stack->le_minimum_ce_length,          // min ce length
-                                     hci_stack->le_maximum_ce_length          // max ce length
-                        );
+                        hci_le_send_create_connection(0, connection->address_type, connection->address);   // don't use whitelist
                         connection->state = SENT_CREATE_CONNECTION;
 #endif
 #endif
@@ -4045,13 +5126,13 @@ static bool hci_run_general_pending_commands(void){
 #ifdef ENABLE_LE_CENTRAL
             case SEND_CANCEL_CONNECTION:
                 connection->state = SENT_CANCEL_CONNECTION;
-                hci_send_cmd(&hci_le_create_connection_cancel);
+                hci_send_cmd_packet_buffer(hci_le_create_connection_cancel_serialize(hci_cmd_packet_buffer()));
                 return true;
 #endif
 #endif
             case SEND_DISCONNECT:
                 connection->state = SENT_DISCONNECT;
-                hci_send_cmd(&hci_disconnect, connection->con_handle, ERROR_CODE_REMOTE_USER_TERMINATED_CONNECTION);
+                hci_send_cmd_packet_buffer(hci_disconnect_serialize(hci_cmd_packet_buffer(), connection->con_handle, ERROR_CODE_REMOTE_USER_TERMINATED_CONNECTION));
                 return true;
 
             default:
@@ -4224,15 +5305,15 @@ static bool hci_run_general_pending_commands(void){
             // response to L2CAP CON PARAMETER UPDATE REQUEST
             case CON_PARAMETER_UPDATE_CHANGE_HCI_CON_PARAMETERS:
                 connection->le_con_parameter_update_state = CON_PARAMETER_UPDATE_NONE;
-                hci_send_cmd(&hci_le_connection_update, connection->con_handle, connection->le_conn_interval_min,
-                             connection->le_conn_interval_max, connection->le_conn_latency, connection->le_supervision_timeout,
-                             0x0000, 0xffff);
+                hci_send_cmd_packet_buffer(hci_le_connection_update_serialize(hci_cmd_packet_buffer(), connection->con_handle,
+                             connection->le_conn_interval_min, connection->le_conn_interval_max, connection->le_conn_latency,
+                             connection->le_supervision_timeout, 0x0000, 0xffff));
                 return true;
             case CON_PARAMETER_UPDATE_REPLY:
                 connection->le_con_parameter_update_state = CON_PARAMETER_UPDATE_NONE;
-                hci_send_cmd(&hci_le_remote_connection_parameter_request_reply, connection->con_handle, connection->le_conn_interval_min,
-                             connection->le_conn_interval_max, connection->le_conn_latency, connection->le_supervision_timeout,
-                             0x0000, 0xffff);
+                hci_send_cmd_packet_buffer(hci_le_remote_connection_parameter_request_reply_serialize(hci_cmd_packet_buffer(), connection->con_handle,
+                             connection->le_conn_interval_min, connection->le_conn_interval_max, connection->le_conn_latency,
+                             connection->le_supervision_timeout, 0x0000, 0xffff));
                 return true;
             case CON_PARAMETER_UPDATE_NEGATIVE_REPLY:
                 connection->le_con_parameter_update_state = CON_PARAMETER_UPDATE_NONE;
@@ -4244,7 +5325,29 @@ static bool hci_run_general_pending_commands(void){
         if (connection->le_phy_update_all_phys != 0xffu){
             uint8_t all_phys = connection->le_phy_update_all_phys;
             connection->le_phy_update_all_phys = 0xff;
-            hci_send_cmd(&hci_le_set_phy, connection->con_handle, all_phys, connection->le_phy_update_tx_phys, connection->le_phy_update_rx_phys, connection->le_phy_update_phy_options);
+            hci_send_cmd_packet_buffer(hci_le_set_phy_serialize(hci_cmd_packet_buffer(), connection->con_handle, all_phys,
+                             connection->le_phy_update_tx_phys, connection->le_phy_update_rx_phys, connection->le_phy_update_phy_options));
+            return true;
+        }
+#endif
+
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+        if ((connection->le_throughput_policy_tasks & LE_THROUGHPUT_POLICY_TASKS_SET_DATA_LENGTH) != 0u){
+            connection->le_throughput_policy_tasks &= ~LE_THROUGHPUT_POLICY_TASKS_SET_DATA_LENGTH;
+            connection->le_throughput_policy_tasks |=  LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH;
+            btstack_run_loop_set_timer(&connection->le_throughput_policy_timer, LE_THROUGHPUT_POLICY_DATA_LENGTH_TIMEOUT_MS);
+            btstack_run_loop_add_timer(&connection->le_throughput_policy_timer);
+            hci_send_cmd_packet_buffer(hci_le_set_data_length_serialize(hci_cmd_packet_buffer(), connection->con_handle,
+                             LE_THROUGHPUT_POLICY_TX_OCTETS, LE_THROUGHPUT_POLICY_TX_TIME));
+            return true;
+        }
+        if ((connection->le_throughput_policy_tasks & (LE_THROUGHPUT_POLICY_TASKS_SET_PHY | LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH))
+            == LE_THROUGHPUT_POLICY_TASKS_SET_PHY){
+            connection->le_throughput_policy_tasks &= ~LE_THROUGHPUT_POLICY_TASKS_SET_PHY;
+            connection->le_throughput_policy_tasks |=  LE_THROUGHPUT_POLICY_TASKS_W4_PHY_UPDATE;
+            hci_stack->le_throughput_policy_con_handle = connection->con_handle;
+            hci_send_cmd_packet_buffer(hci_le_set_phy_serialize(hci_cmd_packet_buffer(), connection->con_handle, 0,
+                             LE_THROUGHPUT_POLICY_PHYS, LE_THROUGHPUT_POLICY_PHYS, 0));
             return true;
         }
 #endif
@@ -4545,6 +5648,12 @@ int hci_send_cmd_packet(uint8_t *packet, int size){
         case HCI_OPCODE_HCI_LE_SET_RANDOM_ADDRESS:
             hci_stack->le_random_address_set = 1;
             reverse_bd_addr(&packet[3], hci_stack->le_random_address);
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+            // random address of advertising set 0 is set separately
+            if (hci_stack->le_advertisements_extended_params_set){
+                hci_stack->le_advertisements_todo |= LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+            }
+#endif
             break;
 #ifdef ENABLE_LE_PERIPHERAL
         case HCI_OPCODE_HCI_LE_SET_ADVERTISE_ENABLE:
@@ -4571,6 +5680,15 @@ int hci_send_cmd_packet(uint8_t *packet, int size){
             hci_stack->outgoing_addr_type = (bd_addr_type_t) packet[8]; // peer addres type
             reverse_bd_addr( &packet[9], hci_stack->outgoing_addr); // peer address
             break;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+        case HCI_OPCODE_HCI_LE_EXTENDED_CREATE_CONNECTION:
+            initiator_filter_policy = packet[3];
+            hci_stack->le_connecting_state = (initiator_filter_policy == 0u) ? LE_CONNECTING_DIRECT : LE_CONNECTING_WHITELIST;
+            // track outgoing connection
+            hci_stack->outgoing_addr_type = (bd_addr_type_t) packet[5]; // peer addres type
+            reverse_bd_addr( &packet[6], hci_stack->outgoing_addr); // peer address
+            break;
+#endif
         case HCI_OPCODE_HCI_LE_CREATE_CONNECTION_CANCEL:
             hci_stack->le_connecting_state = LE_CONNECTING_CANCEL;
             break;
@@ -4582,7 +5700,14 @@ int hci_send_cmd_packet(uint8_t *packet, int size){
 
     hci_stack->num_cmd_packets--;
 
+#ifdef ENABLE_BTSTACK_METRICS
+    BTSTACK_METRICS_INC(hci_commands_sent);
+    hci_stack->metrics_command_pending = true;
+    hci_stack->metrics_command_sent_ms = btstack_run_loop_get_time_ms();
+#endif
+
     hci_dump_packet(HCI_COMMAND_DATA_PACKET, 0, packet, size);
+    hci_packet_buffer_tx_start();
     return hci_stack->hci_transport->send_packet(HCI_COMMAND_DATA_PACKET, packet, size);
 }
 
@@ -4633,17 +5758,37 @@ int hci_send_cmd_va_arg(const hci_cmd_t *cmd, va_list argptr){
         return 0;
     }
 
-    // for HCI INITIALIZATION
-    // log_info("hci_send_cmd: opcode %04x", cmd->opcode);
-    hci_stack->last_cmd_opcode = cmd->opcode;
+    hci_reserve_packet_buffer();
+    uint16_t size = hci_cmd_create_from_template(hci_stack->hci_packet_buffer, cmd, argptr);
+    return hci_send_cmd_packet_buffer(size);
+}
 
+// reserve outgoing packet buffer for a command serialized in place by hci_cmd_serializer.h
+// pre: hci_can_send_command_packet_now() == true
+static uint8_t * hci_cmd_packet_buffer(void){
     hci_reserve_packet_buffer();
+    return hci_stack->hci_packet_buffer;
+}
+
+int hci_send_cmd_packet_buffer(uint16_t size){
+    if (!hci_stack->hci_packet_buffer_reserved) {
+        log_error("hci_send_cmd_packet_buffer called without reserving packet buffer");
+        return 0;
+    }
+
     uint8_t * packet = hci_stack->hci_packet_buffer;
-    uint16_t size = hci_cmd_create_from_template(packet, cmd, argptr);
+
+    // for HCI INITIALIZATION
+    // log_info("hci_send_cmd: opcode %04x", little_endian_read_16(packet, 0));
+    hci_stack->last_cmd_opcode = little_endian_read_16(packet, 0);
+
     int err = hci_send_cmd_packet(packet, size);
 
     // release packet buffer on error or for synchronous transport implementations
     if ((err < 0) || hci_transport_synchronous()){
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+        hci_stack->hci_packet_buffer_tx_active = 0;
+#endif
         hci_release_packet_buffer();
         hci_emit_transport_packet_sent();
     }
@@ -4671,11 +5816,13 @@ static void hci_emit_event(uint8_t * event, uint16_t size, int dump){
         hci_dump_packet( HCI_EVENT_PACKET, 0, event, size);
     } 
 
-    // dispatch to all event handlers
+    // dispatch to all event handlers, skip handlers that didn't select this event
+    uint8_t event_code = hci_event_packet_get_type(event);
     btstack_linked_list_iterator_t it;
     btstack_linked_list_iterator_init(&it, &hci_stack->event_handlers);
     while (btstack_linked_list_iterator_has_next(&it)){
         btstack_packet_callback_registration_t * entry = (btstack_packet_callback_registration_t*) btstack_linked_list_iterator_next(&it);
+        if ((entry->event_mask != NULL) && !btstack_event_mask_contains(entry->event_mask, event_code)) continue;
         entry->callback(HCI_EVENT_PACKET, 0, event, size);
     }
 }
@@ -4824,6 +5971,40 @@ static void hci_emit_l2cap_check_timeout(hci_connection_t *conn){
 }
 #endif
 
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+static void hci_emit_le_throughput_policy_complete(hci_connection_t * conn){
+    uint8_t event[10];
+    event[0] = GAP_EVENT_LE_THROUGHPUT_POLICY_COMPLETE;
+    event[1] = sizeof(event) - 2u;
+    little_endian_store_16(event, 2, conn->con_handle);
+    event[4] = conn->le_tx_phy;
+    event[5] = conn->le_rx_phy;
+    little_endian_store_16(event, 6, conn->le_tx_octets);
+    little_endian_store_16(event, 8, conn->le_rx_octets);
+    hci_emit_event(event, sizeof(event), 1);
+}
+
+static void hci_le_throughput_policy_task_done(hci_connection_t * conn, uint8_t w4_task){
+    // ignore updates not requested by policy
+    if ((conn->le_throughput_policy_tasks & w4_task) == 0u) return;
+    conn->le_throughput_policy_tasks &= ~w4_task;
+    if (w4_task == LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH){
+        btstack_run_loop_remove_timer(&conn->le_throughput_policy_timer);
+    }
+    if (conn->le_throughput_policy_tasks != 0u) return;
+    log_info("throughput policy complete for handle 0x%04x: phy tx %u rx %u, octets tx %u rx %u", conn->con_handle,
+             conn->le_tx_phy, conn->le_rx_phy, conn->le_tx_octets, conn->le_rx_octets);
+    hci_emit_le_throughput_policy_complete(conn);
+}
+
+static void hci_le_throughput_policy_timeout_handler(btstack_timer_source_t * timer){
+    hci_connection_t * conn = (hci_connection_t *) btstack_run_loop_get_timer_context(timer);
+    log_info("throughput policy: no data length change for handle 0x%04x", conn->con_handle);
+    hci_le_throughput_policy_task_done(conn, LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH);
+    hci_run();
+}
+#endif
+
 #ifdef ENABLE_BLE
 #ifdef ENABLE_LE_CENTRAL
 static void hci_emit_le_connection_complete(uint8_t address_type, const bd_addr_t address, hci_con_handle_t con_handle, uint8_t status){
@@ -5109,6 +6290,12 @@ void gap_set_local_name(const char * local_name){
 
 #ifdef ENABLE_LE_CENTRAL
 void gap_start_scan(void){
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+    // report all advertisers again when scanning is (re-)started
+    if (!hci_stack->le_scanning_enabled){
+        hci_le_advertising_report_filter_reset();
+    }
+#endif
     hci_stack->le_scanning_enabled = true;
     hci_run();
 }
@@ -5131,6 +6318,37 @@ void gap_set_scan_parameters(uint8_t scan_type, uint16_t scan_interval, uint16_t
     gap_set_scan_params(scan_type, scan_interval, scan_window, 0);
 }
 
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+void gap_set_scan_phys(uint8_t scan_phys){
+    // LE 1M and LE Coded only
+    hci_stack->le_scan_phys = scan_phys & 0x05u;
+    if (hci_stack->le_scan_phys == 0u){
+        hci_stack->le_scan_phys = 0x01;
+    }
+    hci_stack->le_scanning_param_update = true;
+    hci_run();
+}
+
+void gap_set_connection_phys(uint8_t initiating_phys){
+    // LE 1M, LE 2M, and LE Coded
+    hci_stack->le_connection_phys = initiating_phys & 0x07u;
+    if (hci_stack->le_connection_phys == 0u){
+        hci_stack->le_connection_phys = 0x01;
+    }
+}
+#endif
+
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+void gap_set_advertising_report_filter_timeout(uint32_t timeout_ms){
+    hci_stack->le_advertising_report_filter_timeout_ms = timeout_ms;
+    hci_le_advertising_report_filter_reset();
+}
+
+uint32_t gap_get_advertising_reports_filtered(void){
+    return hci_stack->le_advertising_reports_filtered;
+}
+#endif
+
 uint8_t gap_connect(const bd_addr_t addr, bd_addr_type_t addr_type){
     hci_connection_t * conn = hci_connection_for_bd_addr_and_type(addr, addr_type);
     if (!conn){
@@ -5207,8 +6425,7 @@ uint8_t gap_connect_cancel(void){
         case SEND_CREATE_CONNECTION:
             // skip sending create connection and emit event instead
             hci_emit_le_connection_complete(conn->address_type, conn->address, 0, ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER);
-            btstack_linked_list_remove(&hci_stack->connections, (btstack_linked_item_t *) conn);
-            btstack_memory_hci_connection_free( conn );
+            hci_connection_free(conn);
             break;            
         case SENT_CREATE_CONNECTION:
             // request to send cancel connection
@@ -5322,6 +6539,99 @@ void gap_scan_response_set_data(uint8_t scan_response_data_length, uint8_t * sca
     hci_run();
 }
 
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+uint8_t gap_extended_advertising_setup(le_advertising_set_t * storage, const le_extended_advertising_parameters_t * advertising_parameters, uint8_t * out_advertising_handle){
+    // find lowest unused advertising handle, 0 is used for legacy advertising
+    uint8_t advertising_handle;
+    for (advertising_handle = 1; advertising_handle <= 0xefu; advertising_handle++){
+        if (hci_advertising_set_for_handle(advertising_handle) == NULL) break;
+    }
+    if (advertising_handle > 0xefu) return ERROR_CODE_LIMIT_REACHED;
+
+    // Controller also needs an advertising set for legacy advertising
+    if (hci_stack->le_num_supported_advertising_sets > 0u){
+        uint16_t num_advertising_sets = 1u + (uint16_t) btstack_linked_list_count(&hci_stack->le_advertising_sets);
+        if (num_advertising_sets >= hci_stack->le_num_supported_advertising_sets) return ERROR_CODE_MEMORY_CAPACITY_EXCEEDED;
+    }
+
+    memset(storage, 0, sizeof(le_advertising_set_t));
+    storage->advertising_handle = advertising_handle;
+    storage->params = *advertising_parameters;
+    storage->tasks = LE_ADVERTISEMENT_TASKS_SET_PARAMS;
+    btstack_linked_list_add_tail(&hci_stack->le_advertising_sets, (btstack_linked_item_t *) storage);
+    *out_advertising_handle = advertising_handle;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_set_params(uint8_t advertising_handle, const le_extended_advertising_parameters_t * advertising_parameters){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->params = *advertising_parameters;
+    advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_PARAMS;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_set_random_address(uint8_t advertising_handle, const bd_addr_t random_address){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    (void)memcpy(advertising_set->random_address, random_address, 6);
+    advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_ADDRESS;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_set_adv_data(uint8_t advertising_handle, uint16_t advertising_data_length, const uint8_t * advertising_data){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->adv_data = advertising_data;
+    advertising_set->adv_data_len = advertising_data_length;
+    advertising_set->adv_data_pos = 0;
+    advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_ADV_DATA;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_set_scan_response_data(uint8_t advertising_handle, uint16_t scan_response_data_length, const uint8_t * scan_response_data){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->scan_data = scan_response_data;
+    advertising_set->scan_data_len = scan_response_data_length;
+    advertising_set->scan_data_pos = 0;
+    advertising_set->tasks |= LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_start(uint8_t advertising_handle, uint16_t timeout, uint8_t num_extended_advertising_events){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->enabled = true;
+    advertising_set->enable_timeout = timeout;
+    advertising_set->enable_max_events = num_extended_advertising_events;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_stop(uint8_t advertising_handle){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->enabled = false;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+
+uint8_t gap_extended_advertising_remove(uint8_t advertising_handle){
+    le_advertising_set_t * advertising_set = hci_advertising_set_for_handle(advertising_handle);
+    if (advertising_set == NULL) return ERROR_CODE_UNKNOWN_ADVERTISING_IDENTIFIER;
+    advertising_set->enabled = false;
+    advertising_set->tasks = LE_ADVERTISEMENT_TASKS_REMOVE;
+    hci_run();
+    return ERROR_CODE_SUCCESS;
+}
+#endif
+
 /**
  * @brief Set Advertisement Parameters
  * @param adv_int_min
@@ -6083,7 +7393,7 @@ void hci_setup_test_connections_fuzz(void){
     // setup incoming Classic ACL connection with con handle 0x0001, 66:55:44:33:22:01
     addr[5] = 0x01;
     conn = create_connection_for_bd_addr_and_type(addr, BD_ADDR_TYPE_ACL);
-    conn->con_handle = addr[5];
+    hci_connection_set_handle(conn, addr[5]);
     conn->role  = HCI_ROLE_SLAVE;
     conn->state = RECEIVED_CONNECTION_REQUEST;
     conn->sm_connection.sm_role = HCI_ROLE_SLAVE;
@@ -6091,7 +7401,7 @@ void hci_setup_test_connections_fuzz(void){
     // setup incoming Classic SCO connection with con handle 0x0002
     addr[5] = 0x02;
     conn = create_connection_for_bd_addr_and_type(addr, BD_ADDR_TYPE_SCO);
-    conn->con_handle = addr[5];
+    hci_connection_set_handle(conn, addr[5]);
     conn->role  = HCI_ROLE_SLAVE;
     conn->state = RECEIVED_CONNECTION_REQUEST;
     conn->sm_connection.sm_role = HCI_ROLE_SLAVE;
@@ -6099,7 +7409,7 @@ void hci_setup_test_connections_fuzz(void){
     // setup ready Classic ACL connection with con handle 0x0003
     addr[5] = 0x03;
     conn = create_connection_for_bd_addr_and_type(addr, BD_ADDR_TYPE_ACL);
-    conn->con_handle = addr[5];
+    hci_connection_set_handle(conn, addr[5]);
     conn->role  = HCI_ROLE_SLAVE;
     conn->state = OPEN;
     conn->sm_connection.sm_role = HCI_ROLE_SLAVE;
@@ -6107,7 +7417,7 @@ void hci_setup_test_connections_fuzz(void){
     // setup ready Classic SCO connection with con handle 0x0004
     addr[5] = 0x04;
     conn = create_connection_for_bd_addr_and_type(addr, BD_ADDR_TYPE_SCO);
-    conn->con_handle = addr[5];
+    hci_connection_set_handle(conn, addr[5]);
     conn->role  = HCI_ROLE_SLAVE;
     conn->state = OPEN;
     conn->sm_connection.sm_role = HCI_ROLE_SLAVE;
@@ -6115,7 +7425,7 @@ void hci_setup_test_connections_fuzz(void){
     // setup ready LE ACL connection with con handle 0x005 and public address
     addr[5] = 0x05;
     conn = create_connection_for_bd_addr_and_type(addr, BD_ADDR_TYPE_LE_PUBLIC);
-    conn->con_handle = addr[5];
+    hci_connection_set_handle(conn, addr[5]);
     conn->role  = HCI_ROLE_SLAVE;
     conn->state = OPEN;
     conn->sm_connection.sm_role = HCI_ROLE_SLAVE;
@@ -6126,8 +7436,7 @@ void hci_free_connections_fuzz(void){
     btstack_linked_list_iterator_init(&it, &hci_stack->connections);
     while (btstack_linked_list_iterator_has_next(&it)){
         hci_connection_t * con = (hci_connection_t*) btstack_linked_list_iterator_next(&it);
-        btstack_linked_list_iterator_remove(&it);
-        btstack_memory_hci_connection_free(con);
+        hci_connection_free(con);
     }
 }
 void hci_simulate_working_fuzz(void){
@@ -50,6 +50,7 @@
 #include "btstack_chipset.h"
 #include "btstack_control.h"
 #include "btstack_linked_list.h"
+#include "btstack_metrics.h"
 #include "btstack_util.h"
 #include "classic/btstack_link_key_db.h"
 #include "hci_cmd.h"
@@ -149,6 +150,47 @@ extern "C" {
 #endif
 #endif
 
+// size of connection lookup tables for handle and address, see ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+#ifndef HCI_CONNECTION_LOOKUP_TABLE_SIZE
+#define HCI_CONNECTION_LOOKUP_TABLE_SIZE 32
+#endif
+#endif
+
+// number of outgoing ACL buffers, see ENABLE_HCI_ACL_TX_QUEUE
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+#ifndef HCI_ACL_TX_QUEUE_NUM_BUFFERS
+#define HCI_ACL_TX_QUEUE_NUM_BUFFERS 4
+#endif
+#endif
+
+// size of advertising report cache and default time window, see ENABLE_LE_ADVERTISING_REPORT_FILTER
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+#ifndef LE_ADVERTISING_REPORT_FILTER_SIZE
+#define LE_ADVERTISING_REPORT_FILTER_SIZE 64
+#endif
+#ifndef LE_ADVERTISING_REPORT_FILTER_TIMEOUT_MS
+#define LE_ADVERTISING_REPORT_FILTER_TIMEOUT_MS 1000
+#endif
+#endif
+
+// data length and PHYs requested after connect, see ENABLE_LE_THROUGHPUT_POLICY
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+#ifndef LE_THROUGHPUT_POLICY_TX_OCTETS
+#define LE_THROUGHPUT_POLICY_TX_OCTETS 251
+#endif
+#ifndef LE_THROUGHPUT_POLICY_TX_TIME
+#define LE_THROUGHPUT_POLICY_TX_TIME 2120
+#endif
+#ifndef LE_THROUGHPUT_POLICY_PHYS
+#define LE_THROUGHPUT_POLICY_PHYS 0x02
+#endif
+// LE Data Length Change is only emitted if values change
+#ifndef LE_THROUGHPUT_POLICY_DATA_LENGTH_TIMEOUT_MS
+#define LE_THROUGHPUT_POLICY_DATA_LENGTH_TIMEOUT_MS 1000
+#endif
+#endif
+
 // 
 #define IS_COMMAND(packet, command) ( little_endian_read_16(packet,0) == command.opcode )
 
@@ -561,6 +603,11 @@ typedef struct {
     uint8_t num_packets_completed;
 #endif
 
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    // outgoing ACL packets waiting for transport or controller buffers
+    btstack_linked_list_t acl_tx_queue;
+#endif
+
     // LE Connection parameter update
     le_con_parameter_update_state_t le_con_parameter_update_state;
     uint8_t  le_con_param_update_identifier;
@@ -585,6 +632,16 @@ typedef struct {
     uint16_t le_max_tx_octets;
 #endif
 
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+    // LE Throughput Policy: request LE 2M PHY and max data length after connect
+    uint8_t  le_throughput_policy_tasks;
+    btstack_timer_source_t le_throughput_policy_timer;
+    uint8_t  le_tx_phy;
+    uint8_t  le_rx_phy;
+    uint16_t le_tx_octets;
+    uint16_t le_rx_octets;
+#endif
+
     // ATT Server
     att_server_t    att_server;
 #endif
@@ -593,8 +650,66 @@ typedef struct {
     l2cap_state_t l2cap_state;
 #endif
 
+#ifdef ENABLE_BTSTACK_METRICS
+    btstack_metrics_connection_t metrics;
+#endif
+
 } hci_connection_t;
 
+/**
+ * ACL buffer statistics, see hci_get_acl_buffer_stats
+ */
+typedef struct {
+    // Controller buffers for Classic and LE (le_acl_packets_total_num = 0 if shared with Classic)
+    uint16_t acl_packets_total_num;
+    uint16_t acl_packets_in_flight;
+    uint16_t le_acl_packets_total_num;
+    uint16_t le_acl_packets_in_flight;
+    // packets sent and reported as completed since start or hci_reset_acl_buffer_stats
+    uint32_t acl_packets_sent;
+    uint32_t acl_packets_completed;
+} hci_acl_buffer_stats_t;
+
+/**
+ * Host Number Of Completed Packets statistics, see hci_get_host_num_completed_packets_stats
+ */
+typedef struct {
+    // commands sent and packets reported by them
+    uint32_t num_commands;
+    uint32_t num_packets;
+    // reason for sending command
+    uint32_t num_flushes_by_threshold;
+    uint32_t num_flushes_by_timer;
+} hci_host_num_completed_packets_stats_t;
+
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+// last delivered advertising report per advertiser and event type
+typedef struct {
+    uint32_t  data_hash;
+    uint32_t  time_ms;
+    bd_addr_t address;
+    uint8_t   address_type;
+    uint8_t   event_type;
+    bool      valid;
+} hci_le_advertising_report_cache_entry_t;
+#endif
+
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+// outgoing ACL packet buffer
+typedef struct {
+    btstack_linked_item_t item;
+    uint16_t size;
+    uint8_t  data[HCI_OUTGOING_PRE_BUFFER_SIZE + HCI_ACL_BUFFER_SIZE];
+} hci_acl_tx_buffer_t;
+#endif
+
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+// direct-mapped lookup slot, connections that collide are found via list and counted in num_overflow
+typedef struct {
+    hci_connection_t * connection;
+    uint8_t            num_overflow;
+} hci_connection_lookup_slot_t;
+#endif
 
 /** 
  * HCI Inititizlization State Machine
@@ -684,6 +799,11 @@ typedef enum hci_init_state{
     HCI_INIT_W4_LE_SET_EVENT_MASK,
 #endif
 
+#if defined(ENABLE_LE_PERIPHERAL) && defined(ENABLE_LE_EXTENDED_ADVERTISING)
+    HCI_INIT_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS,
+    HCI_INIT_W4_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS,
+#endif
+
 #ifdef ENABLE_LE_DATA_LENGTH_EXTENSION
     HCI_INIT_LE_READ_MAX_DATA_LENGTH,
     HCI_INIT_W4_LE_READ_MAX_DATA_LENGTH,
@@ -718,6 +838,17 @@ enum {
     LE_ADVERTISEMENT_TASKS_SET_ADV_DATA  = 1 << 0,
     LE_ADVERTISEMENT_TASKS_SET_SCAN_DATA = 1 << 1,
     LE_ADVERTISEMENT_TASKS_SET_PARAMS    = 1 << 2,
+    LE_ADVERTISEMENT_TASKS_SET_ADDRESS   = 1 << 3,
+    LE_ADVERTISEMENT_TASKS_START         = 1 << 4,
+    LE_ADVERTISEMENT_TASKS_STOP          = 1 << 5,
+    LE_ADVERTISEMENT_TASKS_REMOVE        = 1 << 6,
+};
+
+enum {
+    LE_THROUGHPUT_POLICY_TASKS_SET_DATA_LENGTH = 1 << 0,
+    LE_THROUGHPUT_POLICY_TASKS_W4_DATA_LENGTH  = 1 << 1,
+    LE_THROUGHPUT_POLICY_TASKS_SET_PHY         = 1 << 2,
+    LE_THROUGHPUT_POLICY_TASKS_W4_PHY_UPDATE   = 1 << 3,
 };
 
 enum {
@@ -763,6 +894,12 @@ typedef struct {
     // list of existing baseband connections
     btstack_linked_list_t     connections;
 
+#ifdef ENABLE_HCI_CONNECTION_LOOKUP_TABLE
+    // connections indexed by con handle (if valid) and by address + address type
+    hci_connection_lookup_slot_t connections_by_handle[HCI_CONNECTION_LOOKUP_TABLE_SIZE];
+    hci_connection_lookup_slot_t connections_by_address[HCI_CONNECTION_LOOKUP_TABLE_SIZE];
+#endif
+
     /* callback to L2CAP layer */
     btstack_packet_handler_t acl_packet_handler;
 
@@ -808,6 +945,18 @@ typedef struct {
     uint16_t  acl_fragmentation_pos;
     uint16_t  acl_fragmentation_total_size;
     uint8_t   acl_fragmentation_tx_active;
+
+#ifdef ENABLE_HCI_ACL_TX_QUEUE
+    // pool of outgoing ACL buffers, queued per connection and sent round-robin
+    hci_acl_tx_buffer_t   acl_tx_buffers[HCI_ACL_TX_QUEUE_NUM_BUFFERS];
+    btstack_linked_list_t acl_tx_buffers_free;
+    hci_acl_tx_buffer_t * acl_tx_buffer_active;
+    // command or SCO packet in hci_packet_buffer passed to asynchronous transport
+    uint8_t               hci_packet_buffer_tx_active;
+    uint8_t               acl_tx_queued_classic;
+    uint8_t               acl_tx_queued_le;
+    hci_con_handle_t      acl_tx_last_con_handle;
+#endif
      
     /* host to controller flow control */
     uint8_t  num_cmd_packets;
@@ -821,6 +970,15 @@ typedef struct {
     uint8_t  sco_waiting_for_can_send_now;
     uint8_t  sco_can_send_now;
 
+    /* outgoing packets not completed yet, sum over all connections of given type */
+    uint16_t acl_packets_sent_classic;
+    uint16_t acl_packets_sent_le;
+    uint16_t sco_packets_sent;
+
+    /* ACL statistics */
+    uint32_t acl_packets_sent_total;
+    uint32_t acl_packets_completed_total;
+
     /* local supported features */
     uint8_t local_supported_features[8];
 
@@ -836,6 +994,10 @@ typedef struct {
     /*  8 - Read Remote Extended Features           (Octet  2/bit 5) */
     /*  9 - Write Secure Connections Host           (Octet 32/bit 3) */
     /* 10 - LE Set Address Resolution Enable        (Octet 35/bit 1) */
+    /* 11 - LE Set Extended Scan Enable             (Octet 37/bit 6) */
+    /* 12 - LE Set Extended Advertising Enable      (Octet 36/bit 5) */
+    /* 13 - LE Set Data Length                      (Octet 33/bit 6) */
+    /* 14 - LE Set PHY                              (Octet 35/bit 6) */
     uint8_t local_supported_commands[2];
 
     /* bluetooth device information from hci read local version information */
@@ -892,6 +1054,16 @@ typedef struct {
 
 #ifdef ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
     uint8_t   host_completed_packets;
+
+    // batching of Host Number Of Completed Packets
+    uint16_t  host_completed_packets_pending;
+    uint32_t  host_completed_bytes_pending;
+    uint16_t  host_completed_packets_threshold;
+    uint32_t  host_completed_bytes_threshold;
+    uint16_t  host_completed_packets_max_delay_ms;
+    bool      host_completed_packets_timer_active;
+    btstack_timer_source_t host_completed_packets_timer;
+    hci_host_num_completed_packets_stats_t host_num_completed_packets_stats;
 #endif
 
 #ifdef ENABLE_BLE
@@ -916,6 +1088,17 @@ typedef struct {
     uint8_t  le_scan_filter_policy;
     uint16_t le_scan_interval;
     uint16_t le_scan_window;
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    uint8_t  le_scan_phys;
+    uint8_t  le_connection_phys;
+#endif
+
+#ifdef ENABLE_LE_ADVERTISING_REPORT_FILTER
+    // reports with unchanged address, event type and data are dropped within time window
+    hci_le_advertising_report_cache_entry_t le_advertising_report_cache[LE_ADVERTISING_REPORT_FILTER_SIZE];
+    uint32_t le_advertising_report_filter_timeout_ms;
+    uint32_t le_advertising_reports_filtered;
+#endif
 
     // Connection parameters
     uint16_t le_connection_interval_min;
@@ -951,6 +1134,15 @@ typedef struct {
     bd_addr_t le_advertisements_direct_address;
 
     uint8_t le_max_number_peripheral_connections;
+
+#ifdef ENABLE_LE_EXTENDED_ADVERTISING
+    // advertising sets of application, advertising handle 0 is used for legacy advertising
+    btstack_linked_list_t le_advertising_sets;
+    // legacy advertising set 0 has been created by LE Set Extended Advertising Parameters
+    bool le_advertisements_extended_params_set;
+    // number of advertising sets supported by Controller, 0 = unknown
+    uint8_t le_num_supported_advertising_sets;
+#endif
 #endif
 
 #ifdef ENABLE_LE_DATA_LENGTH_EXTENSION
@@ -959,6 +1151,11 @@ typedef struct {
     uint16_t le_supported_max_tx_time;
 #endif
 
+#ifdef ENABLE_LE_THROUGHPUT_POLICY
+    // connection for which LE Set PHY was sent, command status does not contain handle
+    hci_con_handle_t le_throughput_policy_con_handle;
+#endif
+
     // custom BD ADDR
     bd_addr_t custom_bd_addr; 
     uint8_t   custom_bd_addr_set;
@@ -979,6 +1176,12 @@ typedef struct {
 	uint8_t                   le_resolving_list_remove_entries[(MAX_NUM_RESOLVING_LIST_ENTRIES + 7) / 8];
 #endif
 
+#ifdef ENABLE_BTSTACK_METRICS
+    // command round-trip time
+    bool      metrics_command_pending;
+    uint32_t  metrics_command_sent_ms;
+#endif
+
 } hci_stack_t;
 
 
@@ -1051,6 +1254,7 @@ void hci_close(void);
 
 /**
  * @brief Add event packet handler. 
+ * @note If callback_handler->event_mask is set, only events in the mask are delivered, see btstack_event_mask_init
  */
 void hci_add_event_handler(btstack_packet_callback_registration_t * callback_handler);
 
@@ -1077,6 +1281,12 @@ int hci_can_send_command_packet_now(void);
  */
 int hci_send_cmd(const hci_cmd_t *cmd, ...);
 
+/**
+ * @brief Send HCI command prepared in HCI packet buffer, e.g. by one of the typed serializers in hci_cmd_serializer.h
+ * @note Check hci_can_send_command_packet_now() and call hci_reserve_packet_buffer() before preparing the command
+ */
+int hci_send_cmd_packet_buffer(uint16_t size);
+
 
 // Sending SCO Packets
 
@@ -1250,6 +1460,47 @@ void hci_disconnect_all(void);
  */
 int hci_number_free_acl_slots_for_handle(hci_con_handle_t con_handle);
 
+/**
+ * @brief Get ACL buffer usage and packet counters. Cheap, counters are updated on send and on Number Of Completed Packets
+ * @param stats
+ */
+void hci_get_acl_buffer_stats(hci_acl_buffer_stats_t * stats);
+
+/**
+ * @brief Reset ACL packet counters reported by hci_get_acl_buffer_stats
+ */
+void hci_reset_acl_buffer_stats(void);
+
+/**
+ * @brief Configure batching of HCI Host Number Of Completed Packets. Completed packets of all connections are reported
+ *        when packets_threshold packets or bytes_threshold bytes have been received, or max_delay_ms after the first one.
+ *        Requires ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+ * @param packets_threshold limited to half of HCI_HOST_ACL_PACKET_NUM
+ * @param bytes_threshold
+ * @param max_delay_ms or 0 to report every packet right away
+ */
+void hci_set_host_num_completed_packets_policy(uint16_t packets_threshold, uint32_t bytes_threshold, uint16_t max_delay_ms);
+
+/**
+ * @brief Get number of HCI Host Number Of Completed Packets commands and reported packets.
+ *        Requires ENABLE_HCI_CONTROLLER_TO_HOST_FLOW_CONTROL
+ * @param stats
+ */
+void hci_get_host_num_completed_packets_stats(hci_host_num_completed_packets_stats_t * stats);
+
+/**
+ * @brief Reset counters reported by hci_get_host_num_completed_packets_stats
+ */
+void hci_reset_host_num_completed_packets_stats(void);
+
+/**
+ * @brief Get number of ACL packets and bytes sent and received on connection. Requires ENABLE_BTSTACK_METRICS
+ * @param con_handle
+ * @param metrics
+ * @return status ERROR_CODE_SUCCESS or ERROR_CODE_UNKNOWN_CONNECTION_IDENTIFIER
+ */
+uint8_t hci_get_connection_metrics(hci_con_handle_t con_handle, btstack_metrics_connection_t * metrics);
+
 /**
  * @brief Set Advertisement Parameters
  * @param adv_int_min
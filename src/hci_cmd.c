@@ -69,6 +69,7 @@
  *   A: 31 bytes advertising data
  *   S: Service Record (Data Element Sequence)
  *   Q: 32 byte data block, e.g. for X and Y coordinates of P-256 public key
+ *   V: variable length data block, length given by preceding 8 bit value
  */
 uint16_t hci_cmd_create_from_template(uint8_t *hci_cmd_buffer, const hci_cmd_t *cmd, va_list argptr){
     
@@ -167,6 +168,13 @@ uint16_t hci_cmd_create_from_template(uint8_t *hci_cmd_buffer, const hci_cmd_t *
                 pos += 32;
                 break;
 #endif
+            case 'V': { // variable length data, length from previous 8 bit value
+                ptr = va_arg(argptr, uint8_t *);
+                uint8_t len = hci_cmd_buffer[pos - 1];
+                (void)memcpy(&hci_cmd_buffer[pos], ptr, len);
+                pos += len;
+                break;
+            }
             default:
                 break;
         }
@@ -1371,6 +1379,117 @@ const hci_cmd_t hci_le_set_phy = {
 // LE PHY Update Complete is generated on completion
 };
 
+/**
+ * @param advertising_handle
+ * @param advertising_random_address
+ */
+const hci_cmd_t hci_le_set_advertising_set_random_address = {
+    HCI_OPCODE_HCI_LE_SET_ADVERTISING_SET_RANDOM_ADDRESS, "1B"
+    // return: status
+};
+
+/**
+ * @param advertising_handle
+ * @param advertising_event_properties
+ * @param primary_advertising_interval_min in 0.625 ms, range: 0x000020..0xffffff
+ * @param primary_advertising_interval_max in 0.625 ms, range: 0x000020..0xffffff
+ * @param primary_advertising_channel_map
+ * @param own_address_type
+ * @param peer_address_type
+ * @param peer_address
+ * @param advertising_filter_policy
+ * @param advertising_tx_power
+ * @param primary_advertising_phy
+ * @param secondary_advertising_max_skip
+ * @param secondary_advertising_phy
+ * @param advertising_sid
+ * @param scan_request_notification_enable
+ */
+const hci_cmd_t hci_le_set_extended_advertising_parameters = {
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_PARAMETERS, "1233111B1111111"
+    // return: status, selected_tx_power
+};
+
+/**
+ * @param advertising_handle
+ * @param operation
+ * @param fragment_preference
+ * @param advertising_data_length
+ * @param advertising_data
+ */
+const hci_cmd_t hci_le_set_extended_advertising_data = {
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_DATA, "1111V"
+    // return: status
+};
+
+/**
+ * @param advertising_handle
+ * @param operation
+ * @param fragment_preference
+ * @param scan_response_data_length
+ * @param scan_response_data
+ */
+const hci_cmd_t hci_le_set_extended_scan_response_data = {
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_RESPONSE_DATA, "1111V"
+    // return: status
+};
+
+/**
+ * @note only single advertising set supported by BTstack command generator
+ * @param enable
+ * @param number_of_sets must be 1
+ * @param advertising_handle
+ * @param duration in 10 ms, 0 = no timeout
+ * @param max_extended_advertising_events, 0 = no limit
+ */
+const hci_cmd_t hci_le_set_extended_advertising_enable = {
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_ENABLE, "11121"
+    // return: status
+};
+
+/**
+ */
+const hci_cmd_t hci_le_read_maximum_advertising_data_length = {
+    HCI_OPCODE_HCI_LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH, ""
+    // return: status, max_advertising_data_length
+};
+
+/**
+ */
+const hci_cmd_t hci_le_read_number_of_supported_advertising_sets = {
+    HCI_OPCODE_HCI_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS, ""
+    // return: status, num_supported_advertising_sets
+};
+
+/**
+ * @param advertising_handle
+ */
+const hci_cmd_t hci_le_remove_advertising_set = {
+    HCI_OPCODE_HCI_LE_REMOVE_ADVERTISING_SET, "1"
+    // return: status
+};
+
+/**
+ */
+const hci_cmd_t hci_le_clear_advertising_sets = {
+    HCI_OPCODE_HCI_LE_CLEAR_ADVERTISING_SETS, ""
+    // return: status
+};
+
+// LE Set Extended Scan Parameters and LE Extended Create Connection have per-PHY parameter arrays
+// and are created in hci.c
+
+/**
+ * @param enable
+ * @param filter_duplicates
+ * @param duration in 10 ms, 0 = scan continuously
+ * @param period in 1.28 s, 0 = scan continuously
+ */
+const hci_cmd_t hci_le_set_extended_scan_enable = {
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_ENABLE, "1122"
+    // return: status
+};
+
 
 #endif
 
@@ -224,6 +224,18 @@ typedef enum {
     HCI_OPCODE_HCI_LE_READ_PHY = HCI_OPCODE (OGF_LE_CONTROLLER, 0x30),
     HCI_OPCODE_HCI_LE_SET_DEFAULT_PHY = HCI_OPCODE (OGF_LE_CONTROLLER, 0x31),
     HCI_OPCODE_HCI_LE_SET_PHY = HCI_OPCODE (OGF_LE_CONTROLLER, 0x32),
+    HCI_OPCODE_HCI_LE_SET_ADVERTISING_SET_RANDOM_ADDRESS = HCI_OPCODE (OGF_LE_CONTROLLER, 0x35),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_PARAMETERS = HCI_OPCODE (OGF_LE_CONTROLLER, 0x36),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_DATA = HCI_OPCODE (OGF_LE_CONTROLLER, 0x37),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_RESPONSE_DATA = HCI_OPCODE (OGF_LE_CONTROLLER, 0x38),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_ENABLE = HCI_OPCODE (OGF_LE_CONTROLLER, 0x39),
+    HCI_OPCODE_HCI_LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH = HCI_OPCODE (OGF_LE_CONTROLLER, 0x3a),
+    HCI_OPCODE_HCI_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS = HCI_OPCODE (OGF_LE_CONTROLLER, 0x3b),
+    HCI_OPCODE_HCI_LE_REMOVE_ADVERTISING_SET = HCI_OPCODE (OGF_LE_CONTROLLER, 0x3c),
+    HCI_OPCODE_HCI_LE_CLEAR_ADVERTISING_SETS = HCI_OPCODE (OGF_LE_CONTROLLER, 0x3d),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_PARAMETERS = HCI_OPCODE (OGF_LE_CONTROLLER, 0x41),
+    HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_ENABLE = HCI_OPCODE (OGF_LE_CONTROLLER, 0x42),
+    HCI_OPCODE_HCI_LE_EXTENDED_CREATE_CONNECTION = HCI_OPCODE (OGF_LE_CONTROLLER, 0x43),
     HCI_OPCODE_HCI_BCM_WRITE_SCO_PCM_INT = HCI_OPCODE (0x3f, 0x1c),
     HCI_OPCODE_HCI_BCM_SET_SLEEP_MODE = HCI_OPCODE (0x3f, 0x0027),
     HCI_OPCODE_HCI_BCM_WRITE_TX_POWER_TABLE = HCI_OPCODE (0x3f, 0x1C9),
@@ -322,6 +334,7 @@ extern const hci_cmd_t hci_write_synchronous_flow_control_enable;
 
 extern const hci_cmd_t hci_le_add_device_to_resolving_list;
 extern const hci_cmd_t hci_le_add_device_to_white_list;
+extern const hci_cmd_t hci_le_clear_advertising_sets;
 extern const hci_cmd_t hci_le_clear_resolving_list;
 extern const hci_cmd_t hci_le_clear_white_list;
 extern const hci_cmd_t hci_le_connection_update;
@@ -337,7 +350,9 @@ extern const hci_cmd_t hci_le_read_buffer_size ;
 extern const hci_cmd_t hci_le_read_channel_map;
 extern const hci_cmd_t hci_le_read_local_p256_public_key;
 extern const hci_cmd_t hci_le_read_local_resolvable_address;
+extern const hci_cmd_t hci_le_read_maximum_advertising_data_length;
 extern const hci_cmd_t hci_le_read_maximum_data_length;
+extern const hci_cmd_t hci_le_read_number_of_supported_advertising_sets;
 extern const hci_cmd_t hci_le_read_peer_resolvable_address;
 extern const hci_cmd_t hci_le_read_phy;
 extern const hci_cmd_t hci_le_read_remote_used_features;
@@ -349,15 +364,22 @@ extern const hci_cmd_t hci_le_read_white_list_size;
 extern const hci_cmd_t hci_le_receiver_test;
 extern const hci_cmd_t hci_le_remote_connection_parameter_request_negative_reply;
 extern const hci_cmd_t hci_le_remote_connection_parameter_request_reply;
+extern const hci_cmd_t hci_le_remove_advertising_set;
 extern const hci_cmd_t hci_le_remove_device_from_resolving_list;
 extern const hci_cmd_t hci_le_remove_device_from_white_list;
 extern const hci_cmd_t hci_le_set_address_resolution_enabled;
 extern const hci_cmd_t hci_le_set_advertise_enable;
 extern const hci_cmd_t hci_le_set_advertising_data;
 extern const hci_cmd_t hci_le_set_advertising_parameters;
+extern const hci_cmd_t hci_le_set_advertising_set_random_address;
 extern const hci_cmd_t hci_le_set_data_length;
 extern const hci_cmd_t hci_le_set_default_phy;
 extern const hci_cmd_t hci_le_set_event_mask;
+extern const hci_cmd_t hci_le_set_extended_advertising_data;
+extern const hci_cmd_t hci_le_set_extended_advertising_enable;
+extern const hci_cmd_t hci_le_set_extended_advertising_parameters;
+extern const hci_cmd_t hci_le_set_extended_scan_enable;
+extern const hci_cmd_t hci_le_set_extended_scan_response_data;
 extern const hci_cmd_t hci_le_set_host_channel_classification;
 extern const hci_cmd_t hci_le_set_phy;
 extern const hci_cmd_t hci_le_set_random_address;
@@ -0,0 +1,2632 @@
+/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+
+/*
+ *  hci_cmd_serializer.h
+ *
+ *  @brief Typed serializers for HCI Commands defined in hci_cmd.c
+ *  @note  Don't edit - generated by tool/btstack_hci_cmd_generator.py
+ *
+ */
+
+#ifndef HCI_CMD_SERIALIZER_H
+#define HCI_CMD_SERIALIZER_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include "btstack_util.h"
+#include "hci_cmd.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* API_START */
+
+/**
+ * @brief Create hci_inquiry command
+ * @param hci_cmd_buffer of at least 8 bytes
+ * @param lap
+ * @param inquiry_length
+ * @param num_responses
+ * @return size of command packet
+ * @note: btstack_type 311
+ */
+static inline uint16_t hci_inquiry_serialize(uint8_t * hci_cmd_buffer, uint32_t lap, uint8_t inquiry_length, uint8_t num_responses){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_INQUIRY);
+    hci_cmd_buffer[2] = 5;
+    little_endian_store_24(hci_cmd_buffer, 3, lap);
+    hci_cmd_buffer[6] = inquiry_length;
+    hci_cmd_buffer[7] = num_responses;
+    return 8;
+}
+
+/**
+ * @brief Create hci_inquiry_cancel command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_inquiry_cancel_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_INQUIRY_CANCEL);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_create_connection command
+ * @param hci_cmd_buffer of at least 16 bytes
+ * @param bd_addr
+ * @param packet_type
+ * @param page_scan_repetition_mode
+ * @param reserved
+ * @param clock_offset
+ * @param allow_role_switch
+ * @return size of command packet
+ * @note: btstack_type B21121
+ */
+static inline uint16_t hci_create_connection_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint16_t packet_type, uint8_t page_scan_repetition_mode, uint8_t reserved, uint16_t clock_offset, uint8_t allow_role_switch){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_CREATE_CONNECTION);
+    hci_cmd_buffer[2] = 13;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    little_endian_store_16(hci_cmd_buffer, 9, packet_type);
+    hci_cmd_buffer[11] = page_scan_repetition_mode;
+    hci_cmd_buffer[12] = reserved;
+    little_endian_store_16(hci_cmd_buffer, 13, clock_offset);
+    hci_cmd_buffer[15] = allow_role_switch;
+    return 16;
+}
+
+/**
+ * @brief Create hci_disconnect command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param handle
+ * @param reason
+ * @return size of command packet
+ * @note: btstack_type H1
+ */
+static inline uint16_t hci_disconnect_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint8_t reason){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_DISCONNECT);
+    hci_cmd_buffer[2] = 3;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    hci_cmd_buffer[5] = reason;
+    return 6;
+}
+
+/**
+ * @brief Create hci_create_connection_cancel command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_create_connection_cancel_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_CREATE_CONNECTION_CANCEL);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_accept_connection_request command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param bd_addr
+ * @param role
+ * @return size of command packet
+ * @note: btstack_type B1
+ */
+static inline uint16_t hci_accept_connection_request_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t role){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ACCEPT_CONNECTION_REQUEST);
+    hci_cmd_buffer[2] = 7;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = role;
+    return 10;
+}
+
+/**
+ * @brief Create hci_reject_connection_request command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param bd_addr
+ * @param reason
+ * @return size of command packet
+ * @note: btstack_type B1
+ */
+static inline uint16_t hci_reject_connection_request_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t reason){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_REJECT_CONNECTION_REQUEST);
+    hci_cmd_buffer[2] = 7;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = reason;
+    return 10;
+}
+
+/**
+ * @brief Create hci_link_key_request_reply command
+ * @param hci_cmd_buffer of at least 25 bytes
+ * @param bd_addr
+ * @param link_key
+ * @return size of command packet
+ * @note: btstack_type BP
+ */
+static inline uint16_t hci_link_key_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, const uint8_t * link_key){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LINK_KEY_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 22;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    (void)memcpy(&hci_cmd_buffer[9], link_key, 16);
+    return 25;
+}
+
+/**
+ * @brief Create hci_link_key_request_negative_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_link_key_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LINK_KEY_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_pin_code_request_reply command
+ * @param hci_cmd_buffer of at least 26 bytes
+ * @param bd_addr
+ * @param pin_length
+ * @param pin
+ * @return size of command packet
+ * @note: btstack_type B1P
+ */
+static inline uint16_t hci_pin_code_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t pin_length, const uint8_t * pin){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_PIN_CODE_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 23;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = pin_length;
+    (void)memcpy(&hci_cmd_buffer[10], pin, 16);
+    return 26;
+}
+
+/**
+ * @brief Create hci_pin_code_request_negative_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_pin_code_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_PIN_CODE_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_change_connection_packet_type command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param handle
+ * @param packet_type
+ * @return size of command packet
+ * @note: btstack_type H2
+ */
+static inline uint16_t hci_change_connection_packet_type_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint16_t packet_type){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_CHANGE_CONNECTION_PACKET_TYPE);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_16(hci_cmd_buffer, 5, packet_type);
+    return 7;
+}
+
+/**
+ * @brief Create hci_authentication_requested command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_authentication_requested_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_AUTHENTICATION_REQUESTED);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_set_connection_encryption command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param handle
+ * @param encryption_enable
+ * @return size of command packet
+ * @note: btstack_type H1
+ */
+static inline uint16_t hci_set_connection_encryption_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint8_t encryption_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SET_CONNECTION_ENCRYPTION);
+    hci_cmd_buffer[2] = 3;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    hci_cmd_buffer[5] = encryption_enable;
+    return 6;
+}
+
+/**
+ * @brief Create hci_change_connection_link_key command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_change_connection_link_key_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_CHANGE_CONNECTION_LINK_KEY);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_remote_name_request command
+ * @param hci_cmd_buffer of at least 13 bytes
+ * @param bd_addr
+ * @param page_scan_repetition_mode
+ * @param reserved
+ * @param clock_offset
+ * @return size of command packet
+ * @note: btstack_type B112
+ */
+static inline uint16_t hci_remote_name_request_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t page_scan_repetition_mode, uint8_t reserved, uint16_t clock_offset){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_REMOTE_NAME_REQUEST);
+    hci_cmd_buffer[2] = 10;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = page_scan_repetition_mode;
+    hci_cmd_buffer[10] = reserved;
+    little_endian_store_16(hci_cmd_buffer, 11, clock_offset);
+    return 13;
+}
+
+/**
+ * @brief Create hci_remote_name_request_cancel command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_remote_name_request_cancel_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_REMOTE_NAME_REQUEST_CANCEL);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_read_remote_supported_features_command command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_remote_supported_features_command_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_REMOTE_SUPPORTED_FEATURES_COMMAND);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_read_remote_extended_features_command command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param arg1
+ * @param arg2
+ * @return size of command packet
+ * @note: btstack_type H1
+ */
+static inline uint16_t hci_read_remote_extended_features_command_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t arg1, uint8_t arg2){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_REMOTE_EXTENDED_FEATURES_COMMAND);
+    hci_cmd_buffer[2] = 3;
+    little_endian_store_16(hci_cmd_buffer, 3, arg1);
+    hci_cmd_buffer[5] = arg2;
+    return 6;
+}
+
+/**
+ * @brief Create hci_read_remote_version_information command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_remote_version_information_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_REMOTE_VERSION_INFORMATION);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_setup_synchronous_connection command
+ * @param hci_cmd_buffer of at least 20 bytes
+ * @param handle
+ * @param transmit_bandwidth
+ * @param receive_bandwidth
+ * @param max_latency
+ * @param voice_settings
+ * @param retransmission_effort
+ * @param packet_type
+ * @return size of command packet
+ * @note: btstack_type H442212
+ */
+static inline uint16_t hci_setup_synchronous_connection_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint32_t transmit_bandwidth, uint32_t receive_bandwidth, uint16_t max_latency, uint16_t voice_settings, uint8_t retransmission_effort, uint16_t packet_type){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SETUP_SYNCHRONOUS_CONNECTION);
+    hci_cmd_buffer[2] = 17;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_32(hci_cmd_buffer, 5, transmit_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 9, receive_bandwidth);
+    little_endian_store_16(hci_cmd_buffer, 13, max_latency);
+    little_endian_store_16(hci_cmd_buffer, 15, voice_settings);
+    hci_cmd_buffer[17] = retransmission_effort;
+    little_endian_store_16(hci_cmd_buffer, 18, packet_type);
+    return 20;
+}
+
+/**
+ * @brief Create hci_accept_synchronous_connection command
+ * @param hci_cmd_buffer of at least 24 bytes
+ * @param bd_addr
+ * @param transmit_bandwidth
+ * @param receive_bandwidth
+ * @param max_latency
+ * @param voice_settings
+ * @param retransmission_effort
+ * @param packet_type
+ * @return size of command packet
+ * @note: btstack_type B442212
+ */
+static inline uint16_t hci_accept_synchronous_connection_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint32_t transmit_bandwidth, uint32_t receive_bandwidth, uint16_t max_latency, uint16_t voice_settings, uint8_t retransmission_effort, uint16_t packet_type){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ACCEPT_SYNCHRONOUS_CONNECTION);
+    hci_cmd_buffer[2] = 21;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    little_endian_store_32(hci_cmd_buffer, 9, transmit_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 13, receive_bandwidth);
+    little_endian_store_16(hci_cmd_buffer, 17, max_latency);
+    little_endian_store_16(hci_cmd_buffer, 19, voice_settings);
+    hci_cmd_buffer[21] = retransmission_effort;
+    little_endian_store_16(hci_cmd_buffer, 22, packet_type);
+    return 24;
+}
+
+/**
+ * @brief Create hci_io_capability_request_reply command
+ * @param hci_cmd_buffer of at least 12 bytes
+ * @param bd_addr
+ * @param io_capability
+ * @param oob_data_present
+ * @param authentication_requirements
+ * @return size of command packet
+ * @note: btstack_type B111
+ */
+static inline uint16_t hci_io_capability_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t io_capability, uint8_t oob_data_present, uint8_t authentication_requirements){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_IO_CAPABILITY_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 9;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = io_capability;
+    hci_cmd_buffer[10] = oob_data_present;
+    hci_cmd_buffer[11] = authentication_requirements;
+    return 12;
+}
+
+/**
+ * @brief Create hci_user_confirmation_request_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_user_confirmation_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_USER_CONFIRMATION_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_user_confirmation_request_negative_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_user_confirmation_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_USER_CONFIRMATION_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_user_passkey_request_reply command
+ * @param hci_cmd_buffer of at least 13 bytes
+ * @param bd_addr
+ * @param numeric_value
+ * @return size of command packet
+ * @note: btstack_type B4
+ */
+static inline uint16_t hci_user_passkey_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint32_t numeric_value){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_USER_PASSKEY_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 10;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    little_endian_store_32(hci_cmd_buffer, 9, numeric_value);
+    return 13;
+}
+
+/**
+ * @brief Create hci_user_passkey_request_negative_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_user_passkey_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_USER_PASSKEY_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_remote_oob_data_request_reply command
+ * @param hci_cmd_buffer of at least 41 bytes
+ * @param bd_addr
+ * @param c
+ * @param r
+ * @return size of command packet
+ * @note: btstack_type BPP
+ */
+static inline uint16_t hci_remote_oob_data_request_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, const uint8_t * c, const uint8_t * r){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_REMOTE_OOB_DATA_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 38;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    (void)memcpy(&hci_cmd_buffer[9], c, 16);
+    (void)memcpy(&hci_cmd_buffer[25], r, 16);
+    return 41;
+}
+
+/**
+ * @brief Create hci_remote_oob_data_request_negative_reply command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_remote_oob_data_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_REMOTE_OOB_DATA_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_io_capability_request_negative_reply command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param bd_addr
+ * @param reason
+ * @return size of command packet
+ * @note: btstack_type B1
+ */
+static inline uint16_t hci_io_capability_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t reason){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_IO_CAPABILITY_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 7;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = reason;
+    return 10;
+}
+
+/**
+ * @brief Create hci_enhanced_setup_synchronous_connection command
+ * @param hci_cmd_buffer of at least 62 bytes
+ * @param handle
+ * @param transmit_bandwidth
+ * @param receive_bandwidth
+ * @param transmit_coding_format_type
+ * @param transmit_coding_format_company
+ * @param transmit_coding_format_codec
+ * @param receive_coding_format_type
+ * @param receive_coding_format_company
+ * @param receive_coding_format_codec
+ * @param transmit_coding_frame_size
+ * @param receive_coding_frame_size
+ * @param input_bandwidth
+ * @param output_bandwidth
+ * @param input_coding_format_type
+ * @param input_coding_format_company
+ * @param input_coding_format_codec
+ * @param output_coding_format_type
+ * @param output_coding_format_company
+ * @param output_coding_format_codec
+ * @param input_coded_data_size
+ * @param outupt_coded_data_size
+ * @param input_pcm_data_format
+ * @param output_pcm_data_format
+ * @param input_pcm_sample_payload_msb_position
+ * @param output_pcm_sample_payload_msb_position
+ * @param input_data_path
+ * @param output_data_path
+ * @param input_transport_unit_size
+ * @param output_transport_unit_size
+ * @param max_latency
+ * @param packet_type
+ * @param retransmission_effort
+ * @return size of command packet
+ * @note: btstack_type H4412212222441221222211111111221
+ */
+static inline uint16_t hci_enhanced_setup_synchronous_connection_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint32_t transmit_bandwidth, uint32_t receive_bandwidth, uint8_t transmit_coding_format_type, uint16_t transmit_coding_format_company, uint16_t transmit_coding_format_codec, uint8_t receive_coding_format_type, uint16_t receive_coding_format_company, uint16_t receive_coding_format_codec, uint16_t transmit_coding_frame_size, uint16_t receive_coding_frame_size, uint32_t input_bandwidth, uint32_t output_bandwidth, uint8_t input_coding_format_type, uint16_t input_coding_format_company, uint16_t input_coding_format_codec, uint8_t output_coding_format_type, uint16_t output_coding_format_company, uint16_t output_coding_format_codec, uint16_t input_coded_data_size, uint16_t outupt_coded_data_size, uint8_t input_pcm_data_format, uint8_t output_pcm_data_format, uint8_t input_pcm_sample_payload_msb_position, uint8_t output_pcm_sample_payload_msb_position, uint8_t input_data_path, uint8_t output_data_path, uint8_t input_transport_unit_size, uint8_t output_transport_unit_size, uint16_t max_latency, uint16_t packet_type, uint8_t retransmission_effort){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ENHANCED_SETUP_SYNCHRONOUS_CONNECTION);
+    hci_cmd_buffer[2] = 59;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_32(hci_cmd_buffer, 5, transmit_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 9, receive_bandwidth);
+    hci_cmd_buffer[13] = transmit_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 14, transmit_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 16, transmit_coding_format_codec);
+    hci_cmd_buffer[18] = receive_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 19, receive_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 21, receive_coding_format_codec);
+    little_endian_store_16(hci_cmd_buffer, 23, transmit_coding_frame_size);
+    little_endian_store_16(hci_cmd_buffer, 25, receive_coding_frame_size);
+    little_endian_store_32(hci_cmd_buffer, 27, input_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 31, output_bandwidth);
+    hci_cmd_buffer[35] = input_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 36, input_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 38, input_coding_format_codec);
+    hci_cmd_buffer[40] = output_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 41, output_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 43, output_coding_format_codec);
+    little_endian_store_16(hci_cmd_buffer, 45, input_coded_data_size);
+    little_endian_store_16(hci_cmd_buffer, 47, outupt_coded_data_size);
+    hci_cmd_buffer[49] = input_pcm_data_format;
+    hci_cmd_buffer[50] = output_pcm_data_format;
+    hci_cmd_buffer[51] = input_pcm_sample_payload_msb_position;
+    hci_cmd_buffer[52] = output_pcm_sample_payload_msb_position;
+    hci_cmd_buffer[53] = input_data_path;
+    hci_cmd_buffer[54] = output_data_path;
+    hci_cmd_buffer[55] = input_transport_unit_size;
+    hci_cmd_buffer[56] = output_transport_unit_size;
+    little_endian_store_16(hci_cmd_buffer, 57, max_latency);
+    little_endian_store_16(hci_cmd_buffer, 59, packet_type);
+    hci_cmd_buffer[61] = retransmission_effort;
+    return 62;
+}
+
+/**
+ * @brief Create hci_enhanced_accept_synchronous_connection command
+ * @param hci_cmd_buffer of at least 66 bytes
+ * @param bd_addr
+ * @param transmit_bandwidth
+ * @param receive_bandwidth
+ * @param transmit_coding_format_type
+ * @param transmit_coding_format_company
+ * @param transmit_coding_format_codec
+ * @param receive_coding_format_type
+ * @param receive_coding_format_company
+ * @param receive_coding_format_codec
+ * @param transmit_coding_frame_size
+ * @param receive_coding_frame_size
+ * @param input_bandwidth
+ * @param output_bandwidth
+ * @param input_coding_format_type
+ * @param input_coding_format_company
+ * @param input_coding_format_codec
+ * @param output_coding_format_type
+ * @param output_coding_format_company
+ * @param output_coding_format_codec
+ * @param input_coded_data_size
+ * @param outupt_coded_data_size
+ * @param input_pcm_data_format
+ * @param output_pcm_data_format
+ * @param input_pcm_sample_payload_msb_position
+ * @param output_pcm_sample_payload_msb_position
+ * @param input_data_path
+ * @param output_data_path
+ * @param input_transport_unit_size
+ * @param output_transport_unit_size
+ * @param max_latency
+ * @param packet_type
+ * @param retransmission_effort
+ * @return size of command packet
+ * @note: btstack_type B4412212222441221222211111111221
+ */
+static inline uint16_t hci_enhanced_accept_synchronous_connection_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint32_t transmit_bandwidth, uint32_t receive_bandwidth, uint8_t transmit_coding_format_type, uint16_t transmit_coding_format_company, uint16_t transmit_coding_format_codec, uint8_t receive_coding_format_type, uint16_t receive_coding_format_company, uint16_t receive_coding_format_codec, uint16_t transmit_coding_frame_size, uint16_t receive_coding_frame_size, uint32_t input_bandwidth, uint32_t output_bandwidth, uint8_t input_coding_format_type, uint16_t input_coding_format_company, uint16_t input_coding_format_codec, uint8_t output_coding_format_type, uint16_t output_coding_format_company, uint16_t output_coding_format_codec, uint16_t input_coded_data_size, uint16_t outupt_coded_data_size, uint8_t input_pcm_data_format, uint8_t output_pcm_data_format, uint8_t input_pcm_sample_payload_msb_position, uint8_t output_pcm_sample_payload_msb_position, uint8_t input_data_path, uint8_t output_data_path, uint8_t input_transport_unit_size, uint8_t output_transport_unit_size, uint16_t max_latency, uint16_t packet_type, uint8_t retransmission_effort){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ENHANCED_ACCEPT_SYNCHRONOUS_CONNECTION);
+    hci_cmd_buffer[2] = 63;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    little_endian_store_32(hci_cmd_buffer, 9, transmit_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 13, receive_bandwidth);
+    hci_cmd_buffer[17] = transmit_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 18, transmit_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 20, transmit_coding_format_codec);
+    hci_cmd_buffer[22] = receive_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 23, receive_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 25, receive_coding_format_codec);
+    little_endian_store_16(hci_cmd_buffer, 27, transmit_coding_frame_size);
+    little_endian_store_16(hci_cmd_buffer, 29, receive_coding_frame_size);
+    little_endian_store_32(hci_cmd_buffer, 31, input_bandwidth);
+    little_endian_store_32(hci_cmd_buffer, 35, output_bandwidth);
+    hci_cmd_buffer[39] = input_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 40, input_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 42, input_coding_format_codec);
+    hci_cmd_buffer[44] = output_coding_format_type;
+    little_endian_store_16(hci_cmd_buffer, 45, output_coding_format_company);
+    little_endian_store_16(hci_cmd_buffer, 47, output_coding_format_codec);
+    little_endian_store_16(hci_cmd_buffer, 49, input_coded_data_size);
+    little_endian_store_16(hci_cmd_buffer, 51, outupt_coded_data_size);
+    hci_cmd_buffer[53] = input_pcm_data_format;
+    hci_cmd_buffer[54] = output_pcm_data_format;
+    hci_cmd_buffer[55] = input_pcm_sample_payload_msb_position;
+    hci_cmd_buffer[56] = output_pcm_sample_payload_msb_position;
+    hci_cmd_buffer[57] = input_data_path;
+    hci_cmd_buffer[58] = output_data_path;
+    hci_cmd_buffer[59] = input_transport_unit_size;
+    hci_cmd_buffer[60] = output_transport_unit_size;
+    little_endian_store_16(hci_cmd_buffer, 61, max_latency);
+    little_endian_store_16(hci_cmd_buffer, 63, packet_type);
+    hci_cmd_buffer[65] = retransmission_effort;
+    return 66;
+}
+
+/**
+ * @brief Create hci_sniff_mode command
+ * @param hci_cmd_buffer of at least 13 bytes
+ * @param handle
+ * @param sniff_max_interval
+ * @param sniff_min_interval
+ * @param sniff_attempt
+ * @param sniff_timeout
+ * @return size of command packet
+ * @note: btstack_type H2222
+ */
+static inline uint16_t hci_sniff_mode_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint16_t sniff_max_interval, uint16_t sniff_min_interval, uint16_t sniff_attempt, uint16_t sniff_timeout){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SNIFF_MODE);
+    hci_cmd_buffer[2] = 10;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_16(hci_cmd_buffer, 5, sniff_max_interval);
+    little_endian_store_16(hci_cmd_buffer, 7, sniff_min_interval);
+    little_endian_store_16(hci_cmd_buffer, 9, sniff_attempt);
+    little_endian_store_16(hci_cmd_buffer, 11, sniff_timeout);
+    return 13;
+}
+
+/**
+ * @brief Create hci_exit_sniff_mode command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_exit_sniff_mode_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_EXIT_SNIFF_MODE);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_qos_setup command
+ * @param hci_cmd_buffer of at least 23 bytes
+ * @param handle
+ * @param flags
+ * @param service_type
+ * @param token_rate
+ * @param peak_bandwith
+ * @param latency
+ * @param delay_variation
+ * @return size of command packet
+ * @note: btstack_type H114444
+ */
+static inline uint16_t hci_qos_setup_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint8_t flags, uint8_t service_type, uint32_t token_rate, uint32_t peak_bandwith, uint32_t latency, uint32_t delay_variation){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_QOS_SETUP);
+    hci_cmd_buffer[2] = 20;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    hci_cmd_buffer[5] = flags;
+    hci_cmd_buffer[6] = service_type;
+    little_endian_store_32(hci_cmd_buffer, 7, token_rate);
+    little_endian_store_32(hci_cmd_buffer, 11, peak_bandwith);
+    little_endian_store_32(hci_cmd_buffer, 15, latency);
+    little_endian_store_32(hci_cmd_buffer, 19, delay_variation);
+    return 23;
+}
+
+/**
+ * @brief Create hci_role_discovery command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_role_discovery_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ROLE_DISCOVERY);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_switch_role_command command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param bd_addr
+ * @param role
+ * @return size of command packet
+ * @note: btstack_type B1
+ */
+static inline uint16_t hci_switch_role_command_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t role){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SWITCH_ROLE_COMMAND);
+    hci_cmd_buffer[2] = 7;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = role;
+    return 10;
+}
+
+/**
+ * @brief Create hci_read_link_policy_settings command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_link_policy_settings_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LINK_POLICY_SETTINGS);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_write_link_policy_settings command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param handle
+ * @param settings
+ * @return size of command packet
+ * @note: btstack_type H2
+ */
+static inline uint16_t hci_write_link_policy_settings_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint16_t settings){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_LINK_POLICY_SETTINGS);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_16(hci_cmd_buffer, 5, settings);
+    return 7;
+}
+
+/**
+ * @brief Create hci_write_default_link_policy_setting command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param policy
+ * @return size of command packet
+ * @note: btstack_type 2
+ */
+static inline uint16_t hci_write_default_link_policy_setting_serialize(uint8_t * hci_cmd_buffer, uint16_t policy){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_DEFAULT_LINK_POLICY_SETTING);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, policy);
+    return 5;
+}
+
+/**
+ * @brief Create hci_set_event_mask command
+ * @param hci_cmd_buffer of at least 11 bytes
+ * @param event_mask_lover_octets
+ * @param event_mask_higher_octets
+ * @return size of command packet
+ * @note: btstack_type 44
+ */
+static inline uint16_t hci_set_event_mask_serialize(uint8_t * hci_cmd_buffer, uint32_t event_mask_lover_octets, uint32_t event_mask_higher_octets){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SET_EVENT_MASK);
+    hci_cmd_buffer[2] = 8;
+    little_endian_store_32(hci_cmd_buffer, 3, event_mask_lover_octets);
+    little_endian_store_32(hci_cmd_buffer, 7, event_mask_higher_octets);
+    return 11;
+}
+
+/**
+ * @brief Create hci_reset command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_reset_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_RESET);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_flush command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_flush_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_FLUSH);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_read_pin_type command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_pin_type_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_PIN_TYPE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_pin_type command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_pin_type_serialize(uint8_t * hci_cmd_buffer, uint8_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_PIN_TYPE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = handle;
+    return 4;
+}
+
+/**
+ * @brief Create hci_delete_stored_link_key command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param bd_addr
+ * @param delete_all_flags
+ * @return size of command packet
+ * @note: btstack_type B1
+ */
+static inline uint16_t hci_delete_stored_link_key_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t bd_addr, uint8_t delete_all_flags){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_DELETE_STORED_LINK_KEY);
+    hci_cmd_buffer[2] = 7;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[3]);
+    hci_cmd_buffer[9] = delete_all_flags;
+    return 10;
+}
+
+/**
+ * @brief Create hci_write_local_name command
+ * @param hci_cmd_buffer of at least 251 bytes
+ * @param local_name
+ * @return size of command packet
+ * @note: btstack_type N
+ */
+static inline uint16_t hci_write_local_name_serialize(uint8_t * hci_cmd_buffer, const char * local_name){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_LOCAL_NAME);
+    hci_cmd_buffer[2] = 248;
+    (void)strncpy((char *) &hci_cmd_buffer[3], local_name, 248);
+    return 251;
+}
+
+/**
+ * @brief Create hci_read_local_name command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_name_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_NAME);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_page_timeout command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_page_timeout_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_PAGE_TIMEOUT);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_page_timeout command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param page_timeout
+ * @return size of command packet
+ * @note: btstack_type 2
+ */
+static inline uint16_t hci_write_page_timeout_serialize(uint8_t * hci_cmd_buffer, uint16_t page_timeout){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_PAGE_TIMEOUT);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, page_timeout);
+    return 5;
+}
+
+/**
+ * @brief Create hci_write_scan_enable command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param scan_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_scan_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t scan_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SCAN_ENABLE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = scan_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_read_page_scan_activity command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_page_scan_activity_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_PAGE_SCAN_ACTIVITY);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_page_scan_activity command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param page_scan_interval
+ * @param page_scan_window
+ * @return size of command packet
+ * @note: btstack_type 22
+ */
+static inline uint16_t hci_write_page_scan_activity_serialize(uint8_t * hci_cmd_buffer, uint16_t page_scan_interval, uint16_t page_scan_window){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_PAGE_SCAN_ACTIVITY);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, page_scan_interval);
+    little_endian_store_16(hci_cmd_buffer, 5, page_scan_window);
+    return 7;
+}
+
+/**
+ * @brief Create hci_read_inquiry_scan_activity command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_inquiry_scan_activity_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_INQUIRY_SCAN_ACTIVITY);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_inquiry_scan_activity command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param inquiry_scan_interval
+ * @param inquiry_scan_window
+ * @return size of command packet
+ * @note: btstack_type 22
+ */
+static inline uint16_t hci_write_inquiry_scan_activity_serialize(uint8_t * hci_cmd_buffer, uint16_t inquiry_scan_interval, uint16_t inquiry_scan_window){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_INQUIRY_SCAN_ACTIVITY);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, inquiry_scan_interval);
+    little_endian_store_16(hci_cmd_buffer, 5, inquiry_scan_window);
+    return 7;
+}
+
+/**
+ * @brief Create hci_write_authentication_enable command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param authentication_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_authentication_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t authentication_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_AUTHENTICATION_ENABLE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = authentication_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_write_class_of_device command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param class_of_device
+ * @return size of command packet
+ * @note: btstack_type 3
+ */
+static inline uint16_t hci_write_class_of_device_serialize(uint8_t * hci_cmd_buffer, uint32_t class_of_device){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_CLASS_OF_DEVICE);
+    hci_cmd_buffer[2] = 3;
+    little_endian_store_24(hci_cmd_buffer, 3, class_of_device);
+    return 6;
+}
+
+/**
+ * @brief Create hci_read_num_broadcast_retransmissions command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_num_broadcast_retransmissions_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_NUM_BROADCAST_RETRANSMISSIONS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_num_broadcast_retransmissions command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param num_broadcast_retransmissions
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_num_broadcast_retransmissions_serialize(uint8_t * hci_cmd_buffer, uint8_t num_broadcast_retransmissions){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_NUM_BROADCAST_RETRANSMISSIONS);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = num_broadcast_retransmissions;
+    return 4;
+}
+
+/**
+ * @brief Create hci_read_transmit_power_level command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param connection_handle
+ * @param type
+ * @return size of command packet
+ * @note: btstack_type 11
+ */
+static inline uint16_t hci_read_transmit_power_level_serialize(uint8_t * hci_cmd_buffer, uint8_t connection_handle, uint8_t type){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_TRANSMIT_POWER_LEVEL);
+    hci_cmd_buffer[2] = 2;
+    hci_cmd_buffer[3] = connection_handle;
+    hci_cmd_buffer[4] = type;
+    return 5;
+}
+
+/**
+ * @brief Create hci_write_synchronous_flow_control_enable command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param synchronous_flow_control_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_synchronous_flow_control_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t synchronous_flow_control_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SYNCHRONOUS_FLOW_CONTROL_ENABLE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = synchronous_flow_control_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_set_controller_to_host_flow_control command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param flow_control_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_set_controller_to_host_flow_control_serialize(uint8_t * hci_cmd_buffer, uint8_t flow_control_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_SET_CONTROLLER_TO_HOST_FLOW_CONTROL);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = flow_control_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_host_buffer_size command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param host_acl_data_packet_length
+ * @param host_synchronous_data_packet_length
+ * @param host_total_num_acl_data_packets
+ * @param host_total_num_synchronous_data_packets
+ * @return size of command packet
+ * @note: btstack_type 2122
+ */
+static inline uint16_t hci_host_buffer_size_serialize(uint8_t * hci_cmd_buffer, uint16_t host_acl_data_packet_length, uint8_t host_synchronous_data_packet_length, uint16_t host_total_num_acl_data_packets, uint16_t host_total_num_synchronous_data_packets){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_HOST_BUFFER_SIZE);
+    hci_cmd_buffer[2] = 7;
+    little_endian_store_16(hci_cmd_buffer, 3, host_acl_data_packet_length);
+    hci_cmd_buffer[5] = host_synchronous_data_packet_length;
+    little_endian_store_16(hci_cmd_buffer, 6, host_total_num_acl_data_packets);
+    little_endian_store_16(hci_cmd_buffer, 8, host_total_num_synchronous_data_packets);
+    return 10;
+}
+
+/**
+ * @brief Create hci_read_link_supervision_timeout command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_link_supervision_timeout_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LINK_SUPERVISION_TIMEOUT);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_write_link_supervision_timeout command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param handle
+ * @param timeout
+ * @return size of command packet
+ * @note: btstack_type H2
+ */
+static inline uint16_t hci_write_link_supervision_timeout_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint16_t timeout){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_LINK_SUPERVISION_TIMEOUT);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    little_endian_store_16(hci_cmd_buffer, 5, timeout);
+    return 7;
+}
+
+/**
+ * @brief Create hci_write_current_iac_lap_two_iacs command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param num_current_iac
+ * @param iac_lap1
+ * @param iac_lap2
+ * @return size of command packet
+ * @note: btstack_type 133
+ */
+static inline uint16_t hci_write_current_iac_lap_two_iacs_serialize(uint8_t * hci_cmd_buffer, uint8_t num_current_iac, uint32_t iac_lap1, uint32_t iac_lap2){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_CURRENT_IAC_LAP_TWO_IACS);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = num_current_iac;
+    little_endian_store_24(hci_cmd_buffer, 4, iac_lap1);
+    little_endian_store_24(hci_cmd_buffer, 7, iac_lap2);
+    return 10;
+}
+
+/**
+ * @brief Create hci_write_inquiry_mode command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param inquiry_mode
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_inquiry_mode_serialize(uint8_t * hci_cmd_buffer, uint8_t inquiry_mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_INQUIRY_MODE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = inquiry_mode;
+    return 4;
+}
+
+/**
+ * @brief Create hci_write_extended_inquiry_response command
+ * @param hci_cmd_buffer of at least 244 bytes
+ * @param fec_required
+ * @param exstended_inquiry_response
+ * @return size of command packet
+ * @note: btstack_type 1E
+ */
+static inline uint16_t hci_write_extended_inquiry_response_serialize(uint8_t * hci_cmd_buffer, uint8_t fec_required, const uint8_t * exstended_inquiry_response){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_EXTENDED_INQUIRY_RESPONSE);
+    hci_cmd_buffer[2] = 241;
+    hci_cmd_buffer[3] = fec_required;
+    (void)memcpy(&hci_cmd_buffer[4], exstended_inquiry_response, 240);
+    return 244;
+}
+
+/**
+ * @brief Create hci_write_simple_pairing_mode command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param mode
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_simple_pairing_mode_serialize(uint8_t * hci_cmd_buffer, uint8_t mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SIMPLE_PAIRING_MODE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = mode;
+    return 4;
+}
+
+/**
+ * @brief Create hci_read_local_oob_data command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_oob_data_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_OOB_DATA);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_default_erroneous_data_reporting command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param mode
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_default_erroneous_data_reporting_serialize(uint8_t * hci_cmd_buffer, uint8_t mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_DEFAULT_ERRONEOUS_DATA_REPORTING);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = mode;
+    return 4;
+}
+
+/**
+ * @brief Create hci_read_le_host_supported command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_le_host_supported_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LE_HOST_SUPPORTED);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_le_host_supported command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param le_supported_host
+ * @param simultaneous_le_host
+ * @return size of command packet
+ * @note: btstack_type 11
+ */
+static inline uint16_t hci_write_le_host_supported_serialize(uint8_t * hci_cmd_buffer, uint8_t le_supported_host, uint8_t simultaneous_le_host){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_LE_HOST_SUPPORTED);
+    hci_cmd_buffer[2] = 2;
+    hci_cmd_buffer[3] = le_supported_host;
+    hci_cmd_buffer[4] = simultaneous_le_host;
+    return 5;
+}
+
+/**
+ * @brief Create hci_write_secure_connections_host_support command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param secure_connections_host_support
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_secure_connections_host_support_serialize(uint8_t * hci_cmd_buffer, uint8_t secure_connections_host_support){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SECURE_CONNECTIONS_HOST_SUPPORT);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = secure_connections_host_support;
+    return 4;
+}
+
+/**
+ * @brief Create hci_read_local_extended_ob_data command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_extended_ob_data_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_EXTENDED_OB_DATA);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_loopback_mode command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_loopback_mode_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOOPBACK_MODE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_loopback_mode command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param loopback_mode
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_loopback_mode_serialize(uint8_t * hci_cmd_buffer, uint8_t loopback_mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_LOOPBACK_MODE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = loopback_mode;
+    return 4;
+}
+
+/**
+ * @brief Create hci_enable_device_under_test_mode command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_enable_device_under_test_mode_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_ENABLE_DEVICE_UNDER_TEST_MODE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_write_simple_pairing_debug_mode command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param simple_pairing_debug_mode
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_write_simple_pairing_debug_mode_serialize(uint8_t * hci_cmd_buffer, uint8_t simple_pairing_debug_mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SIMPLE_PAIRING_DEBUG_MODE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = simple_pairing_debug_mode;
+    return 4;
+}
+
+/**
+ * @brief Create hci_write_secure_connections_test_mode command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param handle
+ * @param dm1_acl_u_mode
+ * @param esco_loopback_mode
+ * @return size of command packet
+ * @note: btstack_type H11
+ */
+static inline uint16_t hci_write_secure_connections_test_mode_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle, uint8_t dm1_acl_u_mode, uint8_t esco_loopback_mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_WRITE_SECURE_CONNECTIONS_TEST_MODE);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    hci_cmd_buffer[5] = dm1_acl_u_mode;
+    hci_cmd_buffer[6] = esco_loopback_mode;
+    return 7;
+}
+
+/**
+ * @brief Create hci_read_local_version_information command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_version_information_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_VERSION_INFORMATION);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_local_supported_commands command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_supported_commands_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_SUPPORTED_COMMANDS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_local_supported_features command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_local_supported_features_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_LOCAL_SUPPORTED_FEATURES);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_buffer_size command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_buffer_size_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_BUFFER_SIZE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_bd_addr command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_read_bd_addr_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_BD_ADDR);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_read_rssi command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_rssi_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_RSSI);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_read_encryption_key_size command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_read_encryption_key_size_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_READ_ENCRYPTION_KEY_SIZE);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_set_event_mask command
+ * @param hci_cmd_buffer of at least 11 bytes
+ * @param event_mask_lower_octets
+ * @param event_mask_higher_octets
+ * @return size of command packet
+ * @note: btstack_type 44
+ */
+static inline uint16_t hci_le_set_event_mask_serialize(uint8_t * hci_cmd_buffer, uint32_t event_mask_lower_octets, uint32_t event_mask_higher_octets){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EVENT_MASK);
+    hci_cmd_buffer[2] = 8;
+    little_endian_store_32(hci_cmd_buffer, 3, event_mask_lower_octets);
+    little_endian_store_32(hci_cmd_buffer, 7, event_mask_higher_octets);
+    return 11;
+}
+
+/**
+ * @brief Create hci_le_read_buffer_size command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_buffer_size_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_BUFFER_SIZE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_supported_features command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_supported_features_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_SUPPORTED_FEATURES);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_set_random_address command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param random_bd_addr
+ * @return size of command packet
+ * @note: btstack_type B
+ */
+static inline uint16_t hci_le_set_random_address_serialize(uint8_t * hci_cmd_buffer, const bd_addr_t random_bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_RANDOM_ADDRESS);
+    hci_cmd_buffer[2] = 6;
+    reverse_bd_addr(random_bd_addr, &hci_cmd_buffer[3]);
+    return 9;
+}
+
+/**
+ * @brief Create hci_le_set_advertising_parameters command
+ * @param hci_cmd_buffer of at least 18 bytes
+ * @param advertising_interval_min
+ * @param advertising_interval_max
+ * @param advertising_type
+ * @param own_address_type
+ * @param direct_address_type
+ * @param direct_address
+ * @param advertising_channel_map
+ * @param advertising_filter_policy
+ * @return size of command packet
+ * @note: btstack_type 22111B11
+ */
+static inline uint16_t hci_le_set_advertising_parameters_serialize(uint8_t * hci_cmd_buffer, uint16_t advertising_interval_min, uint16_t advertising_interval_max, uint8_t advertising_type, uint8_t own_address_type, uint8_t direct_address_type, const bd_addr_t direct_address, uint8_t advertising_channel_map, uint8_t advertising_filter_policy){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_ADVERTISING_PARAMETERS);
+    hci_cmd_buffer[2] = 15;
+    little_endian_store_16(hci_cmd_buffer, 3, advertising_interval_min);
+    little_endian_store_16(hci_cmd_buffer, 5, advertising_interval_max);
+    hci_cmd_buffer[7] = advertising_type;
+    hci_cmd_buffer[8] = own_address_type;
+    hci_cmd_buffer[9] = direct_address_type;
+    reverse_bd_addr(direct_address, &hci_cmd_buffer[10]);
+    hci_cmd_buffer[16] = advertising_channel_map;
+    hci_cmd_buffer[17] = advertising_filter_policy;
+    return 18;
+}
+
+/**
+ * @brief Create hci_le_read_advertising_channel_tx_power command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_advertising_channel_tx_power_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_ADVERTISING_CHANNEL_TX_POWER);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_set_advertising_data command
+ * @param hci_cmd_buffer of at least 35 bytes
+ * @param advertising_data_length
+ * @param advertising_data
+ * @return size of command packet
+ * @note: btstack_type 1A
+ */
+static inline uint16_t hci_le_set_advertising_data_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_data_length, const uint8_t * advertising_data){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_ADVERTISING_DATA);
+    hci_cmd_buffer[2] = 32;
+    hci_cmd_buffer[3] = advertising_data_length;
+    (void)memcpy(&hci_cmd_buffer[4], advertising_data, 31);
+    return 35;
+}
+
+/**
+ * @brief Create hci_le_set_scan_response_data command
+ * @param hci_cmd_buffer of at least 35 bytes
+ * @param scan_response_data_length
+ * @param scan_response_data
+ * @return size of command packet
+ * @note: btstack_type 1A
+ */
+static inline uint16_t hci_le_set_scan_response_data_serialize(uint8_t * hci_cmd_buffer, uint8_t scan_response_data_length, const uint8_t * scan_response_data){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_SCAN_RESPONSE_DATA);
+    hci_cmd_buffer[2] = 32;
+    hci_cmd_buffer[3] = scan_response_data_length;
+    (void)memcpy(&hci_cmd_buffer[4], scan_response_data, 31);
+    return 35;
+}
+
+/**
+ * @brief Create hci_le_set_advertise_enable command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param advertise_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_le_set_advertise_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t advertise_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_ADVERTISE_ENABLE);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = advertise_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_le_set_scan_parameters command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param le_scan_type
+ * @param le_scan_interval
+ * @param le_scan_window
+ * @param own_address_type
+ * @param scanning_filter_policy
+ * @return size of command packet
+ * @note: btstack_type 12211
+ */
+static inline uint16_t hci_le_set_scan_parameters_serialize(uint8_t * hci_cmd_buffer, uint8_t le_scan_type, uint16_t le_scan_interval, uint16_t le_scan_window, uint8_t own_address_type, uint8_t scanning_filter_policy){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_SCAN_PARAMETERS);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = le_scan_type;
+    little_endian_store_16(hci_cmd_buffer, 4, le_scan_interval);
+    little_endian_store_16(hci_cmd_buffer, 6, le_scan_window);
+    hci_cmd_buffer[8] = own_address_type;
+    hci_cmd_buffer[9] = scanning_filter_policy;
+    return 10;
+}
+
+/**
+ * @brief Create hci_le_set_scan_enable command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param le_scan_enable
+ * @param filter_duplices
+ * @return size of command packet
+ * @note: btstack_type 11
+ */
+static inline uint16_t hci_le_set_scan_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t le_scan_enable, uint8_t filter_duplices){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_SCAN_ENABLE);
+    hci_cmd_buffer[2] = 2;
+    hci_cmd_buffer[3] = le_scan_enable;
+    hci_cmd_buffer[4] = filter_duplices;
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_create_connection command
+ * @param hci_cmd_buffer of at least 28 bytes
+ * @param le_scan_interval
+ * @param le_scan_window
+ * @param initiator_filter_policy
+ * @param peer_address_type
+ * @param peer_address
+ * @param own_address_type
+ * @param conn_interval_min
+ * @param conn_interval_max
+ * @param conn_latency
+ * @param supervision_timeout
+ * @param minimum_ce_length
+ * @param maximum_ce_length
+ * @return size of command packet
+ * @note: btstack_type 2211B1222222
+ */
+static inline uint16_t hci_le_create_connection_serialize(uint8_t * hci_cmd_buffer, uint16_t le_scan_interval, uint16_t le_scan_window, uint8_t initiator_filter_policy, uint8_t peer_address_type, const bd_addr_t peer_address, uint8_t own_address_type, uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency, uint16_t supervision_timeout, uint16_t minimum_ce_length, uint16_t maximum_ce_length){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CREATE_CONNECTION);
+    hci_cmd_buffer[2] = 25;
+    little_endian_store_16(hci_cmd_buffer, 3, le_scan_interval);
+    little_endian_store_16(hci_cmd_buffer, 5, le_scan_window);
+    hci_cmd_buffer[7] = initiator_filter_policy;
+    hci_cmd_buffer[8] = peer_address_type;
+    reverse_bd_addr(peer_address, &hci_cmd_buffer[9]);
+    hci_cmd_buffer[15] = own_address_type;
+    little_endian_store_16(hci_cmd_buffer, 16, conn_interval_min);
+    little_endian_store_16(hci_cmd_buffer, 18, conn_interval_max);
+    little_endian_store_16(hci_cmd_buffer, 20, conn_latency);
+    little_endian_store_16(hci_cmd_buffer, 22, supervision_timeout);
+    little_endian_store_16(hci_cmd_buffer, 24, minimum_ce_length);
+    little_endian_store_16(hci_cmd_buffer, 26, maximum_ce_length);
+    return 28;
+}
+
+/**
+ * @brief Create hci_le_create_connection_cancel command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_create_connection_cancel_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CREATE_CONNECTION_CANCEL);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_white_list_size command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_white_list_size_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_WHITE_LIST_SIZE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_clear_white_list command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_clear_white_list_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CLEAR_WHITE_LIST);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_add_device_to_white_list command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param address_type
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type 1B
+ */
+static inline uint16_t hci_le_add_device_to_white_list_serialize(uint8_t * hci_cmd_buffer, uint8_t address_type, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_ADD_DEVICE_TO_WHITE_LIST);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = address_type;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[4]);
+    return 10;
+}
+
+/**
+ * @brief Create hci_le_remove_device_from_white_list command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param address_type
+ * @param bd_addr
+ * @return size of command packet
+ * @note: btstack_type 1B
+ */
+static inline uint16_t hci_le_remove_device_from_white_list_serialize(uint8_t * hci_cmd_buffer, uint8_t address_type, const bd_addr_t bd_addr){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_REMOVE_DEVICE_FROM_WHITE_LIST);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = address_type;
+    reverse_bd_addr(bd_addr, &hci_cmd_buffer[4]);
+    return 10;
+}
+
+/**
+ * @brief Create hci_le_connection_update command
+ * @param hci_cmd_buffer of at least 17 bytes
+ * @param conn_handle
+ * @param conn_interval_min
+ * @param conn_interval_max
+ * @param conn_latency
+ * @param supervision_timeout
+ * @param minimum_ce_length
+ * @param maximum_ce_length
+ * @return size of command packet
+ * @note: btstack_type H222222
+ */
+static inline uint16_t hci_le_connection_update_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle, uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency, uint16_t supervision_timeout, uint16_t minimum_ce_length, uint16_t maximum_ce_length){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CONNECTION_UPDATE);
+    hci_cmd_buffer[2] = 14;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    little_endian_store_16(hci_cmd_buffer, 5, conn_interval_min);
+    little_endian_store_16(hci_cmd_buffer, 7, conn_interval_max);
+    little_endian_store_16(hci_cmd_buffer, 9, conn_latency);
+    little_endian_store_16(hci_cmd_buffer, 11, supervision_timeout);
+    little_endian_store_16(hci_cmd_buffer, 13, minimum_ce_length);
+    little_endian_store_16(hci_cmd_buffer, 15, maximum_ce_length);
+    return 17;
+}
+
+/**
+ * @brief Create hci_le_set_host_channel_classification command
+ * @param hci_cmd_buffer of at least 8 bytes
+ * @param channel_map_lower_32bits
+ * @param channel_map_higher_5bits
+ * @return size of command packet
+ * @note: btstack_type 41
+ */
+static inline uint16_t hci_le_set_host_channel_classification_serialize(uint8_t * hci_cmd_buffer, uint32_t channel_map_lower_32bits, uint8_t channel_map_higher_5bits){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_HOST_CHANNEL_CLASSIFICATION);
+    hci_cmd_buffer[2] = 5;
+    little_endian_store_32(hci_cmd_buffer, 3, channel_map_lower_32bits);
+    hci_cmd_buffer[7] = channel_map_higher_5bits;
+    return 8;
+}
+
+/**
+ * @brief Create hci_le_read_channel_map command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param conn_handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_le_read_channel_map_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_CHANNEL_MAP);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_read_remote_used_features command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param conn_handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_le_read_remote_used_features_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_REMOTE_USED_FEATURES);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_encrypt command
+ * @param hci_cmd_buffer of at least 35 bytes
+ * @param key
+ * @param plain_text
+ * @return size of command packet
+ * @note: btstack_type PP
+ */
+static inline uint16_t hci_le_encrypt_serialize(uint8_t * hci_cmd_buffer, const uint8_t * key, const uint8_t * plain_text){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_ENCRYPT);
+    hci_cmd_buffer[2] = 32;
+    (void)memcpy(&hci_cmd_buffer[3], key, 16);
+    (void)memcpy(&hci_cmd_buffer[19], plain_text, 16);
+    return 35;
+}
+
+/**
+ * @brief Create hci_le_rand command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_rand_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_RAND);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_start_encryption command
+ * @param hci_cmd_buffer of at least 31 bytes
+ * @param conn_handle
+ * @param random_number_lower_32bits
+ * @param random_number_higher_32bits
+ * @param encryption_diversifier
+ * @param long_term_key
+ * @return size of command packet
+ * @note: btstack_type H442P
+ */
+static inline uint16_t hci_le_start_encryption_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle, uint32_t random_number_lower_32bits, uint32_t random_number_higher_32bits, uint16_t encryption_diversifier, const uint8_t * long_term_key){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_START_ENCRYPTION);
+    hci_cmd_buffer[2] = 28;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    little_endian_store_32(hci_cmd_buffer, 5, random_number_lower_32bits);
+    little_endian_store_32(hci_cmd_buffer, 9, random_number_higher_32bits);
+    little_endian_store_16(hci_cmd_buffer, 13, encryption_diversifier);
+    (void)memcpy(&hci_cmd_buffer[15], long_term_key, 16);
+    return 31;
+}
+
+/**
+ * @brief Create hci_le_long_term_key_request_reply command
+ * @param hci_cmd_buffer of at least 21 bytes
+ * @param connection_handle
+ * @param long_term_key
+ * @return size of command packet
+ * @note: btstack_type HP
+ */
+static inline uint16_t hci_le_long_term_key_request_reply_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t connection_handle, const uint8_t * long_term_key){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_LONG_TERM_KEY_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 18;
+    little_endian_store_16(hci_cmd_buffer, 3, connection_handle);
+    (void)memcpy(&hci_cmd_buffer[5], long_term_key, 16);
+    return 21;
+}
+
+/**
+ * @brief Create hci_le_long_term_key_negative_reply command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param conn_handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_le_long_term_key_negative_reply_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_LONG_TERM_KEY_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_read_supported_states command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param conn_handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_le_read_supported_states_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_SUPPORTED_STATES);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_receiver_test command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param rx_frequency
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_le_receiver_test_serialize(uint8_t * hci_cmd_buffer, uint8_t rx_frequency){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_RECEIVER_TEST);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = rx_frequency;
+    return 4;
+}
+
+/**
+ * @brief Create hci_le_transmitter_test command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param tx_frequency
+ * @param test_payload_lengh
+ * @param packet_payload
+ * @return size of command packet
+ * @note: btstack_type 111
+ */
+static inline uint16_t hci_le_transmitter_test_serialize(uint8_t * hci_cmd_buffer, uint8_t tx_frequency, uint8_t test_payload_lengh, uint8_t packet_payload){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_TRANSMITTER_TEST);
+    hci_cmd_buffer[2] = 3;
+    hci_cmd_buffer[3] = tx_frequency;
+    hci_cmd_buffer[4] = test_payload_lengh;
+    hci_cmd_buffer[5] = packet_payload;
+    return 6;
+}
+
+/**
+ * @brief Create hci_le_test_end command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param end_test_cmd
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_le_test_end_serialize(uint8_t * hci_cmd_buffer, uint8_t end_test_cmd){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_TEST_END);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = end_test_cmd;
+    return 4;
+}
+
+/**
+ * @brief Create hci_le_remote_connection_parameter_request_reply command
+ * @param hci_cmd_buffer of at least 17 bytes
+ * @param conn_handle
+ * @param conn_interval_min
+ * @param conn_interval_max
+ * @param conn_latency
+ * @param supervision_timeout
+ * @param minimum_ce_length
+ * @param maximum_ce_length
+ * @return size of command packet
+ * @note: btstack_type H222222
+ */
+static inline uint16_t hci_le_remote_connection_parameter_request_reply_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t conn_handle, uint16_t conn_interval_min, uint16_t conn_interval_max, uint16_t conn_latency, uint16_t supervision_timeout, uint16_t minimum_ce_length, uint16_t maximum_ce_length){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_REMOTE_CONNECTION_PARAMETER_REQUEST_REPLY);
+    hci_cmd_buffer[2] = 14;
+    little_endian_store_16(hci_cmd_buffer, 3, conn_handle);
+    little_endian_store_16(hci_cmd_buffer, 5, conn_interval_min);
+    little_endian_store_16(hci_cmd_buffer, 7, conn_interval_max);
+    little_endian_store_16(hci_cmd_buffer, 9, conn_latency);
+    little_endian_store_16(hci_cmd_buffer, 11, supervision_timeout);
+    little_endian_store_16(hci_cmd_buffer, 13, minimum_ce_length);
+    little_endian_store_16(hci_cmd_buffer, 15, maximum_ce_length);
+    return 17;
+}
+
+/**
+ * @brief Create hci_le_remote_connection_parameter_request_negative_reply command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param con_handle
+ * @param reason
+ * @return size of command packet
+ * @note: btstack_type H1
+ */
+static inline uint16_t hci_le_remote_connection_parameter_request_negative_reply_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t con_handle, uint8_t reason){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_REMOTE_CONNECTION_PARAMETER_REQUEST_NEGATIVE_REPLY);
+    hci_cmd_buffer[2] = 3;
+    little_endian_store_16(hci_cmd_buffer, 3, con_handle);
+    hci_cmd_buffer[5] = reason;
+    return 6;
+}
+
+/**
+ * @brief Create hci_le_set_data_length command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param con_handle
+ * @param tx_octets
+ * @param tx_time
+ * @return size of command packet
+ * @note: btstack_type H22
+ */
+static inline uint16_t hci_le_set_data_length_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t con_handle, uint16_t tx_octets, uint16_t tx_time){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_DATA_LENGTH);
+    hci_cmd_buffer[2] = 6;
+    little_endian_store_16(hci_cmd_buffer, 3, con_handle);
+    little_endian_store_16(hci_cmd_buffer, 5, tx_octets);
+    little_endian_store_16(hci_cmd_buffer, 7, tx_time);
+    return 9;
+}
+
+/**
+ * @brief Create hci_le_read_suggested_default_data_length command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_suggested_default_data_length_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_write_suggested_default_data_length command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param suggested_max_tx_octets
+ * @param suggested_max_tx_time
+ * @return size of command packet
+ * @note: btstack_type 22
+ */
+static inline uint16_t hci_le_write_suggested_default_data_length_serialize(uint8_t * hci_cmd_buffer, uint16_t suggested_max_tx_octets, uint16_t suggested_max_tx_time){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_WRITE_SUGGESTED_DEFAULT_DATA_LENGTH);
+    hci_cmd_buffer[2] = 4;
+    little_endian_store_16(hci_cmd_buffer, 3, suggested_max_tx_octets);
+    little_endian_store_16(hci_cmd_buffer, 5, suggested_max_tx_time);
+    return 7;
+}
+
+/**
+ * @brief Create hci_le_read_local_p256_public_key command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_local_p256_public_key_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_LOCAL_P256_PUBLIC_KEY);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_generate_dhkey command
+ * @param hci_cmd_buffer of at least 67 bytes
+ * @param public_key
+ * @param private_key
+ * @return size of command packet
+ * @note: btstack_type QQ
+ */
+static inline uint16_t hci_le_generate_dhkey_serialize(uint8_t * hci_cmd_buffer, const uint8_t * public_key, const uint8_t * private_key){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_GENERATE_DHKEY);
+    hci_cmd_buffer[2] = 64;
+    reverse_bytes(public_key, &hci_cmd_buffer[3], 32);
+    reverse_bytes(private_key, &hci_cmd_buffer[35], 32);
+    return 67;
+}
+
+/**
+ * @brief Create hci_le_add_device_to_resolving_list command
+ * @param hci_cmd_buffer of at least 42 bytes
+ * @param peer_identity_address_type
+ * @param peer_identity_address
+ * @param peer_irk
+ * @param local_irk
+ * @return size of command packet
+ * @note: btstack_type 1BPP
+ */
+static inline uint16_t hci_le_add_device_to_resolving_list_serialize(uint8_t * hci_cmd_buffer, uint8_t peer_identity_address_type, const bd_addr_t peer_identity_address, const uint8_t * peer_irk, const uint8_t * local_irk){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_ADD_DEVICE_TO_RESOLVING_LIST);
+    hci_cmd_buffer[2] = 39;
+    hci_cmd_buffer[3] = peer_identity_address_type;
+    reverse_bd_addr(peer_identity_address, &hci_cmd_buffer[4]);
+    (void)memcpy(&hci_cmd_buffer[10], peer_irk, 16);
+    (void)memcpy(&hci_cmd_buffer[26], local_irk, 16);
+    return 42;
+}
+
+/**
+ * @brief Create hci_le_remove_device_from_resolving_list command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param peer_identity_address_type
+ * @param peer_identity_address
+ * @return size of command packet
+ * @note: btstack_type 1B
+ */
+static inline uint16_t hci_le_remove_device_from_resolving_list_serialize(uint8_t * hci_cmd_buffer, uint8_t peer_identity_address_type, const bd_addr_t peer_identity_address){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_REMOVE_DEVICE_FROM_RESOLVING_LIST);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = peer_identity_address_type;
+    reverse_bd_addr(peer_identity_address, &hci_cmd_buffer[4]);
+    return 10;
+}
+
+/**
+ * @brief Create hci_le_clear_resolving_list command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_clear_resolving_list_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CLEAR_RESOLVING_LIST);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_resolving_list_size command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_resolving_list_size_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_RESOLVING_LIST_SIZE);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_peer_resolvable_address command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_peer_resolvable_address_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_PEER_RESOLVABLE_ADDRESS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_local_resolvable_address command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_local_resolvable_address_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_LOCAL_RESOLVABLE_ADDRESS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_set_address_resolution_enabled command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param address_resolution_enable
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_le_set_address_resolution_enabled_serialize(uint8_t * hci_cmd_buffer, uint8_t address_resolution_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_ADDRESS_RESOLUTION_ENABLED);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = address_resolution_enable;
+    return 4;
+}
+
+/**
+ * @brief Create hci_le_set_resolvable_private_address_timeout command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param rpa_timeout
+ * @return size of command packet
+ * @note: btstack_type 2
+ */
+static inline uint16_t hci_le_set_resolvable_private_address_timeout_serialize(uint8_t * hci_cmd_buffer, uint16_t rpa_timeout){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_RESOLVABLE_PRIVATE_ADDRESS_TIMEOUT);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, rpa_timeout);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_read_maximum_data_length command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_maximum_data_length_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_MAXIMUM_DATA_LENGTH);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_phy command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param con_handle
+ * @return size of command packet
+ * @note: btstack_type H
+ */
+static inline uint16_t hci_le_read_phy_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t con_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_PHY);
+    hci_cmd_buffer[2] = 2;
+    little_endian_store_16(hci_cmd_buffer, 3, con_handle);
+    return 5;
+}
+
+/**
+ * @brief Create hci_le_set_default_phy command
+ * @param hci_cmd_buffer of at least 6 bytes
+ * @param all_phys
+ * @param tx_phys
+ * @param rx_phys
+ * @return size of command packet
+ * @note: btstack_type 111
+ */
+static inline uint16_t hci_le_set_default_phy_serialize(uint8_t * hci_cmd_buffer, uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_DEFAULT_PHY);
+    hci_cmd_buffer[2] = 3;
+    hci_cmd_buffer[3] = all_phys;
+    hci_cmd_buffer[4] = tx_phys;
+    hci_cmd_buffer[5] = rx_phys;
+    return 6;
+}
+
+/**
+ * @brief Create hci_le_set_phy command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param con_handle
+ * @param all_phys
+ * @param tx_phys
+ * @param rx_phys
+ * @param phy_options
+ * @return size of command packet
+ * @note: btstack_type H1111
+ */
+static inline uint16_t hci_le_set_phy_serialize(uint8_t * hci_cmd_buffer, hci_con_handle_t con_handle, uint8_t all_phys, uint8_t tx_phys, uint8_t rx_phys, uint8_t phy_options){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_PHY);
+    hci_cmd_buffer[2] = 6;
+    little_endian_store_16(hci_cmd_buffer, 3, con_handle);
+    hci_cmd_buffer[5] = all_phys;
+    hci_cmd_buffer[6] = tx_phys;
+    hci_cmd_buffer[7] = rx_phys;
+    hci_cmd_buffer[8] = phy_options;
+    return 9;
+}
+
+/**
+ * @brief Create hci_le_set_advertising_set_random_address command
+ * @param hci_cmd_buffer of at least 10 bytes
+ * @param advertising_handle
+ * @param advertising_random_address
+ * @return size of command packet
+ * @note: btstack_type 1B
+ */
+static inline uint16_t hci_le_set_advertising_set_random_address_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_handle, const bd_addr_t advertising_random_address){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_ADVERTISING_SET_RANDOM_ADDRESS);
+    hci_cmd_buffer[2] = 7;
+    hci_cmd_buffer[3] = advertising_handle;
+    reverse_bd_addr(advertising_random_address, &hci_cmd_buffer[4]);
+    return 10;
+}
+
+/**
+ * @brief Create hci_le_set_extended_advertising_parameters command
+ * @param hci_cmd_buffer of at least 28 bytes
+ * @param advertising_handle
+ * @param advertising_event_properties
+ * @param primary_advertising_interval_min
+ * @param primary_advertising_interval_max
+ * @param primary_advertising_channel_map
+ * @param own_address_type
+ * @param peer_address_type
+ * @param peer_address
+ * @param advertising_filter_policy
+ * @param advertising_tx_power
+ * @param primary_advertising_phy
+ * @param secondary_advertising_max_skip
+ * @param secondary_advertising_phy
+ * @param advertising_sid
+ * @param scan_request_notification_enable
+ * @return size of command packet
+ * @note: btstack_type 1233111B1111111
+ */
+static inline uint16_t hci_le_set_extended_advertising_parameters_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_handle, uint16_t advertising_event_properties, uint32_t primary_advertising_interval_min, uint32_t primary_advertising_interval_max, uint8_t primary_advertising_channel_map, uint8_t own_address_type, uint8_t peer_address_type, const bd_addr_t peer_address, uint8_t advertising_filter_policy, uint8_t advertising_tx_power, uint8_t primary_advertising_phy, uint8_t secondary_advertising_max_skip, uint8_t secondary_advertising_phy, uint8_t advertising_sid, uint8_t scan_request_notification_enable){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_PARAMETERS);
+    hci_cmd_buffer[2] = 25;
+    hci_cmd_buffer[3] = advertising_handle;
+    little_endian_store_16(hci_cmd_buffer, 4, advertising_event_properties);
+    little_endian_store_24(hci_cmd_buffer, 6, primary_advertising_interval_min);
+    little_endian_store_24(hci_cmd_buffer, 9, primary_advertising_interval_max);
+    hci_cmd_buffer[12] = primary_advertising_channel_map;
+    hci_cmd_buffer[13] = own_address_type;
+    hci_cmd_buffer[14] = peer_address_type;
+    reverse_bd_addr(peer_address, &hci_cmd_buffer[15]);
+    hci_cmd_buffer[21] = advertising_filter_policy;
+    hci_cmd_buffer[22] = advertising_tx_power;
+    hci_cmd_buffer[23] = primary_advertising_phy;
+    hci_cmd_buffer[24] = secondary_advertising_max_skip;
+    hci_cmd_buffer[25] = secondary_advertising_phy;
+    hci_cmd_buffer[26] = advertising_sid;
+    hci_cmd_buffer[27] = scan_request_notification_enable;
+    return 28;
+}
+
+/**
+ * @brief Create hci_le_set_extended_advertising_data command
+ * @param hci_cmd_buffer of at least 7 + advertising_data_length bytes
+ * @param advertising_handle
+ * @param operation
+ * @param fragment_preference
+ * @param advertising_data_length
+ * @param advertising_data
+ * @return size of command packet
+ * @note: btstack_type 1111V
+ */
+static inline uint16_t hci_le_set_extended_advertising_data_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_handle, uint8_t operation, uint8_t fragment_preference, uint8_t advertising_data_length, const uint8_t * advertising_data){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_DATA);
+    hci_cmd_buffer[2] = 4 + advertising_data_length;
+    hci_cmd_buffer[3] = advertising_handle;
+    hci_cmd_buffer[4] = operation;
+    hci_cmd_buffer[5] = fragment_preference;
+    hci_cmd_buffer[6] = advertising_data_length;
+    (void)memcpy(&hci_cmd_buffer[7], advertising_data, advertising_data_length);
+    return 7 + advertising_data_length;
+}
+
+/**
+ * @brief Create hci_le_set_extended_scan_response_data command
+ * @param hci_cmd_buffer of at least 7 + scan_response_data_length bytes
+ * @param advertising_handle
+ * @param operation
+ * @param fragment_preference
+ * @param scan_response_data_length
+ * @param scan_response_data
+ * @return size of command packet
+ * @note: btstack_type 1111V
+ */
+static inline uint16_t hci_le_set_extended_scan_response_data_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_handle, uint8_t operation, uint8_t fragment_preference, uint8_t scan_response_data_length, const uint8_t * scan_response_data){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_RESPONSE_DATA);
+    hci_cmd_buffer[2] = 4 + scan_response_data_length;
+    hci_cmd_buffer[3] = advertising_handle;
+    hci_cmd_buffer[4] = operation;
+    hci_cmd_buffer[5] = fragment_preference;
+    hci_cmd_buffer[6] = scan_response_data_length;
+    (void)memcpy(&hci_cmd_buffer[7], scan_response_data, scan_response_data_length);
+    return 7 + scan_response_data_length;
+}
+
+/**
+ * @brief Create hci_le_set_extended_advertising_enable command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param enable
+ * @param number_of_sets
+ * @param advertising_handle
+ * @param duration
+ * @param max_extended_advertising_events
+ * @return size of command packet
+ * @note: btstack_type 11121
+ */
+static inline uint16_t hci_le_set_extended_advertising_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t enable, uint8_t number_of_sets, uint8_t advertising_handle, uint16_t duration, uint8_t max_extended_advertising_events){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_ADVERTISING_ENABLE);
+    hci_cmd_buffer[2] = 6;
+    hci_cmd_buffer[3] = enable;
+    hci_cmd_buffer[4] = number_of_sets;
+    hci_cmd_buffer[5] = advertising_handle;
+    little_endian_store_16(hci_cmd_buffer, 6, duration);
+    hci_cmd_buffer[8] = max_extended_advertising_events;
+    return 9;
+}
+
+/**
+ * @brief Create hci_le_read_maximum_advertising_data_length command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_maximum_advertising_data_length_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_read_number_of_supported_advertising_sets command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_read_number_of_supported_advertising_sets_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_remove_advertising_set command
+ * @param hci_cmd_buffer of at least 4 bytes
+ * @param advertising_handle
+ * @return size of command packet
+ * @note: btstack_type 1
+ */
+static inline uint16_t hci_le_remove_advertising_set_serialize(uint8_t * hci_cmd_buffer, uint8_t advertising_handle){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_REMOVE_ADVERTISING_SET);
+    hci_cmd_buffer[2] = 1;
+    hci_cmd_buffer[3] = advertising_handle;
+    return 4;
+}
+
+/**
+ * @brief Create hci_le_clear_advertising_sets command
+ * @param hci_cmd_buffer of at least 3 bytes
+ * @return size of command packet
+ * @note: btstack_type 
+ */
+static inline uint16_t hci_le_clear_advertising_sets_serialize(uint8_t * hci_cmd_buffer){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_CLEAR_ADVERTISING_SETS);
+    hci_cmd_buffer[2] = 0;
+    return 3;
+}
+
+/**
+ * @brief Create hci_le_set_extended_scan_enable command
+ * @param hci_cmd_buffer of at least 9 bytes
+ * @param enable
+ * @param filter_duplicates
+ * @param duration
+ * @param period
+ * @return size of command packet
+ * @note: btstack_type 1122
+ */
+static inline uint16_t hci_le_set_extended_scan_enable_serialize(uint8_t * hci_cmd_buffer, uint8_t enable, uint8_t filter_duplicates, uint16_t duration, uint16_t period){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_LE_SET_EXTENDED_SCAN_ENABLE);
+    hci_cmd_buffer[2] = 6;
+    hci_cmd_buffer[3] = enable;
+    hci_cmd_buffer[4] = filter_duplicates;
+    little_endian_store_16(hci_cmd_buffer, 5, duration);
+    little_endian_store_16(hci_cmd_buffer, 7, period);
+    return 9;
+}
+
+/**
+ * @brief Create hci_bcm_write_sco_pcm_int command
+ * @param hci_cmd_buffer of at least 8 bytes
+ * @param sco_routing
+ * @param pcm_interface_rate
+ * @param frame_type
+ * @param sync_mode
+ * @param clock_mode
+ * @return size of command packet
+ * @note: btstack_type 11111
+ */
+static inline uint16_t hci_bcm_write_sco_pcm_int_serialize(uint8_t * hci_cmd_buffer, uint8_t sco_routing, uint8_t pcm_interface_rate, uint8_t frame_type, uint8_t sync_mode, uint8_t clock_mode){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_BCM_WRITE_SCO_PCM_INT);
+    hci_cmd_buffer[2] = 5;
+    hci_cmd_buffer[3] = sco_routing;
+    hci_cmd_buffer[4] = pcm_interface_rate;
+    hci_cmd_buffer[5] = frame_type;
+    hci_cmd_buffer[6] = sync_mode;
+    hci_cmd_buffer[7] = clock_mode;
+    return 8;
+}
+
+/**
+ * @brief Create hci_bcm_set_sleep_mode command
+ * @param hci_cmd_buffer of at least 15 bytes
+ * @param sleep_mode
+ * @param idle_threshold_host
+ * @param idle_threshold_controller
+ * @param bt_wake_active_mode
+ * @param host_wake_active_mode
+ * @param allow_host_sleep_during_sco
+ * @param combine_sleep_mode_and_lpm
+ * @param enable_tristate_control_of_uart_tx_line
+ * @param active_connection_handling_on_suspend
+ * @param resume_timeout
+ * @param enable_break_to_host
+ * @param pulsed_host_wake
+ * @return size of command packet
+ * @note: btstack_type 111111111111
+ */
+static inline uint16_t hci_bcm_set_sleep_mode_serialize(uint8_t * hci_cmd_buffer, uint8_t sleep_mode, uint8_t idle_threshold_host, uint8_t idle_threshold_controller, uint8_t bt_wake_active_mode, uint8_t host_wake_active_mode, uint8_t allow_host_sleep_during_sco, uint8_t combine_sleep_mode_and_lpm, uint8_t enable_tristate_control_of_uart_tx_line, uint8_t active_connection_handling_on_suspend, uint8_t resume_timeout, uint8_t enable_break_to_host, uint8_t pulsed_host_wake){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_BCM_SET_SLEEP_MODE);
+    hci_cmd_buffer[2] = 12;
+    hci_cmd_buffer[3] = sleep_mode;
+    hci_cmd_buffer[4] = idle_threshold_host;
+    hci_cmd_buffer[5] = idle_threshold_controller;
+    hci_cmd_buffer[6] = bt_wake_active_mode;
+    hci_cmd_buffer[7] = host_wake_active_mode;
+    hci_cmd_buffer[8] = allow_host_sleep_during_sco;
+    hci_cmd_buffer[9] = combine_sleep_mode_and_lpm;
+    hci_cmd_buffer[10] = enable_tristate_control_of_uart_tx_line;
+    hci_cmd_buffer[11] = active_connection_handling_on_suspend;
+    hci_cmd_buffer[12] = resume_timeout;
+    hci_cmd_buffer[13] = enable_break_to_host;
+    hci_cmd_buffer[14] = pulsed_host_wake;
+    return 15;
+}
+
+/**
+ * @brief Create hci_bcm_write_tx_power_table command
+ * @param hci_cmd_buffer of at least 5 bytes
+ * @param is_le
+ * @param chip_max_tx_pwr_db
+ * @return size of command packet
+ * @note: btstack_type 11
+ */
+static inline uint16_t hci_bcm_write_tx_power_table_serialize(uint8_t * hci_cmd_buffer, uint8_t is_le, uint8_t chip_max_tx_pwr_db){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_BCM_WRITE_TX_POWER_TABLE);
+    hci_cmd_buffer[2] = 2;
+    hci_cmd_buffer[3] = is_le;
+    hci_cmd_buffer[4] = chip_max_tx_pwr_db;
+    return 5;
+}
+
+/**
+ * @brief Create hci_bcm_set_tx_pwr command
+ * @param hci_cmd_buffer of at least 7 bytes
+ * @param arg1
+ * @param arg2
+ * @param arg3
+ * @return size of command packet
+ * @note: btstack_type 11H
+ */
+static inline uint16_t hci_bcm_set_tx_pwr_serialize(uint8_t * hci_cmd_buffer, uint8_t arg1, uint8_t arg2, hci_con_handle_t arg3){
+    little_endian_store_16(hci_cmd_buffer, 0, HCI_OPCODE_HCI_BCM_SET_TX_PWR);
+    hci_cmd_buffer[2] = 4;
+    hci_cmd_buffer[3] = arg1;
+    hci_cmd_buffer[4] = arg2;
+    little_endian_store_16(hci_cmd_buffer, 5, arg3);
+    return 7;
+}
+
+/**
+ * @brief Create hci_ti_drpb_tester_con_tx command
+ * @param hci_cmd_buffer of at least 15 bytes
+ * @param modulation
+ * @param test_patern
+ * @param frequency
+ * @param power_level
+ * @param reserved1
+ * @param reserved2
+ * @return size of command packet
+ * @note: btstack_type 111144
+ */
+static inline uint16_t hci_ti_drpb_tester_con_tx_serialize(uint8_t * hci_cmd_buffer, uint8_t modulation, uint8_t test_patern, uint8_t frequency, uint8_t power_level, uint32_t reserved1, uint32_t reserved2){
+    little_endian_store_16(hci_cmd_buffer, 0, 0xFD84);
+    hci_cmd_buffer[2] = 12;
+    hci_cmd_buffer[3] = modulation;
+    hci_cmd_buffer[4] = test_patern;
+    hci_cmd_buffer[5] = frequency;
+    hci_cmd_buffer[6] = power_level;
+    little_endian_store_32(hci_cmd_buffer, 7, reserved1);
+    little_endian_store_32(hci_cmd_buffer, 11, reserved2);
+    return 15;
+}
+
+/**
+ * @brief Create hci_ti_drpb_tester_packet_tx_rx command
+ * @param hci_cmd_buffer of at least 15 bytes
+ * @param arg1
+ * @param arg2
+ * @param arg3
+ * @param arg4
+ * @param arg5
+ * @param arg6
+ * @param arg7
+ * @param arg8
+ * @param arg9
+ * @param arg10
+ * @return size of command packet
+ * @note: btstack_type 1111112112
+ */
+static inline uint16_t hci_ti_drpb_tester_packet_tx_rx_serialize(uint8_t * hci_cmd_buffer, uint8_t arg1, uint8_t arg2, uint8_t arg3, uint8_t arg4, uint8_t arg5, uint8_t arg6, uint16_t arg7, uint8_t arg8, uint8_t arg9, uint16_t arg10){
+    little_endian_store_16(hci_cmd_buffer, 0, 0xFD85);
+    hci_cmd_buffer[2] = 12;
+    hci_cmd_buffer[3] = arg1;
+    hci_cmd_buffer[4] = arg2;
+    hci_cmd_buffer[5] = arg3;
+    hci_cmd_buffer[6] = arg4;
+    hci_cmd_buffer[7] = arg5;
+    hci_cmd_buffer[8] = arg6;
+    little_endian_store_16(hci_cmd_buffer, 9, arg7);
+    hci_cmd_buffer[11] = arg8;
+    hci_cmd_buffer[12] = arg9;
+    little_endian_store_16(hci_cmd_buffer, 13, arg10);
+    return 15;
+}
+
+
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // HCI_CMD_SERIALIZER_H
@@ -46,6 +46,11 @@
  *  - Apple's PacketLogger
  *  - stdout hexdump
  *
+ *  With ENABLE_HCI_DUMP_ASYNC_WRITER, binary formats are copied into a ring buffer
+ *  and written to the file by a separate thread.
+ *
+ *  With hci_dump_set_rotation, binary formats are written to a set of rotating files.
+ *
  */
 
 #include "btstack_config.h"
@@ -66,6 +71,35 @@
 #include <time.h>
 #include <sys/time.h>     // for timestamps
 #include <sys/stat.h>     // for mode flags
+#include <stdbool.h>
+#include <string.h>
+
+// max path length of packet log file incl. segment number for rotation
+#ifndef HCI_DUMP_PATH_MAX_LEN
+#define HCI_DUMP_PATH_MAX_LEN 256
+#endif
+
+// write buffer used with rotation
+#ifndef HCI_DUMP_WRITE_BUFFER_SIZE
+#define HCI_DUMP_WRITE_BUFFER_SIZE 4096
+#endif
+#endif
+
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+#ifndef HAVE_POSIX_FILE_IO
+#error "ENABLE_HCI_DUMP_ASYNC_WRITER requires HAVE_POSIX_FILE_IO"
+#endif
+#include <errno.h>
+#include <pthread.h>
+#include <sys/uio.h>      // writev
+
+// ring buffer size, must be a power of two
+#ifndef HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE
+#define HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE 65536
+#endif
+#if (HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE & (HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - 1)) != 0
+#error "HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE must be a power of two"
+#endif
 #endif
 
 #ifdef ENABLE_SEGGER_RTT
@@ -114,15 +148,391 @@ static int dump_format;
 static char time_string[40];
 static int  max_nr_packets = -1;
 static int  nr_packets = 0;
+
+// rotation, segment_max_size = 0 if not used
+static char     dump_file_path[HCI_DUMP_PATH_MAX_LEN];
+static uint32_t segment_max_size;
+static uint16_t segment_count;
+static uint32_t segment_size;
+static bool     flush_on_error;
+static uint8_t  write_buffer[HCI_DUMP_WRITE_BUFFER_SIZE];
+static uint16_t write_buffer_len;
 #endif
 
 #if defined(HAVE_POSIX_FILE_IO) || defined (ENABLE_SEGGER_RTT)
 static char log_message_buffer[256];
 #endif
 
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+// single producer (run loop thread) / single consumer (writer thread) ring buffer
+// head and tail are free running, only the producer updates head, only the writer updates tail
+static uint8_t   async_buffer[HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE];
+static uint32_t  async_head;
+static uint32_t  async_tail;
+// file truncation or rotation requested by producer, executed by writer once data up to position is written
+typedef enum {
+    HCI_DUMP_ASYNC_FILE_ACTION_NONE = 0,
+    HCI_DUMP_ASYNC_FILE_ACTION_TRUNCATE,
+    HCI_DUMP_ASYNC_FILE_ACTION_ROTATE,
+} hci_dump_async_file_action_t;
+static uint32_t  async_file_action_position;
+static int       async_file_action;
+static int       async_writer_stop;
+static int       async_writer_running;
+static pthread_t async_writer_thread;
+// writer thread waits for data, producer only signals if writer is waiting
+static pthread_mutex_t async_writer_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  async_writer_cond  = PTHREAD_COND_INITIALIZER;
+static int       async_writer_waiting;
+// file used by writer thread, as rotation replaces it
+static int       async_file;
+// producer waits for writer in hci_dump_flush
+static pthread_cond_t  async_flush_cond   = PTHREAD_COND_INITIALIZER;
+static int       async_flush_waiting;
+// packets dropped since last report in packet log
+static uint32_t  async_dropped_unreported;
+static hci_dump_async_writer_stats_t async_stats;
+#endif
+
 // levels: debug, info, error
 static int log_level_enabled[3] = { 1, 1, 1};
 
+static void hci_dump_packetlogger_setup_header(uint8_t * buffer, uint32_t tv_sec, uint32_t tv_us, uint8_t packet_type, uint8_t in, uint16_t len){
+    big_endian_store_32( buffer, 0, PKTLOG_HDR_SIZE - 4 + len);
+    big_endian_store_32( buffer, 4, tv_sec);
+    big_endian_store_32( buffer, 8, tv_us);
+    uint8_t packet_logger_type = 0;
+    switch (packet_type){
+        case HCI_COMMAND_DATA_PACKET:
+            packet_logger_type = 0x00;
+            break;
+        case HCI_ACL_DATA_PACKET:
+            packet_logger_type = in ? 0x03 : 0x02;
+            break;
+        case HCI_SCO_DATA_PACKET:
+            packet_logger_type = in ? 0x09 : 0x08;
+            break;
+        case HCI_EVENT_PACKET:
+            packet_logger_type = 0x01;
+            break;
+        case LOG_MESSAGE_PACKET:
+            packet_logger_type = 0xfc;
+            break;
+        default:
+            return;
+    }
+    buffer[12] = packet_logger_type;
+}
+
+static void hci_dump_bluez_setup_header(uint8_t * buffer, uint32_t tv_sec, uint32_t tv_us, uint8_t packet_type, uint8_t in, uint16_t len){
+    little_endian_store_16( buffer, 0u, 1u + len);
+    buffer[2] = in;
+    buffer[3] = 0;
+    little_endian_store_32( buffer, 4, tv_sec);
+    little_endian_store_32( buffer, 8, tv_us);
+    buffer[12] = packet_type;
+}
+
+#ifdef HAVE_POSIX_FILE_IO
+static int hci_dump_open_file(const char * path){
+    int oflags = O_WRONLY | O_CREAT | O_TRUNC;
+#ifdef _WIN32
+    oflags |= O_BINARY;
+#endif
+    return open(path, oflags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+}
+
+// segment 0 is the path given to hci_dump_open, older segments get their index inserted before the extension
+static void hci_dump_segment_path(char * buffer, uint16_t size, uint16_t index){
+    if (index == 0){
+        snprintf(buffer, size, "%s", dump_file_path);
+        return;
+    }
+    const char * extension = strrchr(dump_file_path, '.');
+    const char * separator = strrchr(dump_file_path, '/');
+    if ((extension == NULL) || (extension == dump_file_path) || ((separator != NULL) && (extension < separator))){
+        snprintf(buffer, size, "%s.%u", dump_file_path, index);
+    } else {
+        snprintf(buffer, size, "%.*s.%u%s", (int) (extension - dump_file_path), dump_file_path, index, extension);
+    }
+}
+
+// close current segment and open a new one, returns file descriptor of new segment
+static int hci_dump_rotate_segments(int file){
+    char path_old[HCI_DUMP_PATH_MAX_LEN];
+    char path_new[HCI_DUMP_PATH_MAX_LEN];
+    close(file);
+    // oldest segment gets overwritten
+    uint16_t index;
+    for (index = segment_count - 1u; index > 0u; index--){
+        hci_dump_segment_path(path_old, sizeof(path_old), index - 1u);
+        hci_dump_segment_path(path_new, sizeof(path_new), index);
+        // old segment might not exist yet
+        (void) rename(path_old, path_new);
+    }
+    file = hci_dump_open_file(dump_file_path);
+    if (file < 0){
+        printf("hci_dump: failed to open file %s\n", dump_file_path);
+    }
+    return file;
+}
+
+// returns true if record doesn't fit into current segment
+static bool hci_dump_segment_full(uint32_t record_len){
+    if (segment_max_size == 0u) return false;
+    if (segment_size == 0u) return false;
+    return (segment_size + record_len) > segment_max_size;
+}
+
+static void hci_dump_write_buffer_flush(void){
+    if (write_buffer_len == 0u) return;
+    // avoid -Wunused-result
+    int res = write(dump_file, write_buffer, write_buffer_len);
+    UNUSED(res);
+    write_buffer_len = 0;
+}
+
+static void hci_dump_write_buffered(const uint8_t * data, uint16_t len){
+    if ((write_buffer_len + len) > HCI_DUMP_WRITE_BUFFER_SIZE){
+        hci_dump_write_buffer_flush();
+    }
+    if (len > HCI_DUMP_WRITE_BUFFER_SIZE){
+        int res = write(dump_file, data, len);
+        UNUSED(res);
+        return;
+    }
+    (void) memcpy(&write_buffer[write_buffer_len], data, len);
+    write_buffer_len += len;
+}
+
+static void hci_dump_posix_write(const uint8_t * header, uint16_t header_len, const uint8_t * packet, uint16_t len){
+    if (segment_max_size == 0u){
+        // avoid -Wunused-result
+        int res = 0;
+        res = write (dump_file, header, header_len);
+        res = write (dump_file, packet, len );
+        UNUSED(res);
+        return;
+    }
+    uint32_t record_len = header_len + len;
+    if (hci_dump_segment_full(record_len)){
+        hci_dump_write_buffer_flush();
+        dump_file = hci_dump_rotate_segments(dump_file);
+        segment_size = 0;
+        if (dump_file < 0) return;
+    }
+    hci_dump_write_buffered(header, header_len);
+    hci_dump_write_buffered(packet, len);
+    segment_size += record_len;
+}
+#endif
+
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+
+static void hci_dump_async_writer_write(uint32_t tail, uint32_t head){
+    while (tail != head){
+        uint32_t offset = tail & (HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - 1);
+        uint32_t len    = head - tail;
+        struct iovec iov[2];
+        int iovcnt = 1;
+        iov[0].iov_base = &async_buffer[offset];
+        if ((offset + len) > HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE){
+            // wrap around
+            iov[0].iov_len  = HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - offset;
+            iov[1].iov_base = &async_buffer[0];
+            iov[1].iov_len  = len - iov[0].iov_len;
+            iovcnt = 2;
+        } else {
+            iov[0].iov_len  = len;
+        }
+        ssize_t res = writev(async_file, iov, iovcnt);
+        if ((res < 0) && (errno == EINTR)) continue;
+        __atomic_add_fetch(&async_stats.num_writes, 1, __ATOMIC_RELAXED);
+        if (res <= 0){
+            // drop data instead of blocking the producer forever
+            __atomic_add_fetch(&async_stats.num_write_errors, 1, __ATOMIC_RELAXED);
+            res = len;
+        }
+        tail += (uint32_t) res;
+        // release space to producer
+        __atomic_store_n(&async_tail, tail, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&async_flush_waiting, __ATOMIC_SEQ_CST) != 0){
+            pthread_mutex_lock(&async_writer_mutex);
+            pthread_cond_signal(&async_flush_cond);
+            pthread_mutex_unlock(&async_writer_mutex);
+        }
+    }
+}
+
+static void hci_dump_async_writer_flush(void){
+    uint32_t tail = async_tail;
+    // head is loaded before the file action: if the action was requested meanwhile, its position is not before head,
+    // otherwise it is handled in the next flush with tail not beyond its position
+    uint32_t head = __atomic_load_n(&async_head, __ATOMIC_SEQ_CST);
+    int action = __atomic_load_n(&async_file_action, __ATOMIC_ACQUIRE);
+    if (action != HCI_DUMP_ASYNC_FILE_ACTION_NONE){
+        // write data logged before request, then truncate or rotate
+        uint32_t position = async_file_action_position;
+        hci_dump_async_writer_write(tail, position);
+        tail = position;
+        if (action == HCI_DUMP_ASYNC_FILE_ACTION_ROTATE){
+            async_file = hci_dump_rotate_segments(async_file);
+        } else {
+            lseek(async_file, 0, SEEK_SET);
+            // avoid -Wunused-result
+            int res = ftruncate(async_file, 0);
+            UNUSED(res);
+        }
+        __atomic_store_n(&async_file_action, HCI_DUMP_ASYNC_FILE_ACTION_NONE, __ATOMIC_RELEASE);
+        // data published after the request goes into the new segment
+        head = __atomic_load_n(&async_head, __ATOMIC_SEQ_CST);
+    }
+    hci_dump_async_writer_write(tail, head);
+}
+
+static bool hci_dump_async_writer_idle(void){
+    if (__atomic_load_n(&async_writer_stop, __ATOMIC_ACQUIRE) != 0) return false;
+    if (__atomic_load_n(&async_file_action, __ATOMIC_ACQUIRE) != HCI_DUMP_ASYNC_FILE_ACTION_NONE) return false;
+    return __atomic_load_n(&async_head, __ATOMIC_SEQ_CST) == async_tail;
+}
+
+static void hci_dump_async_writer_wait(void){
+    pthread_mutex_lock(&async_writer_mutex);
+    // announce waiting before checking for data, producer checks the flag after publishing data
+    __atomic_store_n(&async_writer_waiting, 1, __ATOMIC_SEQ_CST);
+    while (hci_dump_async_writer_idle()){
+        pthread_cond_wait(&async_writer_cond, &async_writer_mutex);
+    }
+    __atomic_store_n(&async_writer_waiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&async_writer_mutex);
+}
+
+static void hci_dump_async_writer_signal(void){
+    if (__atomic_load_n(&async_writer_waiting, __ATOMIC_SEQ_CST) == 0) return;
+    pthread_mutex_lock(&async_writer_mutex);
+    pthread_cond_signal(&async_writer_cond);
+    pthread_mutex_unlock(&async_writer_mutex);
+}
+
+static void * hci_dump_async_writer_main(void * context){
+    UNUSED(context);
+    while (__atomic_load_n(&async_writer_stop, __ATOMIC_ACQUIRE) == 0){
+        hci_dump_async_writer_wait();
+        hci_dump_async_writer_flush();
+    }
+    // drain remaining data
+    hci_dump_async_writer_flush();
+    return NULL;
+}
+
+static void hci_dump_async_writer_start(void){
+    async_head = 0;
+    async_tail = 0;
+    async_file_action = HCI_DUMP_ASYNC_FILE_ACTION_NONE;
+    async_writer_stop = 0;
+    async_writer_waiting = 0;
+    async_flush_waiting = 0;
+    async_file = dump_file;
+    async_dropped_unreported = 0;
+    memset(&async_stats, 0, sizeof(async_stats));
+    if (pthread_create(&async_writer_thread, NULL, &hci_dump_async_writer_main, NULL) != 0){
+        printf("hci_dump_open: failed to start writer thread, using synchronous writes\n");
+        return;
+    }
+    async_writer_running = 1;
+}
+
+static void hci_dump_async_writer_stop(void){
+    if (!async_writer_running) return;
+    __atomic_store_n(&async_writer_stop, 1, __ATOMIC_SEQ_CST);
+    hci_dump_async_writer_signal();
+    pthread_join(async_writer_thread, NULL);
+    async_writer_running = 0;
+    dump_file = async_file;
+}
+
+// wait until writer thread has written all published packets
+static void hci_dump_async_writer_flush_wait(void){
+    uint32_t head = async_head;
+    pthread_mutex_lock(&async_writer_mutex);
+    // announce waiting before checking tail, writer checks the flag after updating tail
+    __atomic_store_n(&async_flush_waiting, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&async_tail, __ATOMIC_SEQ_CST) != head){
+        pthread_cond_wait(&async_flush_cond, &async_writer_mutex);
+    }
+    __atomic_store_n(&async_flush_waiting, 0, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&async_writer_mutex);
+}
+
+// store header and packet as a single record, returns false if ring buffer is full
+static bool hci_dump_async_writer_store(const uint8_t * header, uint16_t header_len, const uint8_t * packet, uint16_t len){
+    uint32_t head = async_head;
+    uint32_t tail = __atomic_load_n(&async_tail, __ATOMIC_ACQUIRE);
+    uint32_t free_space = HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - (head - tail);
+    uint32_t record_len = (uint32_t) header_len + len;
+    if (record_len > free_space) return false;
+    // let writer rotate before this record, continue current segment if previous request is still pending
+    if (hci_dump_segment_full(record_len) && (__atomic_load_n(&async_file_action, __ATOMIC_ACQUIRE) == HCI_DUMP_ASYNC_FILE_ACTION_NONE)){
+        async_file_action_position = head;
+        __atomic_store_n(&async_file_action, HCI_DUMP_ASYNC_FILE_ACTION_ROTATE, __ATOMIC_SEQ_CST);
+        segment_size = 0;
+    }
+    segment_size += record_len;
+    const uint8_t * chunks[2]   = { header, packet };
+    const uint16_t  chunk_len[2] = { header_len, len };
+    int i;
+    for (i=0;i<2;i++){
+        uint32_t offset = head & (HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - 1);
+        uint32_t first  = btstack_min(chunk_len[i], HCI_DUMP_ASYNC_WRITER_BUFFER_SIZE - offset);
+        memcpy(&async_buffer[offset], chunks[i], first);
+        memcpy(&async_buffer[0], &chunks[i][first], chunk_len[i] - first);
+        head += chunk_len[i];
+    }
+    // publish record to writer
+    __atomic_store_n(&async_head, head, __ATOMIC_SEQ_CST);
+    hci_dump_async_writer_signal();
+    return true;
+}
+
+static void hci_dump_async_writer_packet(uint32_t tv_sec, uint32_t tv_us, const uint8_t * header, uint16_t header_len, const uint8_t * packet, uint16_t len){
+    if (async_dropped_unreported > 0){
+        // try to note dropped packets in packet log first
+        char note[48];
+        uint8_t note_header[PKTLOG_HDR_SIZE];
+        int note_len = snprintf(note, sizeof(note), "hci_dump: %u packet(s) dropped", (unsigned int) async_dropped_unreported);
+        if (dump_format == HCI_DUMP_BLUEZ){
+            hci_dump_bluez_setup_header(note_header, tv_sec, tv_us, LOG_MESSAGE_PACKET, 0, note_len);
+        } else {
+            hci_dump_packetlogger_setup_header(note_header, tv_sec, tv_us, LOG_MESSAGE_PACKET, 0, note_len);
+        }
+        if (!hci_dump_async_writer_store(note_header, header_len, (const uint8_t *) note, note_len)) {
+            async_dropped_unreported++;
+            async_stats.packets_dropped++;
+            async_stats.bytes_dropped += header_len + len;
+            return;
+        }
+        async_dropped_unreported = 0;
+    }
+    if (hci_dump_async_writer_store(header, header_len, packet, len)){
+        async_stats.packets_queued++;
+        async_stats.bytes_queued += header_len + len;
+    } else {
+        async_dropped_unreported++;
+        async_stats.packets_dropped++;
+        async_stats.bytes_dropped += header_len + len;
+    }
+}
+
+void hci_dump_get_async_writer_stats(hci_dump_async_writer_stats_t * stats){
+    stats->packets_queued   = async_stats.packets_queued;
+    stats->bytes_queued     = async_stats.bytes_queued;
+    stats->packets_dropped  = async_stats.packets_dropped;
+    stats->bytes_dropped    = async_stats.bytes_dropped;
+    stats->num_writes       = __atomic_load_n(&async_stats.num_writes, __ATOMIC_RELAXED);
+    stats->num_write_errors = __atomic_load_n(&async_stats.num_write_errors, __ATOMIC_RELAXED);
+}
+#endif
+
 void hci_dump_open(const char *filename, hci_dump_format_t format){
 
     dump_format = format;
@@ -132,14 +542,23 @@ void hci_dump_open(const char *filename, hci_dump_format_t format){
         dump_file = fileno(stdout);
     } else {
 
-        int oflags = O_WRONLY | O_CREAT | O_TRUNC;
-#ifdef _WIN32
-        oflags |= O_BINARY;
-#endif
-        dump_file = open(filename, oflags, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH );
+        if ((segment_max_size > 0u) && (strlen(filename) >= (sizeof(dump_file_path) - 6u))){
+            // no space for segment number
+            printf("hci_dump_open: path too long for segment names, rotation disabled (HCI_DUMP_PATH_MAX_LEN %u)\n", HCI_DUMP_PATH_MAX_LEN);
+            segment_max_size = 0;
+        }
+        snprintf(dump_file_path, sizeof(dump_file_path), "%s", filename);
+        segment_size = 0;
+        write_buffer_len = 0;
+        dump_file = hci_dump_open_file(filename);
         if (dump_file < 0){
             printf("hci_dump_open: failed to open file %s\n", filename);
         }
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+        if ((dump_file >= 0) && !async_writer_running){
+            hci_dump_async_writer_start();
+        }
+#endif
     }
 #else
 
@@ -164,43 +583,30 @@ void hci_dump_open(const char *filename, hci_dump_format_t format){
 void hci_dump_set_max_packets(int packets){
     max_nr_packets = packets;
 }
-#endif
 
-static void hci_dump_packetlogger_setup_header(uint8_t * buffer, uint32_t tv_sec, uint32_t tv_us, uint8_t packet_type, uint8_t in, uint16_t len){
-    big_endian_store_32( buffer, 0, PKTLOG_HDR_SIZE - 4 + len);
-    big_endian_store_32( buffer, 4, tv_sec);
-    big_endian_store_32( buffer, 8, tv_us);
-    uint8_t packet_logger_type = 0;
-    switch (packet_type){
-        case HCI_COMMAND_DATA_PACKET:
-            packet_logger_type = 0x00;
-            break;
-        case HCI_ACL_DATA_PACKET:
-            packet_logger_type = in ? 0x03 : 0x02;
-            break;
-        case HCI_SCO_DATA_PACKET:
-            packet_logger_type = in ? 0x09 : 0x08;
-            break;
-        case HCI_EVENT_PACKET:
-            packet_logger_type = 0x01;
-            break;
-        case LOG_MESSAGE_PACKET:
-            packet_logger_type = 0xfc;
-            break;
-        default:
-            return;
+void hci_dump_set_rotation(uint32_t segment_size_max, uint16_t num_segments){
+    if (num_segments < 2u){
+        segment_size_max = 0;
     }
-    buffer[12] = packet_logger_type;
+    segment_max_size = segment_size_max;
+    segment_count    = num_segments;
 }
 
-static void hci_dump_bluez_setup_header(uint8_t * buffer, uint32_t tv_sec, uint32_t tv_us, uint8_t packet_type, uint8_t in, uint16_t len){
-    little_endian_store_16( buffer, 0u, 1u + len);
-    buffer[2] = in;
-    buffer[3] = 0;
-    little_endian_store_32( buffer, 4, tv_sec);
-    little_endian_store_32( buffer, 8, tv_us);
-    buffer[12] = packet_type;
+void hci_dump_set_flush_on_error(int enable){
+    flush_on_error = enable != 0;
+}
+
+void hci_dump_flush(void){
+    if (dump_file < 0) return;
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+    if (async_writer_running){
+        hci_dump_async_writer_flush_wait();
+        return;
+    }
+#endif
+    hci_dump_write_buffer_flush();
 }
+#endif
 
 static void printf_packet(uint8_t packet_type, uint8_t in, uint8_t * packet, uint16_t len){
     switch (packet_type){
@@ -272,14 +678,26 @@ void hci_dump_packet(uint8_t packet_type, uint8_t in, uint8_t *packet, uint16_t
     if (dump_file < 0) return; // not activated yet
 
 #ifdef HAVE_POSIX_FILE_IO
-    // don't grow bigger than max_nr_packets
-    if (dump_format != HCI_DUMP_STDOUT && max_nr_packets > 0){
+    // don't grow bigger than max_nr_packets, unless rotation is used
+    if (dump_format != HCI_DUMP_STDOUT && max_nr_packets > 0 && segment_max_size == 0u){
         if (nr_packets >= max_nr_packets){
-            lseek(dump_file, 0, SEEK_SET);
-            // avoid -Wunused-result
-            int res = ftruncate(dump_file, 0);
-            UNUSED(res);
-            nr_packets = 0;
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+            if (async_writer_running){
+                // let writer truncate file after pending data was written, retry with next packet if busy
+                if (__atomic_load_n(&async_file_action, __ATOMIC_ACQUIRE) == HCI_DUMP_ASYNC_FILE_ACTION_NONE){
+                    async_file_action_position = async_head;
+                    __atomic_store_n(&async_file_action, HCI_DUMP_ASYNC_FILE_ACTION_TRUNCATE, __ATOMIC_SEQ_CST);
+                    nr_packets = 0;
+                }
+            } else
+#endif
+            {
+                lseek(dump_file, 0, SEEK_SET);
+                // avoid -Wunused-result
+                int res = ftruncate(dump_file, 0);
+                UNUSED(res);
+                nr_packets = 0;
+            }
         }
         nr_packets++;
     }
@@ -337,11 +755,17 @@ void hci_dump_packet(uint8_t packet_type, uint8_t in, uint8_t *packet, uint16_t
     }
 
 #ifdef HAVE_POSIX_FILE_IO
-    // avoid -Wunused-result
-    int res = 0;
-    res = write (dump_file, &header, header_len);
-    res = write (dump_file, packet, len );
-    UNUSED(res);
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+    if (async_writer_running){
+        hci_dump_async_writer_packet(tv_sec, tv_us, (const uint8_t *) &header, header_len, packet, len);
+    } else
+#endif
+    {
+        hci_dump_posix_write((const uint8_t *) &header, header_len, packet, len);
+    }
+    if (flush_on_error && (packet_type == HCI_EVENT_PACKET) && (packet[0] == HCI_EVENT_HARDWARE_ERROR)){
+        hci_dump_flush();
+    }
 #endif
 
 #ifdef ENABLE_SEGGER_RTT
@@ -361,7 +785,7 @@ void hci_dump_packet(uint8_t packet_type, uint8_t in, uint8_t *packet, uint16_t
     UNUSED(header_len);
 }
 
-static int hci_dump_log_level_active(int log_level){
+int hci_dump_log_level_active(int log_level){
     if (log_level < HCI_DUMP_LOG_LEVEL_DEBUG) return 0;
     if (log_level > HCI_DUMP_LOG_LEVEL_ERROR) return 0;
     return log_level_enabled[log_level];
@@ -374,6 +798,11 @@ void hci_dump_log_va_arg(int log_level, const char * format, va_list argptr){
     if (dump_file >= 0){
         int len = vsnprintf(log_message_buffer, sizeof(log_message_buffer), format, argptr);
         hci_dump_packet(LOG_MESSAGE_PACKET, 0, (uint8_t*) log_message_buffer, len);
+#ifdef HAVE_POSIX_FILE_IO
+        if (flush_on_error && (log_level == HCI_DUMP_LOG_LEVEL_ERROR)){
+            hci_dump_flush();
+        }
+#endif
         return;
     }
 #endif
@@ -404,7 +833,13 @@ void hci_dump_log_P(int log_level, PGM_P format, ...){
 #endif
 
 void hci_dump_close(void){
+#ifdef ENABLE_HCI_DUMP_ASYNC_WRITER
+    hci_dump_async_writer_stop();
+#endif
 #ifdef HAVE_POSIX_FILE_IO
+    if (dump_file >= 0){
+        hci_dump_write_buffer_flush();
+    }
     close(dump_file);
 #endif
     dump_file = -1;
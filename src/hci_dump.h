@@ -69,6 +69,15 @@ typedef enum {
     HCI_DUMP_STDOUT
 } hci_dump_format_t;
 
+typedef struct {
+    uint32_t packets_queued;
+    uint32_t bytes_queued;
+    uint32_t packets_dropped;
+    uint32_t bytes_dropped;
+    uint32_t num_writes;
+    uint32_t num_write_errors;
+} hci_dump_async_writer_stats_t;
+
 /*
  * @brief 
  */
@@ -79,6 +88,28 @@ void hci_dump_open(const char *filename, hci_dump_format_t format);
  */
 void hci_dump_set_max_packets(int packets); // -1 for unlimited
 
+/*
+ * @brief Rotate binary packet log over a set of files instead of truncating it, call before hci_dump_open. Overrides hci_dump_set_max_packets
+ * @note The current segment is written to the filename passed to hci_dump_open. Older segments get their number inserted before
+ *       the file extension, e.g. hci_dump.pklg, hci_dump.1.pklg, .. hci_dump.3.pklg for 4 segments.
+ *       Packets are buffered in memory and written when the buffer is full, on rotation, on hci_dump_flush and on hci_dump_close
+ * @param segment_size_max in bytes, 0 to disable rotation
+ * @param num_segments including current segment, at least 2
+ */
+void hci_dump_set_rotation(uint32_t segment_size_max, uint16_t num_segments);
+
+/*
+ * @brief Write buffered packets when an error is logged or an HCI Hardware Error Event is received
+ * @note With ENABLE_HCI_DUMP_ASYNC_WRITER, this waits until the writer thread has written all pending packets
+ * @param enable
+ */
+void hci_dump_set_flush_on_error(int enable);
+
+/*
+ * @brief Write buffered packets, with ENABLE_HCI_DUMP_ASYNC_WRITER wait until writer thread has written pending packets
+ */
+void hci_dump_flush(void);
+
 /*
  * @brief 
  */
@@ -103,10 +134,21 @@ void hci_dump_enable_log_level(int log_level, int enable);
  */
 void hci_dump_close(void);
 
+/*
+ * @brief Get statistics of asynchronous writer, requires ENABLE_HCI_DUMP_ASYNC_WRITER
+ * @note packets are dropped if the ring buffer is full. The number of dropped packets
+ *       is also noted in the packet log as soon as there's space again.
+ * @param stats
+ */
+void hci_dump_get_async_writer_stats(hci_dump_async_writer_stats_t * stats);
+
 /* API_END */
 
 void hci_dump_log_va_arg(int log_level, const char * format, va_list argtr);
 
+// returns 1 if log level has not been disabled with hci_dump_enable_log_level
+int hci_dump_log_level_active(int log_level);
+
 #ifdef __AVR__
 void hci_dump_log_P(int log_level, PGM_P format, ...);
 #endif
@@ -50,6 +50,7 @@
 #include "btstack_config.h"
 
 #include "btstack_debug.h"
+#include "btstack_trace.h"
 #include "hci.h"
 #include "hci_transport.h"
 #include "bluetooth_company_id.h"
@@ -131,6 +132,26 @@ static btstack_uart_config_t uart_config;
 
 // write state
 static TX_STATE tx_state;         
+
+#ifdef ENABLE_H4_TX_COALESCING
+#ifdef ENABLE_EHCILL
+#error "ENABLE_H4_TX_COALESCING cannot be used with ENABLE_EHCILL"
+#endif
+#ifndef HCI_TRANSPORT_H4_TX_BUFFER_SIZE
+#define HCI_TRANSPORT_H4_TX_BUFFER_SIZE (2 * (1 + HCI_OUTGOING_PACKET_BUFFER_SIZE))
+#endif
+#if HCI_TRANSPORT_H4_TX_BUFFER_SIZE < (1 + HCI_OUTGOING_PACKET_BUFFER_SIZE)
+#error "HCI_TRANSPORT_H4_TX_BUFFER_SIZE must be at least 1 + HCI_OUTGOING_PACKET_BUFFER_SIZE"
+#endif
+// outgoing packets are copied into the fill buffer while the other buffer is sent
+static uint8_t  h4_tx_buffers[2][HCI_TRANSPORT_H4_TX_BUFFER_SIZE];
+static uint8_t  h4_tx_fill_index;
+static uint16_t h4_tx_fill_len;
+// HCI_EVENT_TRANSPORT_PACKET_SENT for last copied packet not emitted yet
+static uint8_t  h4_tx_packet_sent_pending;
+// emits HCI_EVENT_TRANSPORT_PACKET_SENT outside of send_packet
+static btstack_timer_source_t h4_tx_packet_sent_timer;
+#endif
 #ifdef ENABLE_EHCILL
 static uint8_t * ehcill_tx_data;
 static uint16_t  ehcill_tx_len;   // 0 == no outgoing packet
@@ -147,6 +168,23 @@ static uint16_t read_pos;
 static uint8_t hci_packet_with_pre_buffer[HCI_INCOMING_PRE_BUFFER_SIZE + HCI_INCOMING_PACKET_BUFFER_SIZE + 1]; // packet type + max(acl header + acl payload, event header + event data)
 static uint8_t * hci_packet = &hci_packet_with_pre_buffer[HCI_INCOMING_PRE_BUFFER_SIZE];
 
+#ifdef ENABLE_H4_BULK_READ
+// additional space to read several packets with a single read
+#ifndef HCI_TRANSPORT_H4_BULK_READ_SIZE
+#define HCI_TRANSPORT_H4_BULK_READ_SIZE 1024
+#endif
+#define H4_MAX_PACKET_SIZE (1 + HCI_INCOMING_PACKET_BUFFER_SIZE)
+#define H4_BULK_BUFFER_SIZE (H4_MAX_PACKET_SIZE + HCI_TRANSPORT_H4_BULK_READ_SIZE)
+// packets are parsed and delivered in place, each with the pre-buffer in front of it
+static uint8_t   h4_bulk_buffer_with_pre_buffer[HCI_INCOMING_PRE_BUFFER_SIZE + H4_BULK_BUFFER_SIZE];
+static uint8_t * h4_bulk_buffer = &h4_bulk_buffer_with_pre_buffer[HCI_INCOMING_PRE_BUFFER_SIZE];
+// unparsed data in [h4_bulk_start, h4_bulk_end)
+static uint16_t  h4_bulk_start;
+static uint16_t  h4_bulk_end;
+// UART driver supports receive_bytes
+static bool      h4_bulk_read;
+#endif
+
 // Baudrate change bugs in TI CC256x and CYW20704
 #ifdef ENABLE_CC256X_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
 #define ENABLE_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
@@ -187,12 +225,13 @@ static void hci_transport_h4_trigger_next_read(void){
     btstack_uart->receive_block(&hci_packet[read_pos], bytes_to_read);  
 }
 
-static void hci_transport_h4_packet_complete(void){
+// packet points to packet type
+static void hci_transport_h4_deliver_packet(uint8_t * packet, uint16_t packet_len){
 #ifdef ENABLE_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
     if (baudrate_change_workaround_state == BAUDRATE_CHANGE_WORKAROUND_IDLE
-            && memcmp(hci_packet, local_version_event_prefix, sizeof(local_version_event_prefix)) == 0){
+            && memcmp(packet, local_version_event_prefix, sizeof(local_version_event_prefix)) == 0){
 #ifdef ENABLE_CC256X_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
-                if (little_endian_read_16(hci_packet, 11) == BLUETOOTH_COMPANY_ID_TEXAS_INSTRUMENTS_INC){
+                if (little_endian_read_16(packet, 11) == BLUETOOTH_COMPANY_ID_TEXAS_INSTRUMENTS_INC){
                     // detect TI CC256x controller based on manufacturer
                     log_info("Detected CC256x controller");
                     baudrate_change_workaround_state = BAUDRATE_CHANGE_WORKAROUND_CHIPSET_DETECTED;
@@ -203,7 +242,7 @@ static void hci_transport_h4_packet_complete(void){
                 }
 #endif
 #ifdef ENABLE_CYPRESS_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
-                if (little_endian_read_16(hci_packet, 11) == BLUETOOTH_COMPANY_ID_CYPRESS_SEMICONDUCTOR){
+                if (little_endian_read_16(packet, 11) == BLUETOOTH_COMPANY_ID_CYPRESS_SEMICONDUCTOR){
                     // detect Cypress controller based on manufacturer
                     log_info("Detected Cypress controller");
                     baudrate_change_workaround_state = BAUDRATE_CHANGE_WORKAROUND_CHIPSET_DETECTED;
@@ -215,11 +254,17 @@ static void hci_transport_h4_packet_complete(void){
 #endif
             }
 #endif
+    BTSTACK_TRACE_BEGIN(trace_start);
+    packet_handler(packet[0], &packet[1], packet_len);
+    BTSTACK_TRACE_PACKET_END(trace_start, BTSTACK_TRACEPOINT_TRANSPORT_RX, packet[0], &packet[1], packet_len);
+}
+
+static void hci_transport_h4_packet_complete(void){
     uint16_t packet_len = read_pos-1u;
 
     // reset state machine before delivering packet to stack as it might close the transport
     hci_transport_h4_reset_statemachine();
-    packet_handler(hci_packet[0], &hci_packet[1], packet_len);
+    hci_transport_h4_deliver_packet(hci_packet, packet_len);
 }
 
 static void hci_transport_h4_block_read(void){
@@ -321,12 +366,164 @@ static void hci_transport_h4_block_read(void){
     }
 }
 
+#ifdef ENABLE_H4_BULK_READ
+
+static void hci_transport_h4_bulk_trigger_next_read(void){
+    if (h4_bulk_start == h4_bulk_end){
+        h4_bulk_start = 0;
+        h4_bulk_end   = 0;
+    } else if ((h4_bulk_start + H4_MAX_PACKET_SIZE) > H4_BULK_BUFFER_SIZE){
+        // incomplete packet might not fit, move to start of buffer
+        uint16_t bytes_pending = h4_bulk_end - h4_bulk_start;
+        (void) memmove(h4_bulk_buffer, &h4_bulk_buffer[h4_bulk_start], bytes_pending);
+        h4_bulk_start = 0;
+        h4_bulk_end   = bytes_pending;
+    }
+    btstack_uart->receive_bytes(&h4_bulk_buffer[h4_bulk_end], H4_BULK_BUFFER_SIZE - h4_bulk_end);
+}
+
+// returns size of complete packet including packet type, 0 if more data is needed
+static uint16_t hci_transport_h4_bulk_get_packet_size(const uint8_t * packet, uint16_t bytes_available, uint16_t * bytes_to_skip){
+    uint16_t header_size;
+    uint16_t payload_len;
+    *bytes_to_skip = 0;
+    switch (packet[0]){
+        case HCI_EVENT_PACKET:
+            header_size = HCI_EVENT_HEADER_SIZE;
+            if (bytes_available < (1u + header_size)) return 0;
+            payload_len = packet[2];
+            break;
+        case HCI_ACL_DATA_PACKET:
+            header_size = HCI_ACL_HEADER_SIZE;
+            if (bytes_available < (1u + header_size)) return 0;
+            payload_len = little_endian_read_16(packet, 3);
+            break;
+        case HCI_SCO_DATA_PACKET:
+            header_size = HCI_SCO_HEADER_SIZE;
+            if (bytes_available < (1u + header_size)) return 0;
+            payload_len = packet[3];
+            break;
+        default:
+            log_error("hci_transport_h4: invalid packet type 0x%02x", packet[0]);
+            *bytes_to_skip = 1;
+            return 0;
+    }
+    if (payload_len > (HCI_INCOMING_PACKET_BUFFER_SIZE - header_size)){
+        log_error("hci_transport_h4: invalid packet type 0x%02x len %d - only space for %u", packet[0], payload_len, HCI_INCOMING_PACKET_BUFFER_SIZE - header_size);
+        // drop header as in block read mode
+        *bytes_to_skip = 1u + header_size;
+        return 0;
+    }
+    if (bytes_available < (1u + header_size + payload_len)) return 0;
+    return 1u + header_size + payload_len;
+}
+
+static void hci_transport_h4_bytes_received(uint16_t num_bytes){
+
+    h4_bulk_end += num_bytes;
+
+#ifdef ENABLE_BAUDRATE_CHANGE_FLOWCONTROL_BUG_WORKAROUND
+    // command complete is read together with its header, no need to force a single block read
+    if (baudrate_change_workaround_state == BAUDRATE_CHANGE_WORKAROUND_BAUDRATE_COMMAND_SENT){
+        baudrate_change_workaround_state = BAUDRATE_CHANGE_WORKAROUND_IDLE;
+    }
+#endif
+
+    // deliver all complete packets, stop if transport was closed by packet handler
+    while ((h4_state != H4_OFF) && (h4_bulk_start < h4_bulk_end)){
+        uint8_t * packet = &h4_bulk_buffer[h4_bulk_start];
+#ifdef ENABLE_EHCILL
+        switch (packet[0]){
+            case EHCILL_GO_TO_SLEEP_IND:
+            case EHCILL_GO_TO_SLEEP_ACK:
+            case EHCILL_WAKE_UP_IND:
+            case EHCILL_WAKE_UP_ACK:
+                h4_bulk_start++;
+                hci_transport_h4_ehcill_handle_command(packet[0]);
+                continue;
+            default:
+                break;
+        }
+#endif
+        uint16_t bytes_to_skip;
+        uint16_t packet_size = hci_transport_h4_bulk_get_packet_size(packet, h4_bulk_end - h4_bulk_start, &bytes_to_skip);
+        if (bytes_to_skip > 0u){
+            h4_bulk_start += btstack_min(bytes_to_skip, h4_bulk_end - h4_bulk_start);
+            continue;
+        }
+        if (packet_size == 0u) break;
+        // consume packet before delivering it to stack as it might close the transport
+        h4_bulk_start += packet_size;
+        hci_transport_h4_deliver_packet(packet, packet_size - 1u);
+    }
+
+    if (h4_state != H4_OFF) {
+        hci_transport_h4_bulk_trigger_next_read();
+    }
+}
+#endif
+
+#ifdef ENABLE_H4_TX_COALESCING
+static void hci_transport_h4_tx_reset(void){
+    h4_tx_fill_index = 0;
+    h4_tx_fill_len = 0;
+    h4_tx_packet_sent_pending = 0;
+    btstack_run_loop_remove_timer(&h4_tx_packet_sent_timer);
+}
+
+static int hci_transport_h4_tx_fill_buffer_has_room(void){
+    return (h4_tx_fill_len + 1u + HCI_OUTGOING_PACKET_BUFFER_SIZE) <= HCI_TRANSPORT_H4_TX_BUFFER_SIZE;
+}
+
+// notify upper stack that it can send again as soon as the next packet fits into the fill buffer
+static void hci_transport_h4_tx_emit_packet_sent_if_ready(void){
+    static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+    if (h4_tx_packet_sent_pending == 0u) return;
+    if (tx_state == TX_OFF) return;
+    if (!hci_transport_h4_tx_fill_buffer_has_room()) return;
+    h4_tx_packet_sent_pending = 0;
+    packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+}
+
+static void hci_transport_h4_tx_packet_sent_timer_handler(btstack_timer_source_t * timer){
+    UNUSED(timer);
+    hci_transport_h4_tx_emit_packet_sent_if_ready();
+}
+
+// send all collected packets with a single block
+static void hci_transport_h4_tx_flush(void){
+    if (h4_tx_fill_len == 0u){
+        tx_state = TX_IDLE;
+        return;
+    }
+    uint8_t * buffer = h4_tx_buffers[h4_tx_fill_index];
+    uint16_t  len    = h4_tx_fill_len;
+    h4_tx_fill_index ^= 1u;
+    h4_tx_fill_len = 0;
+    tx_state = TX_W4_PACKET_SENT;
+    btstack_uart->send_block(buffer, len);
+}
+
+static void hci_transport_h4_tx_block_sent(void){
+    // start sending packets collected in the meantime
+    hci_transport_h4_tx_flush();
+
+    // fill buffer is empty now, release packet buffer in HCI if it had to wait for room
+    btstack_run_loop_remove_timer(&h4_tx_packet_sent_timer);
+    hci_transport_h4_tx_emit_packet_sent_if_ready();
+}
+#endif
+
 static void hci_transport_h4_block_sent(void){
 
     static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
 
     switch (tx_state){
         case TX_W4_PACKET_SENT:
+#ifdef ENABLE_H4_TX_COALESCING
+            hci_transport_h4_tx_block_sent();
+            break;
+#endif
             // packet fully sent, reset state
 #ifdef ENABLE_EHCILL
             ehcill_tx_len = 0;
@@ -355,7 +552,14 @@ static void hci_transport_h4_block_sent(void){
 
 static int hci_transport_h4_can_send_now(uint8_t packet_type){
     UNUSED(packet_type);
+#ifdef ENABLE_H4_TX_COALESCING
+    // accept packets while UART is busy as long as a max size packet fits into the fill buffer
+    if (tx_state == TX_OFF) return 0;
+    if (h4_tx_packet_sent_pending) return 0;
+    return hci_transport_h4_tx_fill_buffer_has_room();
+#else
     return tx_state == TX_IDLE;
+#endif
 }
 
 static int hci_transport_h4_send_packet(uint8_t packet_type, uint8_t * packet, int size){
@@ -373,6 +577,27 @@ static int hci_transport_h4_send_packet(uint8_t packet_type, uint8_t * packet, i
     }
 #endif
 
+#ifdef ENABLE_H4_TX_COALESCING
+    if ((h4_tx_fill_len + size) > HCI_TRANSPORT_H4_TX_BUFFER_SIZE){
+        log_error("hci_transport_h4: no space for packet with size %u", size);
+        return -1;
+    }
+    (void) memcpy(&h4_tx_buffers[h4_tx_fill_index][h4_tx_fill_len], packet, size);
+    h4_tx_fill_len += size;
+    if (tx_state == TX_IDLE){
+        hci_transport_h4_tx_flush();
+    }
+    // packet has been copied, HCI may reuse its buffer. Emitting the event from within send_packet would
+    // re-enter HCI, so it's emitted from a timer if there's room for the next packet, or after the current block
+    h4_tx_packet_sent_pending = 1;
+    if (hci_transport_h4_tx_fill_buffer_has_room()){
+        btstack_run_loop_set_timer_handler(&h4_tx_packet_sent_timer, &hci_transport_h4_tx_packet_sent_timer_handler);
+        btstack_run_loop_set_timer(&h4_tx_packet_sent_timer, 0);
+        btstack_run_loop_add_timer(&h4_tx_packet_sent_timer);
+    }
+    return 0;
+#else
+
 #ifdef ENABLE_EHCILL
     // store request for later
     ehcill_tx_len   = size;
@@ -393,6 +618,7 @@ static int hci_transport_h4_send_packet(uint8_t packet_type, uint8_t * packet, i
     tx_state = TX_W4_PACKET_SENT;
     btstack_uart->send_block(packet, size);
     return 0;
+#endif
 }
 
 static void hci_transport_h4_init(const void * transport_config){
@@ -420,6 +646,15 @@ static void hci_transport_h4_init(const void * transport_config){
     btstack_uart->init(&uart_config);
     btstack_uart->set_block_received(&hci_transport_h4_block_read);
     btstack_uart->set_block_sent(&hci_transport_h4_block_sent);
+
+#ifdef ENABLE_H4_BULK_READ
+    h4_bulk_read = (btstack_uart->receive_bytes != NULL) && (btstack_uart->set_bytes_received != NULL);
+    if (h4_bulk_read){
+        btstack_uart->set_bytes_received(&hci_transport_h4_bytes_received);
+    } else {
+        log_info("hci_transport_h4: UART driver does not support receive_bytes, using block reads");
+    }
+#endif
 }
 
 static int hci_transport_h4_open(void){
@@ -431,8 +666,21 @@ static int hci_transport_h4_open(void){
 
     // init rx + tx state machines
     hci_transport_h4_reset_statemachine();
+#ifdef ENABLE_H4_BULK_READ
+    h4_bulk_start = 0;
+    h4_bulk_end   = 0;
+    if (h4_bulk_read){
+        hci_transport_h4_bulk_trigger_next_read();
+    } else {
+        hci_transport_h4_trigger_next_read();
+    }
+#else
     hci_transport_h4_trigger_next_read();
+#endif
     tx_state = TX_IDLE;
+#ifdef ENABLE_H4_TX_COALESCING
+    hci_transport_h4_tx_reset();
+#endif
 
 #ifdef ENABLE_EHCILL
     hci_transport_h4_ehcill_open();
@@ -444,6 +692,9 @@ static int hci_transport_h4_close(void){
     // set state to off
     tx_state = TX_OFF;
     h4_state = H4_OFF;
+#ifdef ENABLE_H4_TX_COALESCING
+    hci_transport_h4_tx_reset();
+#endif
 
     // close uart driver
     return btstack_uart->close();
@@ -68,14 +68,24 @@ typedef enum {
     HCI_TRANSPORT_LINK_SEND_SLEEP                 = 1 <<  5,
     HCI_TRANSPORT_LINK_SEND_WOKEN                 = 1 <<  6,
     HCI_TRANSPORT_LINK_SEND_WAKEUP                = 1 <<  7,
-    HCI_TRANSPORT_LINK_SEND_QUEUED_PACKET         = 1 <<  8,
-    HCI_TRANSPORT_LINK_SEND_ACK_PACKET            = 1 <<  9,
-    HCI_TRANSPORT_LINK_ENTER_SLEEP                = 1 << 10,
+    HCI_TRANSPORT_LINK_SEND_ACK_PACKET            = 1 <<  8,
+    HCI_TRANSPORT_LINK_ENTER_SLEEP                = 1 <<  9,
 
 } hci_transport_link_actions_t;
 
+#ifdef ENABLE_H5_SLIDING_WINDOW
+#ifndef HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE
+#define HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE 4
+#endif
+#if (HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE < 1) || (HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE > 7)
+#error "HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE must be in range 1..7"
+#endif
+// Configuration Field. Outgoing packets are copied into retransmission queue -> sliding window up to 7, no OOF flow control, support data integrity check
+#define LINK_CONFIG_SLIDING_WINDOW_SIZE HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE
+#else
 // Configuration Field. No packet buffers -> sliding window = 1, no OOF flow control, support data integrity check
 #define LINK_CONFIG_SLIDING_WINDOW_SIZE 1
+#endif
 #define LINK_CONFIG_OOF_FLOW_CONTROL 0
 #define LINK_CONFIG_DATA_INTEGRITY_CHECK 1
 #define LINK_CONFIG_VERSION_NR 0
@@ -94,6 +104,9 @@ typedef enum {
 // max size of write requests
 #define LINK_SLIP_TX_CHUNK_LEN 64
 
+// max size of read requests if UART driver supports receive_bytes
+#define LINK_SLIP_RX_CHUNK_LEN 256
+
 // ---
 static const uint8_t link_control_sync[] =   { 0x01, 0x7e};
 static const uint8_t link_control_sync_response[] = { 0x02, 0x7d};
@@ -123,15 +136,29 @@ static uint8_t  link_ack_nr;
 static uint16_t link_resend_timeout_ms;
 static uint8_t  link_peer_asleep;
 static uint8_t  link_peer_supports_data_integrity_check;
+static uint8_t  link_peer_config_field;
 
 // auto sleep-mode
 static btstack_timer_source_t inactivity_timer;
 static uint16_t link_inactivity_timeout_ms; // auto-sleep if set
 
-// Outgoing packet
-static uint8_t   hci_packet_type;
-static uint16_t  hci_packet_size;
-static uint8_t * hci_packet;
+// Outgoing reliable packets. Oldest packet has sequence nr link_seq_nr
+typedef struct {
+    uint8_t * packet;
+    uint16_t  size;
+    uint8_t   type;
+} hci_transport_link_packet_t;
+
+static hci_transport_link_packet_t link_tx_queue[LINK_CONFIG_SLIDING_WINDOW_SIZE];
+#ifdef ENABLE_H5_SLIDING_WINDOW
+// HCI packet buffer is released before packet is acknowledged -> keep copy for retransmission
+static uint8_t link_tx_queue_storage[LINK_CONFIG_SLIDING_WINDOW_SIZE][HCI_OUTGOING_PACKET_BUFFER_SIZE];
+#endif
+static uint8_t link_tx_queue_head;          // index of oldest packet
+static uint8_t link_tx_queue_len;           // packets not acknowledged yet
+static uint8_t link_tx_queue_num_sent;      // packets sent in current round, starting with oldest packet
+static uint8_t link_tx_window_size;         // negotiated with config response
+static uint8_t link_tx_packet_sent_pending; // HCI_EVENT_TRANSPORT_PACKET_SENT for last queued packet not emitted yet
 
 // hci packet handler
 static  void (*packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
@@ -154,43 +181,18 @@ static void hci_transport_link_run(void);
 static void hci_transport_slip_init(void);
 
 // -----------------------------
-// CRC16-CCITT Calculation - compromise: use 32 byte table - 512 byte table would be faster, but that's too large
-
-
-static uint16_t crc16_ccitt_update (uint16_t crc, uint8_t ch){
-
-    static const uint16_t crc16_ccitt_table[] ={
-            0x0000, 0x1081, 0x2102, 0x3183,
-            0x4204, 0x5285, 0x6306, 0x7387,
-            0x8408, 0x9489, 0xa50a, 0xb58b,
-            0xc60c, 0xd68d, 0xe70e, 0xf78f
-    };
-
-    crc = (crc >> 4u) ^ crc16_ccitt_table[(crc ^ ch) & 0x000fu];
-    crc = (crc >> 4u) ^ crc16_ccitt_table[(crc ^ (ch >> 4u)) & 0x000fu];
-    return crc;
-}
+// Data Integrity Check: CRC16-CCITT over header and payload, transmitted with MSB of CRC first
 
 static uint16_t btstack_reverse_bits_16(uint16_t value){
-    int reverse = 0;
-    int i;
-    for (i = 0; i < 16; i++) { 
-        reverse = reverse << 1;
-        reverse |= value & 1u;
-        value = value >> 1;
-    }
-    return reverse;
+    value = (uint16_t) (((value >> 1) & 0x5555u) | ((value & 0x5555u) << 1));
+    value = (uint16_t) (((value >> 2) & 0x3333u) | ((value & 0x3333u) << 2));
+    value = (uint16_t) (((value >> 4) & 0x0f0fu) | ((value & 0x0f0fu) << 4));
+    return (uint16_t) ((value >> 8) | (value << 8));
 }
 
 static uint16_t crc16_calc_for_slip_frame(const uint8_t * header, const uint8_t * payload, uint16_t len){
-    int i;
-    uint16_t crc = 0xffff;
-    for (i=0 ; i < 4 ; i++){
-        crc = crc16_ccitt_update(crc, header[i]);
-    }
-    for (i=0 ; i < len ; i++){
-        crc = crc16_ccitt_update(crc, payload[i]);
-    }
+    uint16_t crc = btstack_crc16_ccitt_update(0xffff, header, 4);
+    crc = btstack_crc16_ccitt_update(crc, payload, len);
     return btstack_reverse_bits_16(crc);
 }
 
@@ -211,6 +213,7 @@ static void hci_transport_inactivity_timer_set(void){
     if (!link_inactivity_timeout_ms) return;
     btstack_run_loop_set_timer_handler(&inactivity_timer, &hci_transport_inactivity_timeout_handler);
     btstack_run_loop_set_timer(&inactivity_timer, link_inactivity_timeout_ms);
+    btstack_run_loop_set_timer_slack(&inactivity_timer, link_inactivity_timeout_ms / 8u);
     btstack_run_loop_remove_timer(&inactivity_timer);
     btstack_run_loop_add_timer(&inactivity_timer);
 }
@@ -220,9 +223,7 @@ static void hci_transport_inactivity_timer_set(void){
 
 // Fill chunk and write
 static void hci_transport_slip_encode_chunk_and_send(int pos){
-    while (btstack_slip_encoder_has_data() & (pos < LINK_SLIP_TX_CHUNK_LEN)) {
-        slip_outgoing_buffer[pos++] = btstack_slip_encoder_get_byte();
-    }
+    pos += btstack_slip_encoder_get_bytes(&slip_outgoing_buffer[pos], LINK_SLIP_TX_CHUNK_LEN - pos);
 
     if (!btstack_slip_encoder_has_data()){
         // Payload encoded, append DIC if present.
@@ -231,9 +232,7 @@ static void hci_transport_slip_encode_chunk_and_send(int pos){
             uint8_t dic_buffer[2];
             big_endian_store_16(dic_buffer, 0, slip_outgoing_dic);
             btstack_slip_encoder_start(dic_buffer, 2);
-            while (btstack_slip_encoder_has_data()){
-                slip_outgoing_buffer[pos++] = btstack_slip_encoder_get_byte();
-            } 
+            pos += btstack_slip_encoder_get_bytes(&slip_outgoing_buffer[pos], 4);
         }
         // Start of Frame
         slip_outgoing_buffer[pos++] = BTSTACK_SLIP_SOF;
@@ -262,9 +261,7 @@ static void hci_transport_slip_send_frame(const uint8_t * header, const uint8_t
 
     // Header
     btstack_slip_encoder_start(header, 4);
-    while (btstack_slip_encoder_has_data()){
-        slip_outgoing_buffer[pos++] = btstack_slip_encoder_get_byte();
-    }
+    pos += btstack_slip_encoder_get_bytes(&slip_outgoing_buffer[pos], 8);
 
     // Packet
     btstack_slip_encoder_start(packet, packet_size);
@@ -322,9 +319,16 @@ static void hci_transport_link_send_config(void){
     hci_transport_link_send_control(link_control_config, sizeof(link_control_config));
 }
 
+// response contains configuration to use by peer: smaller sliding window and data integrity check only if both support it
 static void hci_transport_link_send_config_response(void){
-    log_debug("link send config response");
-    hci_transport_link_send_control(link_control_config_response, sizeof(link_control_config_response));
+    uint8_t sliding_window_size  = btstack_min(link_peer_config_field & 0x07u, LINK_CONFIG_SLIDING_WINDOW_SIZE);
+    uint8_t data_integrity_check = link_peer_config_field & (LINK_CONFIG_DATA_INTEGRITY_CHECK << 4);
+    uint8_t config_response[3];
+    config_response[0] = link_control_config_response[0];
+    config_response[1] = link_control_config_response[1];
+    config_response[2] = sliding_window_size | data_integrity_check | (LINK_CONFIG_VERSION_NR << 5);
+    log_debug("link send config response 0x%02x", config_response[2]);
+    hci_transport_link_send_control(config_response, sizeof(config_response));
 }
 
 static void hci_transport_link_send_config_response_empty(void){
@@ -348,19 +352,33 @@ static void hci_transport_link_send_sleep(void){
     hci_transport_link_send_control(link_control_sleep, sizeof(link_control_sleep));
 }
 
+static uint8_t hci_transport_link_queue_index(uint8_t offset){
+    return (link_tx_queue_head + offset) % LINK_CONFIG_SLIDING_WINDOW_SIZE;
+}
+
+// send next packet of current round
 static void hci_transport_link_send_queued_packet(void){
 
+    const hci_transport_link_packet_t * queued_packet = &link_tx_queue[hci_transport_link_queue_index(link_tx_queue_num_sent)];
+    uint8_t seq_nr = (link_seq_nr + link_tx_queue_num_sent) & 0x07u;
+
+    // (re-)start resend timer when sending oldest packet
+    if (link_tx_queue_num_sent == 0u){
+        hci_transport_link_set_timer(link_resend_timeout_ms);
+    }
+    link_tx_queue_num_sent++;
+
     uint8_t header[4];
-    hci_transport_link_calc_header(header, link_seq_nr, link_ack_nr, link_peer_supports_data_integrity_check, 1, hci_packet_type, hci_packet_size);
+    hci_transport_link_calc_header(header, seq_nr, link_ack_nr, link_peer_supports_data_integrity_check, 1, queued_packet->type, queued_packet->size);
 
     uint16_t data_integrity_check = 0;
     if (link_peer_supports_data_integrity_check){
-        data_integrity_check = crc16_calc_for_slip_frame(header, hci_packet, hci_packet_size);
+        data_integrity_check = crc16_calc_for_slip_frame(header, queued_packet->packet, queued_packet->size);
     }
-    log_debug("hci_transport_link_send_queued_packet: seq %u, ack %u, size %u. Append dic %u, dic = 0x%04x", link_seq_nr, link_ack_nr, hci_packet_size, link_peer_supports_data_integrity_check, data_integrity_check);
-    log_debug_hexdump(hci_packet, hci_packet_size);
+    log_debug("hci_transport_link_send_queued_packet: seq %u, ack %u, size %u. Append dic %u, dic = 0x%04x", seq_nr, link_ack_nr, queued_packet->size, link_peer_supports_data_integrity_check, data_integrity_check);
+    log_debug_hexdump(queued_packet->packet, queued_packet->size);
 
-    hci_transport_slip_send_frame(header, hci_packet, hci_packet_size, data_integrity_check);
+    hci_transport_slip_send_frame(header, queued_packet->packet, queued_packet->size, data_integrity_check);
 
     // reset inactvitiy timer
     hci_transport_inactivity_timer_set();
@@ -414,8 +432,7 @@ static void hci_transport_link_run(void){
         hci_transport_link_send_wakeup();
         return;
     }
-    if (hci_transport_link_actions & HCI_TRANSPORT_LINK_SEND_QUEUED_PACKET){
-        hci_transport_link_actions &= ~HCI_TRANSPORT_LINK_SEND_QUEUED_PACKET;
+    if ((link_peer_asleep == 0u) && (link_tx_queue_num_sent < link_tx_queue_len)){
         // packet already contains ack, no need to send addtitional one
         hci_transport_link_actions &= ~HCI_TRANSPORT_LINK_SEND_ACK_PACKET;
         hci_transport_link_send_queued_packet();
@@ -436,6 +453,7 @@ static void hci_transport_link_run(void){
 }
 
 static void hci_transport_link_set_timer(uint16_t timeout_ms){
+    btstack_run_loop_remove_timer(&link_timer);
     btstack_run_loop_set_timer(&link_timer, timeout_ms);
     btstack_run_loop_add_timer(&link_timer);
 }
@@ -461,9 +479,9 @@ static void hci_transport_link_timeout_handler(btstack_timer_source_t * ts){
                 hci_transport_link_set_timer(LINK_WAKEUP_MS);
                 return;
             }
-            // resend packet
-            hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_QUEUED_PACKET;
-            hci_transport_link_set_timer(link_resend_timeout_ms);
+            // resend all unacknowledged packets starting with oldest one, resend timer is started when it is sent
+            log_info("h5 resend timeout, resend %u packets starting with seq %u", link_tx_queue_len, link_seq_nr);
+            link_tx_queue_num_sent = 0;
             break;
         default:
             break;
@@ -476,6 +494,7 @@ static void hci_transport_link_init(void){
     link_state = LINK_UNINITIALIZED;
     link_peer_asleep = 0;
     link_peer_supports_data_integrity_check = 0;
+    link_tx_window_size = 1;
  
     // get started
     hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_SYNC;
@@ -489,18 +508,63 @@ static int hci_transport_link_inc_seq_nr(int seq_nr){
 }
 
 static int hci_transport_link_have_outgoing_packet(void){
-    return hci_packet != NULL;
+    return link_tx_queue_len > 0u;
 }
 
 static void hci_transport_link_clear_queue(void){
     btstack_run_loop_remove_timer(&link_timer);
-    hci_packet = NULL;
+    link_tx_queue_head = 0;
+    link_tx_queue_len = 0;
+    link_tx_queue_num_sent = 0;
+    link_tx_packet_sent_pending = 0;
 }
 
 static void hci_transport_h5_queue_packet(uint8_t packet_type, uint8_t *packet, int size){
-    hci_packet = packet;
-    hci_packet_type = packet_type;
-    hci_packet_size = size;
+    uint8_t index = hci_transport_link_queue_index(link_tx_queue_len);
+    hci_transport_link_packet_t * queued_packet = &link_tx_queue[index];
+#ifdef ENABLE_H5_SLIDING_WINDOW
+    (void) memcpy(link_tx_queue_storage[index], packet, size);
+    queued_packet->packet = link_tx_queue_storage[index];
+#else
+    queued_packet->packet = packet;
+#endif
+    queued_packet->type = packet_type;
+    queued_packet->size = size;
+    link_tx_queue_len++;
+    link_tx_packet_sent_pending = 1;
+}
+
+// notify upper stack that it can send again as soon as there's room in the sliding window
+// without ENABLE_H5_SLIDING_WINDOW, the window size is 1 and the packet buffer is released after it was acknowledged
+static void hci_transport_link_emit_packet_sent_if_ready(void){
+    if (link_tx_packet_sent_pending == 0u) return;
+    if (link_tx_queue_len >= link_tx_window_size) return;
+    link_tx_packet_sent_pending = 0;
+    uint8_t event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+    packet_handler(HCI_EVENT_PACKET, &event[0], sizeof(event));
+}
+
+// remove all packets before ack_nr from queue
+static void hci_transport_link_process_ack(uint8_t ack_nr){
+    uint8_t num_packets_acked = (ack_nr - link_seq_nr) & 0x07u;
+    if (num_packets_acked == 0u) return;
+    if (num_packets_acked > link_tx_queue_len){
+        log_info("ack nr %u outside of window: seq nr %u, %u packets queued", ack_nr, link_seq_nr, link_tx_queue_len);
+        return;
+    }
+    log_debug("outgoing packets with seq %u to %u ack'ed", link_seq_nr, (ack_nr - 1u) & 0x07u);
+    link_seq_nr = ack_nr;
+    link_tx_queue_head = hci_transport_link_queue_index(num_packets_acked);
+    link_tx_queue_len -= num_packets_acked;
+    if (link_tx_queue_num_sent > num_packets_acked){
+        link_tx_queue_num_sent -= num_packets_acked;
+        // restart resend timer for new oldest packet
+        hci_transport_link_set_timer(link_resend_timeout_ms);
+    } else {
+        link_tx_queue_num_sent = 0;
+        btstack_run_loop_remove_timer(&link_timer);
+    }
+    hci_transport_link_emit_packet_sent_if_ready();
 }
 
 static void hci_transport_h5_emit_sleep_state(int sleep_active){
@@ -533,6 +597,7 @@ static void hci_transport_h5_process_frame(uint16_t frame_size){
     uint8_t  reliable_packet  = (slip_header[0u] & 0x80u) != 0u;
     uint8_t  link_packet_type = slip_header[1u] & 0x0fu;
     uint16_t link_payload_len = (slip_header[1] >> 4) | (slip_header[2] << 4);
+    bool     out_of_sequence;
 
     log_debug("process_frame, reliable %u, packet type %u, seq_nr %u, ack_nr %u , dic %u, payload 0x%04x bytes", reliable_packet, link_packet_type, seq_nr, ack_nr, data_integrity_check_present, frame_size_without_header);
     log_debug_hexdump(slip_header, 4);
@@ -604,14 +669,20 @@ static void hci_transport_h5_process_frame(uint16_t frame_size){
                     hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_CONFIG_RESPONSE_EMPTY;
                 } else {
                     log_debug("link received config, 0x%02x", slip_payload[2]);
+                    link_peer_config_field = slip_payload[2];
                     hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_CONFIG_RESPONSE;
                 }
                 break;
             }
             if (memcmp(slip_payload, link_control_config_response, link_control_config_response_prefix_len) == 0){
-                uint8_t config = slip_payload[2];
+                // peer without config field uses sliding window = 1 and no data integrity check
+                uint8_t config = 0x01;
+                if (link_payload_len > link_control_config_response_prefix_len){
+                    config = slip_payload[2];
+                }
                 link_peer_supports_data_integrity_check = (config & 0x10u) != 0u;
-                log_info("link received config response 0x%02x, data integrity check supported %u", config, link_peer_supports_data_integrity_check);
+                link_tx_window_size = btstack_max(1, btstack_min(config & 0x07u, LINK_CONFIG_SLIDING_WINDOW_SIZE));
+                log_info("link received config response 0x%02x, data integrity check supported %u, sliding window %u", config, link_peer_supports_data_integrity_check, link_tx_window_size);
                 link_state = LINK_ACTIVE;
                 btstack_run_loop_remove_timer(&link_timer);
                 log_info("link activated");
@@ -627,40 +698,35 @@ static void hci_transport_h5_process_frame(uint16_t frame_size){
         case LINK_ACTIVE:
 
             // validate packet sequence nr in reliable packets (check for out of sequence error)
+            // out of sequence packets are dropped, the ack with the expected seq nr lets peer resend from there
+            out_of_sequence = false;
             if (reliable_packet){
-                if (seq_nr != link_ack_nr){
+                if (seq_nr == link_ack_nr){
+                    link_ack_nr = hci_transport_link_inc_seq_nr(link_ack_nr);
+                } else {
                     log_info("expected seq nr %u, but received %u", link_ack_nr, seq_nr);
-                    hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_ACK_PACKET;
-                    break;
+                    out_of_sequence = true;
                 }
                 // ack packet right away
-                link_ack_nr = hci_transport_link_inc_seq_nr(link_ack_nr);
                 hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_ACK_PACKET;
             }
 
-            // Process ACKs in reliable packet and explicit ack packets
+            // Process ACKs in reliable packets, also if out of sequence, and explicit ack packets
             if (reliable_packet || (link_packet_type == LINK_ACKNOWLEDGEMENT_TYPE)){
-                // our packet is good if the remote expects our seq nr + 1
-                int next_seq_nr = hci_transport_link_inc_seq_nr(link_seq_nr);
-                if (hci_transport_link_have_outgoing_packet() && (next_seq_nr == ack_nr)){
-                    log_debug("outoing packet with seq %u ack'ed", link_seq_nr);
-                    link_seq_nr = next_seq_nr;
-                    hci_transport_link_clear_queue();
-
-                    // notify upper stack that it can send again
-                    uint8_t event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
-                    packet_handler(HCI_EVENT_PACKET, &event[0], sizeof(event));
-                }
-            } 
+                hci_transport_link_process_ack(ack_nr);
+            }
+
+            if (out_of_sequence) break;
 
             switch (link_packet_type){
                 case LINK_CONTROL_PACKET_TYPE:
-                    if (memcmp(slip_payload, link_control_config, sizeof(link_control_config)) == 0){
+                    if (memcmp(slip_payload, link_control_config, link_control_config_prefix_len) == 0){
                         if (link_payload_len == link_control_config_prefix_len){
                             log_debug("link received config, no config field");
                             hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_CONFIG_RESPONSE_EMPTY;
                         } else {
                             log_debug("link received config, 0x%02x", slip_payload[2]);
+                            link_peer_config_field = slip_payload[2];
                             hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_CONFIG_RESPONSE;
                         }
                         break;
@@ -738,12 +804,34 @@ static void hci_transport_link_update_resend_timeout(uint32_t baudrate){
 static uint8_t hci_transport_link_read_byte;
 static int hci_transport_h5_active;
 
-static void hci_transport_h5_read_next_byte(void){
-    btstack_uart->receive_block(&hci_transport_link_read_byte, 1);    
+// read chunks with receive_bytes if supported by UART driver, single bytes otherwise
+static uint8_t hci_transport_link_read_buffer[LINK_SLIP_RX_CHUNK_LEN];
+static bool    hci_transport_h5_read_bytes;
+
+static void hci_transport_h5_read_next(void){
+    if (hci_transport_h5_read_bytes){
+        btstack_uart->receive_bytes(hci_transport_link_read_buffer, sizeof(hci_transport_link_read_buffer));
+    } else {
+        btstack_uart->receive_block(&hci_transport_link_read_byte, 1);
+    }
 }
 
 // track time receiving SLIP frame
 static uint32_t hci_transport_h5_receive_start;
+static void hci_transport_h5_frame_received(uint16_t frame_size){
+    // track time
+    uint32_t packet_receive_time = btstack_run_loop_get_time_ms() - hci_transport_h5_receive_start;
+    uint32_t nominal_time = (frame_size + 6u) * 10u * 1000u / uart_config.baudrate;
+    UNUSED(nominal_time);
+    UNUSED(packet_receive_time);
+    log_info("slip frame time %u ms for %u decoded bytes. nomimal time %u ms", (int) packet_receive_time, frame_size, (int) nominal_time);
+    // reset state
+    hci_transport_h5_receive_start = 0;
+    // 
+    hci_transport_h5_process_frame(frame_size);
+    hci_transport_slip_init();
+}
+
 static void hci_transport_h5_block_received(void){
     if (hci_transport_h5_active == 0) return;
 
@@ -754,19 +842,29 @@ static void hci_transport_h5_block_received(void){
     btstack_slip_decoder_process(hci_transport_link_read_byte);
     uint16_t frame_size = btstack_slip_decoder_frame_size();
     if (frame_size) {
-        // track time
-        uint32_t packet_receive_time = btstack_run_loop_get_time_ms() - hci_transport_h5_receive_start;
-        uint32_t nominal_time = (frame_size + 6u) * 10u * 1000u / uart_config.baudrate;
-        UNUSED(nominal_time);
-        UNUSED(packet_receive_time);
-        log_info("slip frame time %u ms for %u decoded bytes. nomimal time %u ms", (int) packet_receive_time, frame_size, (int) nominal_time);
-        // reset state
-        hci_transport_h5_receive_start = 0;
-        // 
-        hci_transport_h5_process_frame(frame_size);
-        hci_transport_slip_init();
+        hci_transport_h5_frame_received(frame_size);
     }
-    hci_transport_h5_read_next_byte();
+    hci_transport_h5_read_next();
+}
+
+static void hci_transport_h5_bytes_received(uint16_t num_bytes){
+    if (hci_transport_h5_active == 0) return;
+
+    if (hci_transport_h5_receive_start == 0u){
+        hci_transport_h5_receive_start = btstack_run_loop_get_time_ms();
+    }
+
+    // decode all frames in received chunk directly into packet buffer
+    uint16_t pos = 0;
+    while (pos < num_bytes){
+        pos += btstack_slip_decoder_process_block(&hci_transport_link_read_buffer[pos], num_bytes - pos);
+        uint16_t frame_size = btstack_slip_decoder_frame_size();
+        if (frame_size == 0u) continue;
+        hci_transport_h5_frame_received(frame_size);
+        // transport might have been closed by packet handler
+        if (hci_transport_h5_active == 0) return;
+    }
+    hci_transport_h5_read_next();
 }
 
 static void hci_transport_h5_block_sent(void){
@@ -794,6 +892,9 @@ static void hci_transport_h5_block_sent(void){
     }
 
     hci_transport_link_run();
+
+    // packet has been sent and copied for retransmission
+    hci_transport_link_emit_packet_sent_if_ready();
 }
 
 static void hci_transport_h5_init(const void * transport_config){
@@ -819,6 +920,11 @@ static void hci_transport_h5_init(const void * transport_config){
     btstack_uart->init(&uart_config);
     btstack_uart->set_block_received(&hci_transport_h5_block_received);
     btstack_uart->set_block_sent(&hci_transport_h5_block_sent);
+
+    hci_transport_h5_read_bytes = (btstack_uart->receive_bytes != NULL) && (btstack_uart->set_bytes_received != NULL);
+    if (hci_transport_h5_read_bytes){
+        btstack_uart->set_bytes_received(&hci_transport_h5_bytes_received);
+    }
 }
 
 static int hci_transport_h5_open(void){
@@ -849,6 +955,10 @@ static int hci_transport_h5_open(void){
     // setup resend timeout
     hci_transport_link_update_resend_timeout(uart_config.baudrate);
 
+    // drop packets queued and partially sent before close
+    hci_transport_link_clear_queue();
+    slip_write_active = 0;
+
     // init slip parser state machine
     hci_transport_slip_init();
 
@@ -857,7 +967,7 @@ static int hci_transport_h5_open(void){
 
     // start receiving
     hci_transport_h5_active = 1;
-    hci_transport_h5_read_next_byte();
+    hci_transport_h5_read_next();
 
     return 0;
 }
@@ -872,7 +982,7 @@ static void hci_transport_h5_register_packet_handler(void (*handler)(uint8_t pac
 }
 
 static int hci_transport_h5_can_send_packet_now(uint8_t packet_type){
-    int res = !hci_transport_link_have_outgoing_packet() && (link_state == LINK_ACTIVE);
+    int res = (link_state == LINK_ACTIVE) && (link_tx_queue_len < link_tx_window_size) && (link_tx_packet_sent_pending == 0u);
     // log_info("can_send_packet_now: %u", res);
     return res;
 }
@@ -882,12 +992,18 @@ static int hci_transport_h5_send_packet(uint8_t packet_type, uint8_t *packet, in
         log_error("hci_transport_h5_send_packet called but in state %d", link_state);
         return -1;
     }
+#ifdef ENABLE_H5_SLIDING_WINDOW
+    if (size > HCI_OUTGOING_PACKET_BUFFER_SIZE){
+        log_error("hci_transport_h5_send_packet: packet with size %u too large", size);
+        return -1;
+    }
+#endif
 
     // store request
     hci_transport_h5_queue_packet(packet_type, packet, size);
 
-    // send wakeup first
-    if (link_peer_asleep){
+    // send wakeup first, queued packets are sent after woken was received
+    if (link_peer_asleep && (link_tx_queue_len == 1u)){
         hci_transport_h5_emit_sleep_state(0);
         if (btstack_uart_sleep_mode){
             log_info("disable UART sleep");
@@ -895,9 +1011,6 @@ static int hci_transport_h5_send_packet(uint8_t packet_type, uint8_t *packet, in
         }
         hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_WAKEUP;
         hci_transport_link_set_timer(LINK_WAKEUP_MS);
-    } else {
-        hci_transport_link_actions |= HCI_TRANSPORT_LINK_SEND_QUEUED_PACKET;
-        hci_transport_link_set_timer(link_resend_timeout_ms);
     }
     hci_transport_link_run();
     return 0;
@@ -51,6 +51,8 @@
 #include "btstack_debug.h"
 #include "btstack_event.h"
 #include "btstack_memory.h"
+#include "btstack_metrics.h"
+#include "btstack_trace.h"
 
 #ifdef ENABLE_LE_DATA_CHANNELS
 // TODO avoid dependency on higher layer: used to trigger pairing for outgoing connections
@@ -115,6 +117,9 @@ typedef enum {
 // Extended Response Timeout eXpired
 #define L2CAP_ERTX_TIMEOUT_MS 120000
 
+// RTX and ERTX timer can be delayed to share wake up with other timers
+#define L2CAP_RTX_TIMER_SLACK_MS 1000
+
 // nr of buffered acl packets in outgoing queue to get max performance 
 #define NR_BUFFERED_ACL_PACKETS 3
 
@@ -209,6 +214,7 @@ static uint8_t   sig_seq_nr  = 0xff;
 static l2cap_signaling_response_t signaling_responses[NR_PENDING_SIGNALING_RESPONSES];
 static int signaling_responses_pending;
 static btstack_packet_callback_registration_t hci_event_callback_registration;
+static uint8_t hci_event_mask[BTSTACK_EVENT_MASK_SIZE];
 
 #ifdef ENABLE_BLE
 // only used for connection parameter update events
@@ -282,6 +288,7 @@ static int l2cap_ertm_can_store_packet_now(l2cap_channel_t * channel){
 
 static void l2cap_ertm_retransmit_unacknowleded_frames(l2cap_channel_t * l2cap_channel){
     log_info("Retransmit unacknowleged frames");
+    BTSTACK_METRICS_ADD(l2cap_ertm_retransmissions, l2cap_channel->unacked_frames);
     l2cap_channel->unacked_frames = 0;;
     l2cap_channel->tx_send_index  = l2cap_channel->tx_read_index;
 }
@@ -906,9 +913,19 @@ void l2cap_init(void){
 #endif
     
     // 
-    // register callback with HCI
+    // register callback with HCI for handled events, events that allow to send,
+    // and events after which l2cap_run() may have new work (e.g. L2CAP_EVENT_TRIGGER_RUN from gap)
     //
+    static const uint8_t l2cap_hci_event_codes[] = {
+        BTSTACK_EVENT_STATE, BTSTACK_EVENT_NR_CONNECTIONS_CHANGED, HCI_EVENT_TRANSPORT_PACKET_SENT,
+        HCI_EVENT_NUMBER_OF_COMPLETED_PACKETS, HCI_EVENT_COMMAND_COMPLETE, HCI_EVENT_COMMAND_STATUS, HCI_EVENT_VENDOR_SPECIFIC,
+        HCI_EVENT_CONNECTION_COMPLETE, HCI_EVENT_DISCONNECTION_COMPLETE, HCI_EVENT_READ_REMOTE_SUPPORTED_FEATURES_COMPLETE,
+        HCI_EVENT_READ_REMOTE_EXTENDED_FEATURES_COMPLETE, HCI_EVENT_ENCRYPTION_CHANGE, HCI_EVENT_ENCRYPTION_KEY_REFRESH_COMPLETE,
+        HCI_EVENT_LE_META, GAP_EVENT_SECURITY_LEVEL, L2CAP_EVENT_TIMEOUT_CHECK, L2CAP_EVENT_TRIGGER_RUN,
+    };
+    btstack_event_mask_init(hci_event_mask, l2cap_hci_event_codes, sizeof(l2cap_hci_event_codes));
     hci_event_callback_registration.callback = &l2cap_hci_event_handler;
+    hci_event_callback_registration.event_mask = hci_event_mask;
     hci_add_event_handler(&hci_event_callback_registration);
 
     hci_register_acl_packet_handler(&l2cap_acl_handler);
@@ -983,6 +1000,8 @@ int l2cap_send_prepared_connectionless(hci_con_handle_t con_handle, uint16_t cid
     
     uint8_t *acl_buffer = hci_get_outgoing_packet_buffer();
     l2cap_setup_header(acl_buffer, con_handle, 0, cid, len);
+    BTSTACK_METRICS_INC(l2cap_tx_packets);
+    BTSTACK_METRICS_ADD(l2cap_tx_bytes, len);
     // send
     return hci_send_acl_packet_buffer(len+8u);
 }
@@ -1015,7 +1034,19 @@ static void l2cap_emit_can_send_now(btstack_packet_handler_t packet_handler, uin
 
 #ifdef L2CAP_USES_CHANNELS
 static void l2cap_dispatch_to_channel(l2cap_channel_t *channel, uint8_t type, uint8_t * data, uint16_t size){
+#ifdef ENABLE_BTSTACK_METRICS
+    if (type == L2CAP_DATA_PACKET){
+        channel->metrics.rx_packets++;
+        channel->metrics.rx_bytes += size;
+        BTSTACK_METRICS_INC(l2cap_rx_packets);
+        BTSTACK_METRICS_ADD(l2cap_rx_bytes, size);
+    }
+#endif
+    BTSTACK_TRACE_BEGIN(trace_start);
     (* (channel->packet_handler))(type, channel->local_cid, data, size);
+    if (type == L2CAP_DATA_PACKET){
+        BTSTACK_TRACE_END(trace_start, BTSTACK_TRACEPOINT_L2CAP_DELIVER, channel->con_handle, channel->local_cid);
+    }
 }
 
 static void l2cap_emit_simple_event_with_cid(l2cap_channel_t * channel, uint8_t event_code){
@@ -1177,6 +1208,15 @@ uint16_t l2cap_get_remote_mtu_for_local_cid(uint16_t local_cid){
 }
 #endif
 
+#if defined(L2CAP_USES_CHANNELS) && defined(ENABLE_BTSTACK_METRICS)
+uint8_t l2cap_get_channel_metrics(uint16_t local_cid, btstack_metrics_channel_t * metrics){
+    l2cap_channel_t * channel = l2cap_get_channel_for_local_cid(local_cid);
+    if (channel == NULL) return L2CAP_LOCAL_CID_DOES_NOT_EXIST;
+    *metrics = channel->metrics;
+    return ERROR_CODE_SUCCESS;
+}
+#endif
+
 #ifdef L2CAP_USES_CHANNELS
 static int l2cap_is_dynamic_channel_type(l2cap_channel_type_t channel_type){
     switch (channel_type){
@@ -1236,6 +1276,7 @@ static void l2cap_start_rtx(l2cap_channel_t * channel){
     log_info("l2cap_start_rtx for local cid 0x%02x", channel->local_cid);
     btstack_run_loop_set_timer_handler(&channel->rtx, l2cap_rtx_timeout);
     btstack_run_loop_set_timer(&channel->rtx, L2CAP_RTX_TIMEOUT_MS);
+    btstack_run_loop_set_timer_slack(&channel->rtx, L2CAP_RTX_TIMER_SLACK_MS);
     btstack_run_loop_add_timer(&channel->rtx);
 }
 
@@ -1244,6 +1285,7 @@ static void l2cap_start_ertx(l2cap_channel_t * channel){
     l2cap_stop_rtx(channel);
     btstack_run_loop_set_timer_handler(&channel->rtx, l2cap_rtx_timeout);
     btstack_run_loop_set_timer(&channel->rtx, L2CAP_ERTX_TIMEOUT_MS);
+    btstack_run_loop_set_timer_slack(&channel->rtx, L2CAP_RTX_TIMER_SLACK_MS);
     btstack_run_loop_add_timer(&channel->rtx);
 }
 
@@ -1316,6 +1358,13 @@ int l2cap_send_prepared(uint16_t local_cid, uint16_t len){
     }
 #endif
 
+#ifdef ENABLE_BTSTACK_METRICS
+    channel->metrics.tx_packets++;
+    channel->metrics.tx_bytes += len;
+    BTSTACK_METRICS_INC(l2cap_tx_packets);
+    BTSTACK_METRICS_ADD(l2cap_tx_bytes, len);
+#endif
+
     // send
     return hci_send_acl_packet_buffer(len+8+fcs_size);
 }
@@ -1637,6 +1686,7 @@ static void l2cap_run_for_classic_channel_ertm(l2cap_channel_t * channel){
             l2cap_ertm_tx_packet_state_t * tx_state = &channel->tx_packets_state[i];
             if (tx_state->retransmission_requested) {
                 tx_state->retransmission_requested = 0;
+                BTSTACK_METRICS_INC(l2cap_ertm_retransmissions);
                 uint8_t final = channel->set_final_bit_after_packet_with_poll_bit_set;
                 channel->set_final_bit_after_packet_with_poll_bit_set = 0;
                 l2cap_ertm_send_information_frame(channel, i, final);
@@ -3625,14 +3675,22 @@ static void l2cap_acl_le_handler(hci_con_handle_t handle, uint8_t *packet, uint1
             l2cap_fixed_channel = l2cap_fixed_channel_for_channel_id(L2CAP_CID_ATTRIBUTE_PROTOCOL);
             if (!l2cap_fixed_channel) break;
             if (!l2cap_fixed_channel->packet_handler) break;
+            BTSTACK_METRICS_INC(l2cap_rx_packets);
+            BTSTACK_METRICS_ADD(l2cap_rx_bytes, size - COMPLETE_L2CAP_HEADER);
+            BTSTACK_TRACE_BEGIN(trace_start_att);
             (*l2cap_fixed_channel->packet_handler)(ATT_DATA_PACKET, handle, &packet[COMPLETE_L2CAP_HEADER], size-COMPLETE_L2CAP_HEADER);
+            BTSTACK_TRACE_END(trace_start_att, BTSTACK_TRACEPOINT_L2CAP_DELIVER, handle, L2CAP_CID_ATTRIBUTE_PROTOCOL);
             break;
 
         case L2CAP_CID_SECURITY_MANAGER_PROTOCOL:
             l2cap_fixed_channel = l2cap_fixed_channel_for_channel_id(L2CAP_CID_SECURITY_MANAGER_PROTOCOL);
             if (!l2cap_fixed_channel) break;
             if (!l2cap_fixed_channel->packet_handler) break;
+            BTSTACK_METRICS_INC(l2cap_rx_packets);
+            BTSTACK_METRICS_ADD(l2cap_rx_bytes, size - COMPLETE_L2CAP_HEADER);
+            BTSTACK_TRACE_BEGIN(trace_start_sm);
             (*l2cap_fixed_channel->packet_handler)(SM_DATA_PACKET, handle, &packet[COMPLETE_L2CAP_HEADER], size-COMPLETE_L2CAP_HEADER);
+            BTSTACK_TRACE_END(trace_start_sm, BTSTACK_TRACEPOINT_L2CAP_DELIVER, handle, L2CAP_CID_SECURITY_MANAGER_PROTOCOL);
             break;
 
         default:
@@ -3881,6 +3939,17 @@ static void l2cap_le_send_pdu(l2cap_channel_t *channel){
 
     channel->credits_outgoing--;
 
+#ifdef ENABLE_BTSTACK_METRICS
+    channel->metrics.tx_packets++;
+    channel->metrics.tx_bytes += pos;
+    BTSTACK_METRICS_INC(l2cap_tx_packets);
+    BTSTACK_METRICS_ADD(l2cap_tx_bytes, pos);
+    if ((channel->credits_outgoing == 0u) && (channel->send_sdu_pos < (channel->send_sdu_len + 2u))){
+        channel->metrics.credit_stalls++;
+        BTSTACK_METRICS_INC(l2cap_credit_stalls);
+    }
+#endif
+
     hci_send_acl_packet_buffer(8u + pos);
 
     if (channel->send_sdu_pos >= (channel->send_sdu_len + 2u)){
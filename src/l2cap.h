@@ -384,6 +384,10 @@ typedef struct {
     uint8_t * tx_packets_data;
 
 #endif    
+
+#ifdef ENABLE_BTSTACK_METRICS
+    btstack_metrics_channel_t metrics;
+#endif
 } l2cap_channel_t;
 
 // info regarding potential connections
@@ -503,6 +507,14 @@ void l2cap_disconnect(uint16_t local_cid, uint8_t reason);
  */
 uint16_t l2cap_get_remote_mtu_for_local_cid(uint16_t local_cid);
 
+/**
+ * @brief Get number of packets and bytes sent and received on channel. Requires ENABLE_BTSTACK_METRICS
+ * @param local_cid
+ * @param metrics
+ * @return status ERROR_CODE_SUCCESS or L2CAP_LOCAL_CID_DOES_NOT_EXIST
+ */
+uint8_t l2cap_get_channel_metrics(uint16_t local_cid, btstack_metrics_channel_t * metrics);
+
 /** 
  * @brief Sends L2CAP data packet to the channel with given identifier.
  */
@@ -85,6 +85,7 @@ static void adv_bearer_run(void);
 // globals
 
 static btstack_packet_callback_registration_t hci_event_callback_registration;
+static uint8_t hci_event_mask[BTSTACK_EVENT_MASK_SIZE];
 static btstack_timer_source_t adv_timer;
 static int        adv_timer_active;
 static bd_addr_t null_addr;
@@ -310,7 +311,10 @@ static void adv_bearer_request(message_type_id_t type_id){
 
 void adv_bearer_init(void){
     // register for HCI Events
+    static const uint8_t adv_bearer_event_codes[] = { BTSTACK_EVENT_STATE, GAP_EVENT_ADVERTISING_REPORT };
+    btstack_event_mask_init(hci_event_mask, adv_bearer_event_codes, sizeof(adv_bearer_event_codes));
     hci_event_callback_registration.callback = &adv_bearer_packet_handler;
+    hci_event_callback_registration.event_mask = hci_event_mask;
     hci_add_event_handler(&hci_event_callback_registration);
     // idle
     adv_bearer_state = STATE_IDLE; 
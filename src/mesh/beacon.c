@@ -60,6 +60,9 @@
 #define BEACON_TYPE_SECURE_NETWORK 1
 
 #define UNPROVISIONED_BEACON_INTERVAL_MS 5000
+
+// beacon timers can be delayed to share wake up with other timers
+#define BEACON_TIMER_SLACK_MS 500
 #define UNPROVISIONED_BEACON_LEN      23
 
 #define SECURE_NETWORK_BEACON_INTERVAL_MIN_MS  10000
@@ -269,6 +272,7 @@ static void mesh_secure_network_beacon_run(btstack_timer_source_t * ts){
     if (next_timeout_ms == 0) return;
 
     btstack_run_loop_set_timer(&beacon_timer, next_timeout_ms);
+    btstack_run_loop_set_timer_slack(&beacon_timer, BEACON_TIMER_SLACK_MS);
     btstack_run_loop_set_timer_handler(&beacon_timer, mesh_secure_network_beacon_run);
     btstack_run_loop_add_timer(&beacon_timer);
     beacon_timer_active = 1;
@@ -471,6 +475,7 @@ void beacon_unprovisioned_device_start(const uint8_t * device_uuid, uint16_t oob
     if (device_uuid){
         beacon_device_uuid = device_uuid;
         beacon_timer.process = &beacon_timer_handler;
+        btstack_run_loop_set_timer_slack(&beacon_timer, BEACON_TIMER_SLACK_MS);
         btstack_run_loop_remove_timer(&beacon_timer);
         beacon_timer_handler(&beacon_timer);
     }
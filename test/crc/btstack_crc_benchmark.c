@@ -0,0 +1,108 @@
+// Measure cost of CRC calculations per byte
+// Build with 'make benchmark', which runs it with the default implementation and with ENABLE_CRC16_CCITT_SLICE_BY_4
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC
+#endif
+
+#include "btstack_util.h"
+
+#define PACKET_SIZE 1028
+#define NUM_ROUNDS  20000
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+// previous H5 implementation with 16 entry table for comparison
+static uint16_t crc16_ccitt_update_nibble(uint16_t crc, const uint8_t * data, uint16_t len){
+    static const uint16_t crc16_ccitt_table[] ={
+            0x0000, 0x1081, 0x2102, 0x3183,
+            0x4204, 0x5285, 0x6306, 0x7387,
+            0x8408, 0x9489, 0xa50a, 0xb58b,
+            0xc60c, 0xd68d, 0xe70e, 0xf78f
+    };
+    uint16_t i;
+    for (i = 0; i < len; i++){
+        crc = (crc >> 4u) ^ crc16_ccitt_table[(crc ^ data[i]) & 0x000fu];
+        crc = (crc >> 4u) ^ crc16_ccitt_table[(crc ^ (data[i] >> 4u)) & 0x000fu];
+    }
+    return crc;
+}
+
+static uint8_t packet[PACKET_SIZE];
+static volatile uint16_t crc_sink;
+
+static uint64_t get_time_ns(void){
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    return ((uint64_t) now_ts.tv_sec * 1000000000u) + (uint64_t) now_ts.tv_nsec;
+}
+
+static uint64_t get_cycles(void){
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void report(const char * name, uint64_t duration_ns, uint64_t duration_cycles, uint32_t num_bytes){
+    printf("%-40s %6.2f ns/byte", name, (double) duration_ns / num_bytes);
+#ifdef HAVE_TSC
+    printf(", %6.2f cycles/byte", (double) duration_cycles / num_bytes);
+#else
+    UNUSED(duration_cycles);
+#endif
+    printf("\n");
+}
+
+static void benchmark_crc16(const char * name, uint16_t (*crc16_update)(uint16_t crc, const uint8_t * data, uint16_t len)){
+    uint64_t start_ns = get_time_ns();
+    uint64_t start_cycles = get_cycles();
+    int round;
+    for (round = 0; round < NUM_ROUNDS; round++){
+        crc_sink = (*crc16_update)(0xffff, packet, PACKET_SIZE);
+    }
+    report(name, get_time_ns() - start_ns, get_cycles() - start_cycles, NUM_ROUNDS * PACKET_SIZE);
+}
+
+static void benchmark_crc8(void){
+    // address, control and length of RFCOMM UIH frame
+    uint8_t header[3];
+    uint64_t start_ns = get_time_ns();
+    uint64_t start_cycles = get_cycles();
+    int round;
+    for (round = 0; round < NUM_ROUNDS; round++){
+        header[0] = (uint8_t) round;
+        header[1] = 0xef;
+        header[2] = (uint8_t) (round >> 8);
+        crc_sink = btstack_crc8_calc(header, sizeof(header));
+    }
+    report("btstack_crc8_calc (3 byte header)", get_time_ns() - start_ns, get_cycles() - start_cycles, NUM_ROUNDS * sizeof(header));
+}
+
+int main(void){
+    uint16_t i;
+    srand(1);
+    for (i = 0; i < PACKET_SIZE; i++){
+        packet[i] = (uint8_t) rand();
+    }
+    if (crc16_ccitt_update_nibble(0xffff, packet, PACKET_SIZE) != btstack_crc16_ccitt_update(0xffff, packet, PACKET_SIZE)){
+        printf("error: CRC mismatch\n");
+        return 1;
+    }
+#ifdef ENABLE_CRC16_CCITT_SLICE_BY_4
+    printf("ENABLE_CRC16_CCITT_SLICE_BY_4\n");
+#endif
+    benchmark_crc16("CRC16-CCITT 16 entry table", &crc16_ccitt_update_nibble);
+    benchmark_crc16("btstack_crc16_ccitt_update", &btstack_crc16_ccitt_update);
+    benchmark_crc8();
+    return 0;
+}
@@ -0,0 +1,80 @@
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "btstack_util.h"
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+// bitwise reference
+static uint16_t crc16_ccitt_reference(uint16_t crc, const uint8_t * data, uint16_t len){
+    uint16_t i;
+    for (i = 0; i < len; i++){
+        crc ^= data[i];
+        int bit;
+        for (bit = 0; bit < 8; bit++){
+            crc = (crc & 1u) ? ((crc >> 1) ^ 0x8408u) : (crc >> 1);
+        }
+    }
+    return crc;
+}
+
+TEST_GROUP(CRC16){
+};
+
+TEST(CRC16, CheckValue){
+    const char * check = "123456789";
+    // CRC-16/X-25 check value 0x906e without final xor
+    CHECK_EQUAL(0x906e ^ 0xffff, btstack_crc16_ccitt_update(0xffff, (const uint8_t *) check, 9));
+}
+
+TEST(CRC16, Empty){
+    CHECK_EQUAL(0x1234, btstack_crc16_ccitt_update(0x1234, NULL, 0));
+}
+
+TEST(CRC16, Reference){
+    uint8_t data[300];
+    srand(1);
+    uint16_t i;
+    for (i = 0; i < sizeof(data); i++){
+        data[i] = (uint8_t) rand();
+    }
+    uint16_t len;
+    for (len = 0; len < sizeof(data); len++){
+        CHECK_EQUAL(crc16_ccitt_reference(0xffff, data, len), btstack_crc16_ccitt_update(0xffff, data, len));
+    }
+}
+
+TEST(CRC16, Split){
+    uint8_t data[64];
+    uint16_t i;
+    for (i = 0; i < sizeof(data); i++){
+        data[i] = (uint8_t) (i * 37u);
+    }
+    uint16_t expected = btstack_crc16_ccitt_update(0xffff, data, sizeof(data));
+    for (i = 0; i <= sizeof(data); i++){
+        uint16_t crc = btstack_crc16_ccitt_update(0xffff, data, i);
+        crc = btstack_crc16_ccitt_update(crc, &data[i], sizeof(data) - i);
+        CHECK_EQUAL(expected, crc);
+    }
+}
+
+TEST_GROUP(CRC8){
+};
+
+TEST(CRC8, RfcommFrame){
+    // SABM on DLCI 0: address 0x03, control 0x3f, length 0x01 -> FCS 0x1c
+    uint8_t header[] = { 0x03, 0x3f, 0x01 };
+    CHECK_EQUAL(0x1c, btstack_crc8_calc(header, sizeof(header)));
+    CHECK_EQUAL(0, btstack_crc8_check(header, sizeof(header), 0x1c));
+    CHECK_EQUAL(1, btstack_crc8_check(header, sizeof(header), 0x1d));
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,122 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "btstack_memory.h"
+#include "btstack_util.h"
+#include "hci.h"
+#include "hci_dump.h"
+#include "l2cap.h"
+#include "btstack_debug.h"
+
+typedef struct {
+    uint8_t type;
+    uint16_t size;
+    uint8_t  buffer[258];
+} hci_packet_t;
+
+#define MAX_HCI_PACKETS 10
+static uint16_t transport_count_packets;
+static hci_packet_t transport_packets[MAX_HCI_PACKETS];
+
+static  void (*packet_handler)(uint8_t packet_type, uint8_t *packet, uint16_t size);
+
+static const uint8_t packet_sent_event[] = { HCI_EVENT_TRANSPORT_PACKET_SENT, 0};
+
+// LE Read Buffer Size Command Complete: 27 bytes, 2 packets
+static const uint8_t le_read_buffer_size_complete[] = { 0x0e, 0x07, 0x01, 0x02, 0x20, 0x00, 0x1b, 0x00, 0x02 };
+
+// LE Connection Complete: handle 0x0040, role slave, public address
+static const uint8_t le_connection_complete[] = {
+    0x3e, 0x13, 0x01, 0x00, 0x40, 0x00, 0x01, 0x00, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+    0x28, 0x00, 0x00, 0x00, 0x48, 0x00, 0x00
+};
+
+static const hci_con_handle_t con_handle = 0x0040;
+
+static int hci_transport_test_set_baudrate(uint32_t baudrate){
+    return 0;
+}
+
+static int hci_transport_test_can_send_now(uint8_t packet_type){
+    return 1;
+}
+
+static int hci_transport_test_send_packet(uint8_t packet_type, uint8_t * packet, int size){
+    btstack_assert(transport_count_packets < MAX_HCI_PACKETS);
+    memcpy(transport_packets[transport_count_packets].buffer, packet, size);
+    transport_packets[transport_count_packets].type = packet_type;
+    transport_packets[transport_count_packets].size = size;
+    transport_count_packets++;
+    // notify upper stack that it can send again
+    packet_handler(HCI_EVENT_PACKET, (uint8_t *) &packet_sent_event[0], sizeof(packet_sent_event));
+    return 0;
+}
+
+static void hci_transport_test_init(const void * transport_config){
+}
+
+static int hci_transport_test_open(void){
+    return 0;
+}
+
+static int hci_transport_test_close(void){
+    return 0;
+}
+
+static void hci_transport_test_register_packet_handler(void (*handler)(uint8_t packet_type, uint8_t *packet, uint16_t size)){
+    packet_handler = handler;
+}
+
+static const hci_transport_t hci_transport_test = {
+        /* const char * name; */                                        "TEST",
+        /* void   (*init) (const void *transport_config); */            &hci_transport_test_init,
+        /* int    (*open)(void); */                                     &hci_transport_test_open,
+        /* int    (*close)(void); */                                    &hci_transport_test_close,
+        /* void   (*register_packet_handler)(void (*handler)(...); */   &hci_transport_test_register_packet_handler,
+        /* int    (*can_send_packet_now)(uint8_t packet_type); */       &hci_transport_test_can_send_now,
+        /* int    (*send_packet)(...); */                               &hci_transport_test_send_packet,
+        /* int    (*set_baudrate)(uint32_t baudrate); */                &hci_transport_test_set_baudrate,
+        /* void   (*reset_link)(void); */                               NULL,
+        /* void   (*set_sco_config)(uint16_t voice_setting, int num_connections); */ NULL,
+};
+
+TEST_GROUP(L2CAP_LE_SIGNALING){
+        void setup(void){
+            transport_count_packets = 0;
+            btstack_memory_init();
+            hci_init(&hci_transport_test, NULL);
+            l2cap_init();
+            hci_simulate_working_fuzz();
+            packet_handler(HCI_EVENT_PACKET, (uint8_t *) le_read_buffer_size_complete, sizeof(le_read_buffer_size_complete));
+            packet_handler(HCI_EVENT_PACKET, (uint8_t *) le_connection_complete, sizeof(le_connection_complete));
+            transport_count_packets = 0;
+        }
+};
+
+TEST(L2CAP_LE_SIGNALING, ConnectionParameterUpdateRequest){
+    log_info("TEST(L2CAP_LE_SIGNALING, ConnectionParameterUpdateRequest)");
+    CHECK_EQUAL(0, gap_request_connection_parameter_update(con_handle, 0x18, 0x28, 0, 0x48));
+    // single LE signaling packet with Connection Parameter Update Request
+    CHECK_EQUAL(1, transport_count_packets);
+    const uint8_t * packet = transport_packets[0].buffer;
+    CHECK_EQUAL(HCI_ACL_DATA_PACKET, transport_packets[0].type);
+    CHECK_EQUAL(con_handle, little_endian_read_16(packet, 0) & 0x0fff);
+    CHECK_EQUAL(L2CAP_CID_SIGNALING_LE, little_endian_read_16(packet, 6));
+    CHECK_EQUAL(CONNECTION_PARAMETER_UPDATE_REQUEST, packet[8]);
+    CHECK_EQUAL(0x18, little_endian_read_16(packet, 12));
+    CHECK_EQUAL(0x28, little_endian_read_16(packet, 14));
+    CHECK_EQUAL(0,    little_endian_read_16(packet, 16));
+    CHECK_EQUAL(0x48, little_endian_read_16(packet, 18));
+}
+
+int main (int argc, const char * argv[]){
+    const char * log_path = "/tmp/test_le_l2cap_signaling.pklg";
+    printf("Log: %s\n", log_path);
+    hci_dump_open(log_path, HCI_DUMP_PACKETLOGGER);
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
@@ -0,0 +1,656 @@
+/*
+ * hci_transport_h5_test.c
+ *
+ * Runs H5 transport against a Three-Wire UART peer emulator over a simulated UART
+ * with fixed baud rate and latency. Time is simulated, timers use btstack_run_loop_base.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include "hci.h"
+#include "hci_transport.h"
+#include "btstack_run_loop.h"
+#include "btstack_run_loop_base.h"
+#include "btstack_uart_block.h"
+#include "btstack_util.h"
+
+#if defined(ENABLE_H5_SLIDING_WINDOW) && defined(HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE)
+#define HOST_SLIDING_WINDOW_SIZE HCI_TRANSPORT_H5_SLIDING_WINDOW_SIZE
+#elif defined(ENABLE_H5_SLIDING_WINDOW)
+#define HOST_SLIDING_WINDOW_SIZE 4
+#else
+#define HOST_SLIDING_WINDOW_SIZE 1
+#endif
+
+#define SIM_BAUDRATE        921600
+// delay between UART write and read, e.g. USB serial adapter
+#define SIM_LATENCY_US      4000
+#define SIM_NUM_CHUNKS      64
+#define SIM_CHUNK_SIZE      300
+#define SIM_MAX_DROPS       4
+
+#define NUM_ACL_PACKETS     100
+#define ACL_PACKET_SIZE     (HCI_ACL_HEADER_SIZE + HCI_ACL_PAYLOAD_SIZE)
+
+// H5 link control messages
+#define LINK_CONTROL_PACKET_TYPE  0x0f
+#define LINK_ACKNOWLEDGEMENT_TYPE 0x00
+static const uint8_t link_control_sync[]            = { 0x01, 0x7e };
+static const uint8_t link_control_sync_response[]   = { 0x02, 0x7d };
+static const uint8_t link_control_config[]          = { 0x03, 0xfc };
+static const uint8_t link_control_config_response[] = { 0x04, 0x7b };
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+// simulated time
+
+static uint64_t sim_time_us;
+
+static uint32_t sim_get_time_ms(void){
+    return (uint32_t) (sim_time_us / 1000u);
+}
+
+static void sim_set_timer(btstack_timer_source_t * ts, uint32_t timeout_in_ms){
+    ts->timeout = sim_get_time_ms() + timeout_in_ms;
+}
+
+static const btstack_run_loop_t sim_run_loop = {
+    &btstack_run_loop_base_init,
+    NULL,
+    NULL,
+    NULL,
+    NULL,
+    &sim_set_timer,
+    &btstack_run_loop_base_add_timer,
+    &btstack_run_loop_base_remove_timer,
+    NULL,
+    NULL,
+    &sim_get_time_ms,
+    NULL,
+};
+
+// UART wire for one direction: written chunks become readable after transmission time + latency
+
+typedef struct {
+    uint64_t arrival_us;
+    uint16_t len;
+    uint8_t  data[SIM_CHUNK_SIZE];
+} sim_chunk_t;
+
+typedef struct {
+    sim_chunk_t chunks[SIM_NUM_CHUNKS];
+    uint16_t head;
+    uint16_t count;
+    uint16_t read_pos;
+    uint64_t tx_done_us;
+} sim_wire_t;
+
+static sim_wire_t wire_to_peer;
+static sim_wire_t wire_to_host;
+
+static void sim_wire_write(sim_wire_t * wire, const uint8_t * data, uint16_t len){
+    CHECK(len <= SIM_CHUNK_SIZE);
+    CHECK(wire->count < SIM_NUM_CHUNKS);
+    uint64_t start_us = ((wire->tx_done_us > sim_time_us) ? wire->tx_done_us : sim_time_us);
+    wire->tx_done_us = start_us + ((uint64_t) len * 10u * 1000000u) / SIM_BAUDRATE;
+    sim_chunk_t * chunk = &wire->chunks[(wire->head + wire->count) % SIM_NUM_CHUNKS];
+    chunk->arrival_us = wire->tx_done_us + SIM_LATENCY_US;
+    chunk->len = len;
+    memcpy(chunk->data, data, len);
+    wire->count++;
+}
+
+static bool sim_wire_readable(const sim_wire_t * wire){
+    if (wire->count == 0u) return false;
+    return wire->chunks[wire->head].arrival_us <= sim_time_us;
+}
+
+static uint16_t sim_wire_read(sim_wire_t * wire, uint8_t * buffer, uint16_t max_len){
+    sim_chunk_t * chunk = &wire->chunks[wire->head];
+    uint16_t len = btstack_min(max_len, chunk->len - wire->read_pos);
+    memcpy(buffer, &chunk->data[wire->read_pos], len);
+    wire->read_pos += len;
+    if (wire->read_pos == chunk->len){
+        wire->read_pos = 0;
+        wire->head = (wire->head + 1u) % SIM_NUM_CHUNKS;
+        wire->count--;
+    }
+    return len;
+}
+
+// UART driver for H5 transport
+
+static void (*uart_block_received)(void);
+static void (*uart_block_sent)(void);
+static void (*uart_bytes_received)(uint16_t num_bytes);
+static uint8_t * uart_read_buffer;
+static uint16_t  uart_read_len;
+static bool      uart_read_bytes;
+static bool      uart_read_pending;
+static bool      uart_write_active;
+static uint32_t  uart_num_writes;
+
+static int uart_init(const btstack_uart_config_t * config){
+    UNUSED(config);
+    return 0;
+}
+
+static int uart_open(void){
+    return 0;
+}
+
+static int uart_close(void){
+    return 0;
+}
+
+static void uart_set_block_received(void (*handler)(void)){
+    uart_block_received = handler;
+}
+
+static void uart_set_block_sent(void (*handler)(void)){
+    uart_block_sent = handler;
+}
+
+static void uart_set_bytes_received(void (*handler)(uint16_t num_bytes)){
+    uart_bytes_received = handler;
+}
+
+static int uart_set_baudrate(uint32_t baudrate){
+    UNUSED(baudrate);
+    return 0;
+}
+
+static int uart_set_parity(int parity){
+    UNUSED(parity);
+    return 0;
+}
+
+static void uart_receive_block(uint8_t * buffer, uint16_t len){
+    uart_read_buffer  = buffer;
+    uart_read_len     = len;
+    uart_read_bytes   = false;
+    uart_read_pending = true;
+}
+
+static void uart_receive_bytes(uint8_t * buffer, uint16_t max_len){
+    uart_read_buffer  = buffer;
+    uart_read_len     = max_len;
+    uart_read_bytes   = true;
+    uart_read_pending = true;
+}
+
+static void uart_send_block(const uint8_t * buffer, uint16_t len){
+    CHECK(uart_write_active == false);
+    uart_write_active = true;
+    uart_num_writes++;
+    sim_wire_write(&wire_to_peer, buffer, len);
+}
+
+static const btstack_uart_block_t uart_driver = {
+    &uart_init,
+    &uart_open,
+    &uart_close,
+    &uart_set_block_received,
+    &uart_set_block_sent,
+    &uart_set_baudrate,
+    &uart_set_parity,
+    NULL,
+    &uart_receive_block,
+    &uart_send_block,
+    NULL,
+    NULL,
+    NULL,
+    &uart_set_bytes_received,
+    &uart_receive_bytes,
+};
+
+// Three-Wire UART peer emulator, acknowledges every reliable packet right away, no data integrity check
+
+typedef struct {
+    uint8_t  sliding_window_size;
+    uint8_t  host_config_field;
+    uint8_t  host_config_response_field;
+    bool     host_config_response_received;
+    // reliable packets from host
+    uint8_t  ack_nr;
+    uint16_t num_reliable_frames;
+    uint16_t drop_frames[SIM_MAX_DROPS];
+    uint16_t num_drop_frames;
+    uint16_t num_out_of_sequence;
+    uint16_t num_packets;
+    uint32_t num_bytes;
+    uint64_t last_packet_us;
+    bool     packet_content_ok;
+    // reliable packets to host
+    uint8_t  seq_nr;
+    uint8_t  host_ack_nr;
+    // slip decoder
+    uint8_t  frame[SIM_CHUNK_SIZE + ACL_PACKET_SIZE];
+    uint16_t frame_len;
+    bool     frame_escape;
+} sim_peer_t;
+
+static sim_peer_t peer;
+
+static void sim_peer_send_frame(uint8_t seq_nr, uint8_t reliable, uint8_t packet_type, const uint8_t * payload, uint16_t payload_len){
+    uint8_t frame[SIM_CHUNK_SIZE];
+    uint8_t header[4];
+    header[0] = seq_nr | (peer.ack_nr << 3) | (reliable << 7);
+    header[1] = packet_type | ((payload_len & 0x0fu) << 4);
+    header[2] = payload_len >> 4;
+    header[3] = 0xffu - (header[0] + header[1] + header[2]);
+    uint16_t pos = 0;
+    frame[pos++] = 0xc0;
+    uint16_t i;
+    for (i = 0; i < (4u + payload_len); i++){
+        uint8_t data = (i < 4u) ? header[i] : payload[i - 4u];
+        switch (data){
+            case 0xc0:
+                frame[pos++] = 0xdb;
+                frame[pos++] = 0xdc;
+                break;
+            case 0xdb:
+                frame[pos++] = 0xdb;
+                frame[pos++] = 0xdd;
+                break;
+            default:
+                frame[pos++] = data;
+                break;
+        }
+    }
+    frame[pos++] = 0xc0;
+    sim_wire_write(&wire_to_host, frame, pos);
+}
+
+static void sim_peer_send_control(const uint8_t * message, uint16_t message_len){
+    sim_peer_send_frame(0, 0, LINK_CONTROL_PACKET_TYPE, message, message_len);
+}
+
+static void sim_peer_send_event(uint8_t seq_nr, uint8_t event_code){
+    uint8_t event[] = { event_code, 1, seq_nr };
+    sim_peer_send_frame(seq_nr, 1, HCI_EVENT_PACKET, event, sizeof(event));
+}
+
+static void sim_peer_send_ack(void){
+    sim_peer_send_frame(0, 0, LINK_ACKNOWLEDGEMENT_TYPE, NULL, 0);
+}
+
+static bool sim_peer_drop_frame(void){
+    uint16_t i;
+    for (i = 0; i < peer.num_drop_frames; i++){
+        if (peer.drop_frames[i] == peer.num_reliable_frames) return true;
+    }
+    return false;
+}
+
+static void sim_peer_verify_acl_packet(const uint8_t * packet, uint16_t size){
+    uint16_t i;
+    if (size != ACL_PACKET_SIZE){
+        peer.packet_content_ok = false;
+        return;
+    }
+    for (i = 0; i < size; i++){
+        if (packet[i] != (uint8_t) (peer.num_packets * 7u + i)){
+            peer.packet_content_ok = false;
+            return;
+        }
+    }
+}
+
+static void sim_peer_process_frame(void){
+    const uint8_t * header  = peer.frame;
+    const uint8_t * payload = &peer.frame[4];
+    CHECK(peer.frame_len >= 4u);
+    CHECK_EQUAL(0xff, (uint8_t) (header[0] + header[1] + header[2] + header[3]));
+    // no data integrity check negotiated
+    CHECK_EQUAL(0, header[0] & 0x40u);
+
+    uint8_t  seq_nr      = header[0] & 0x07u;
+    uint8_t  ack_nr      = (header[0] >> 3) & 0x07u;
+    bool     reliable    = (header[0] & 0x80u) != 0u;
+    uint8_t  packet_type = header[1] & 0x0fu;
+    uint16_t payload_len = (header[1] >> 4) | (header[2] << 4);
+    CHECK_EQUAL(peer.frame_len - 4u, payload_len);
+
+    if (reliable){
+        bool drop = sim_peer_drop_frame();
+        peer.num_reliable_frames++;
+        if (drop) return;
+    }
+
+    if (reliable || (packet_type == LINK_ACKNOWLEDGEMENT_TYPE)){
+        peer.host_ack_nr = ack_nr;
+    }
+
+    if (packet_type == LINK_CONTROL_PACKET_TYPE){
+        if (memcmp(payload, link_control_sync, sizeof(link_control_sync)) == 0){
+            sim_peer_send_control(link_control_sync_response, sizeof(link_control_sync_response));
+        } else if (memcmp(payload, link_control_config, sizeof(link_control_config)) == 0){
+            CHECK_EQUAL(3, payload_len);
+            peer.host_config_field = payload[2];
+            uint8_t config_response[3];
+            memcpy(config_response, link_control_config_response, 2);
+            config_response[2] = btstack_min(payload[2] & 0x07u, peer.sliding_window_size);
+            sim_peer_send_control(config_response, sizeof(config_response));
+        } else if (memcmp(payload, link_control_config_response, sizeof(link_control_config_response)) == 0){
+            CHECK_EQUAL(3, payload_len);
+            peer.host_config_response_field = payload[2];
+            peer.host_config_response_received = true;
+        }
+        return;
+    }
+
+    if (!reliable) return;
+
+    if (seq_nr != peer.ack_nr){
+        peer.num_out_of_sequence++;
+    } else {
+        peer.ack_nr = (peer.ack_nr + 1u) & 0x07u;
+        if (packet_type == HCI_ACL_DATA_PACKET){
+            sim_peer_verify_acl_packet(payload, payload_len);
+            peer.num_packets++;
+            peer.num_bytes += payload_len;
+            peer.last_packet_us = sim_time_us;
+        }
+    }
+    sim_peer_send_ack();
+}
+
+static void sim_peer_process_byte(uint8_t data){
+    switch (data){
+        case 0xc0:
+            if (peer.frame_len > 0u){
+                sim_peer_process_frame();
+            }
+            peer.frame_len = 0;
+            peer.frame_escape = false;
+            return;
+        case 0xdb:
+            peer.frame_escape = true;
+            return;
+        default:
+            break;
+    }
+    if (peer.frame_escape){
+        peer.frame_escape = false;
+        data = (data == 0xdc) ? 0xc0 : 0xdb;
+    }
+    CHECK(peer.frame_len < sizeof(peer.frame));
+    peer.frame[peer.frame_len++] = data;
+}
+
+// HCI layer: sends ACL packets from a single packet buffer that is released by HCI_EVENT_TRANSPORT_PACKET_SENT
+
+static const hci_transport_t * transport;
+static uint8_t  app_packet[HCI_OUTGOING_PACKET_BUFFER_SIZE];
+static bool     app_link_active;
+static bool     app_buffer_free;
+static uint16_t app_num_packets_to_send;
+static uint16_t app_num_packets_sent;
+static uint16_t app_num_packets_sent_events;
+static uint8_t  app_events[10];
+static uint16_t app_num_events;
+
+static void app_packet_handler(uint8_t packet_type, uint8_t * packet, uint16_t size){
+    UNUSED(size);
+    if (packet_type != HCI_EVENT_PACKET) return;
+    switch (packet[0]){
+        case HCI_EVENT_TRANSPORT_PACKET_SENT:
+            if (app_link_active){
+                CHECK(app_buffer_free == false);
+                app_num_packets_sent_events++;
+            }
+            app_link_active = true;
+            app_buffer_free = true;
+            break;
+        case HCI_EVENT_VENDOR_SPECIFIC:
+            CHECK(app_num_events < sizeof(app_events));
+            app_events[app_num_events++] = packet[2];
+            break;
+        default:
+            break;
+    }
+}
+
+static void app_run(void){
+    if (app_buffer_free == false) return;
+    if (app_num_packets_sent == app_num_packets_to_send) return;
+    if (!transport->can_send_packet_now(HCI_ACL_DATA_PACKET)) return;
+    uint16_t i;
+    for (i = 0; i < ACL_PACKET_SIZE; i++){
+        app_packet[i] = (uint8_t) (app_num_packets_sent * 7u + i);
+    }
+    app_buffer_free = false;
+    app_num_packets_sent++;
+    CHECK_EQUAL(0, transport->send_packet(HCI_ACL_DATA_PACKET, app_packet, ACL_PACKET_SIZE));
+}
+
+// process next event in simulated time, but not after end_us
+
+static void sim_step(uint64_t end_us){
+    app_run();
+
+    uint64_t next_us = end_us;
+    if (uart_write_active && (wire_to_peer.tx_done_us < next_us)){
+        next_us = wire_to_peer.tx_done_us;
+    }
+    if ((wire_to_peer.count > 0u) && (wire_to_peer.chunks[wire_to_peer.head].arrival_us < next_us)){
+        next_us = wire_to_peer.chunks[wire_to_peer.head].arrival_us;
+    }
+    if (uart_read_pending && (wire_to_host.count > 0u) && (wire_to_host.chunks[wire_to_host.head].arrival_us < next_us)){
+        next_us = wire_to_host.chunks[wire_to_host.head].arrival_us;
+    }
+    int32_t timeout_ms = btstack_run_loop_base_get_time_until_timeout(sim_get_time_ms());
+    if (timeout_ms >= 0){
+        uint64_t timeout_us = ((uint64_t) sim_get_time_ms() + (uint32_t) timeout_ms) * 1000u;
+        if (timeout_us < next_us){
+            next_us = timeout_us;
+        }
+    }
+    CHECK(next_us != UINT64_MAX);
+    if (next_us > sim_time_us){
+        sim_time_us = next_us;
+    }
+
+    if (uart_write_active && (wire_to_peer.tx_done_us <= sim_time_us)){
+        uart_write_active = false;
+        (*uart_block_sent)();
+    }
+    while (sim_wire_readable(&wire_to_peer)){
+        uint8_t data;
+        sim_wire_read(&wire_to_peer, &data, 1);
+        sim_peer_process_byte(data);
+    }
+    if (uart_read_pending && sim_wire_readable(&wire_to_host)){
+        uart_read_pending = false;
+        uint16_t len = sim_wire_read(&wire_to_host, uart_read_buffer, uart_read_len);
+        if (uart_read_bytes){
+            (*uart_bytes_received)(len);
+        } else {
+            (*uart_block_received)();
+        }
+    }
+    btstack_run_loop_base_process_timers(sim_get_time_ms());
+}
+
+static void sim_run_until_link_active(void){
+    while (!app_link_active){
+        sim_step(UINT64_MAX);
+        CHECK(sim_time_us < 10000000u);
+    }
+}
+
+static void sim_run_until_packets_received(uint16_t num_packets){
+    while (peer.num_packets < num_packets){
+        sim_step(UINT64_MAX);
+        CHECK(sim_time_us < 60000000u);
+    }
+}
+
+static void sim_run_for(uint32_t duration_ms){
+    uint64_t end_us = sim_time_us + (uint64_t) duration_ms * 1000u;
+    while (sim_time_us < end_us){
+        sim_step(end_us);
+    }
+}
+
+static void sim_send_acl_packets(uint16_t num_packets){
+    app_num_packets_to_send += num_packets;
+    sim_run_until_packets_received(app_num_packets_to_send);
+    // wait for acknowledgements
+    sim_run_for(100);
+}
+
+// returns number of ACL bytes received by peer per second
+static uint32_t sim_measure_throughput(uint16_t num_packets){
+    uint64_t start_us = sim_time_us;
+    uint32_t start_bytes = peer.num_bytes;
+    sim_send_acl_packets(num_packets);
+    return (uint32_t) ((uint64_t) (peer.num_bytes - start_bytes) * 1000000u / (peer.last_packet_us - start_us));
+}
+
+static void sim_setup(uint8_t peer_sliding_window_size){
+    sim_time_us = 1000000u;
+    memset(&wire_to_peer, 0, sizeof(wire_to_peer));
+    memset(&wire_to_host, 0, sizeof(wire_to_host));
+    memset(&peer, 0, sizeof(peer));
+    peer.sliding_window_size = peer_sliding_window_size;
+    peer.packet_content_ok = true;
+    uart_read_pending = false;
+    uart_write_active = false;
+    uart_num_writes = 0;
+    app_link_active = false;
+    app_buffer_free = false;
+    app_num_packets_to_send = 0;
+    app_num_packets_sent = 0;
+    app_num_packets_sent_events = 0;
+    app_num_events = 0;
+
+    static bool run_loop_initialized = false;
+    if (run_loop_initialized){
+        btstack_run_loop_base_init();
+    } else {
+        run_loop_initialized = true;
+        btstack_run_loop_init(&sim_run_loop);
+    }
+
+    static hci_transport_config_uart_t config = {
+        HCI_TRANSPORT_CONFIG_UART,
+        SIM_BAUDRATE,
+        0,
+        1,
+        NULL
+    };
+    transport = hci_transport_h5_instance(&uart_driver);
+    transport->init(&config);
+    transport->register_packet_handler(&app_packet_handler);
+    transport->open();
+}
+
+TEST_GROUP(H5){
+    void setup(void){
+        sim_setup(7);
+    }
+};
+
+TEST(H5, LinkEstablishment){
+    sim_run_until_link_active();
+    CHECK_EQUAL(HOST_SLIDING_WINDOW_SIZE | 0x10, peer.host_config_field);
+    CHECK(transport->can_send_packet_now(HCI_ACL_DATA_PACKET));
+}
+
+TEST(H5, SendPackets){
+    sim_run_until_link_active();
+    sim_send_acl_packets(NUM_ACL_PACKETS);
+    CHECK_EQUAL(NUM_ACL_PACKETS, peer.num_packets);
+    CHECK_EQUAL(NUM_ACL_PACKETS, app_num_packets_sent_events);
+    CHECK_TRUE(peer.packet_content_ok);
+    CHECK_EQUAL(0, peer.num_out_of_sequence);
+    // all packets acknowledged
+    CHECK(transport->can_send_packet_now(HCI_ACL_DATA_PACKET));
+    CHECK_EQUAL(0, wire_to_peer.count);
+}
+
+TEST(H5, RetransmitDroppedPackets){
+    peer.drop_frames[0] = 3;
+    peer.drop_frames[1] = 10;
+    peer.drop_frames[2] = 11;
+    peer.num_drop_frames = 3;
+    sim_run_until_link_active();
+    sim_send_acl_packets(20);
+    CHECK_EQUAL(20, peer.num_packets);
+    CHECK_EQUAL(20, app_num_packets_sent_events);
+    CHECK_TRUE(peer.packet_content_ok);
+#ifdef ENABLE_H5_SLIDING_WINDOW
+    // packets sent after dropped packet are dropped by peer and resent
+    CHECK(peer.num_out_of_sequence > 0u);
+#else
+    CHECK_EQUAL(0, peer.num_out_of_sequence);
+#endif
+}
+
+TEST(H5, ReceiveOutOfSequence){
+    sim_run_until_link_active();
+    sim_peer_send_event(0, HCI_EVENT_VENDOR_SPECIFIC);
+    // seq nr 1 is missing
+    sim_peer_send_event(2, HCI_EVENT_VENDOR_SPECIFIC);
+    sim_run_for(50);
+    CHECK_EQUAL(1, app_num_events);
+    CHECK_EQUAL(1, peer.host_ack_nr);
+    // peer resends from seq nr 1
+    sim_peer_send_event(1, HCI_EVENT_VENDOR_SPECIFIC);
+    sim_peer_send_event(2, HCI_EVENT_VENDOR_SPECIFIC);
+    // duplicate
+    sim_peer_send_event(2, HCI_EVENT_VENDOR_SPECIFIC);
+    sim_run_for(50);
+    CHECK_EQUAL(3, app_num_events);
+    CHECK_EQUAL(0, app_events[0]);
+    CHECK_EQUAL(1, app_events[1]);
+    CHECK_EQUAL(2, app_events[2]);
+    CHECK_EQUAL(3, peer.host_ack_nr);
+}
+
+TEST(H5, ConfigResponseToPeerConfig){
+    sim_run_until_link_active();
+    // peer supports sliding window 2 and data integrity check
+    const uint8_t config[] = { link_control_config[0], link_control_config[1], 0x12 };
+    sim_peer_send_control(config, sizeof(config));
+    sim_run_for(50);
+    CHECK_TRUE(peer.host_config_response_received);
+    CHECK_EQUAL(btstack_min(2, HOST_SLIDING_WINDOW_SIZE) | 0x10, peer.host_config_response_field);
+}
+
+TEST(H5, Throughput){
+    sim_run_until_link_active();
+    uint32_t bytes_per_second = sim_measure_throughput(NUM_ACL_PACKETS);
+    CHECK_TRUE(peer.packet_content_ok);
+    printf("H5 throughput with sliding window %u at %u baud, %u us latency: %u bytes/s\n",
+           HOST_SLIDING_WINDOW_SIZE, SIM_BAUDRATE, SIM_LATENCY_US, bytes_per_second);
+#ifdef ENABLE_H5_SLIDING_WINDOW
+    // UART is busy all the time: at least 95% of the raw data rate
+    CHECK(bytes_per_second > (SIM_BAUDRATE / 10u * 95u / 100u));
+#endif
+}
+
+TEST(H5, ThroughputPeerWithoutSlidingWindow){
+    sim_setup(1);
+    sim_run_until_link_active();
+    uint32_t bytes_per_second = sim_measure_throughput(NUM_ACL_PACKETS);
+    CHECK_TRUE(peer.packet_content_ok);
+    printf("H5 throughput with sliding window 1 at %u baud, %u us latency: %u bytes/s\n",
+           SIM_BAUDRATE, SIM_LATENCY_US, bytes_per_second);
+    // each packet waits for ack
+    CHECK(bytes_per_second < (SIM_BAUDRATE / 10u * 70u / 100u));
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
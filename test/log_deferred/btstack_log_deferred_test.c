@@ -0,0 +1,127 @@
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+#include "btstack_log_deferred.h"
+#include "btstack_util.h"
+
+#include <string.h>
+
+static uint32_t time_ms;
+
+extern "C" uint32_t btstack_run_loop_get_time_ms(void){
+    return time_ms;
+}
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+static int log_level_enabled[3];
+
+extern "C" int hci_dump_log_level_active(int log_level){
+    return log_level_enabled[log_level];
+}
+
+static uint8_t storage[64];
+static uint8_t stream[128];
+
+static const char * format_int = "value %u";
+
+TEST_GROUP(LogDeferred){
+    void setup(void){
+        time_ms = 0x12345678;
+        log_level_enabled[0] = 1;
+        log_level_enabled[1] = 1;
+        log_level_enabled[2] = 1;
+        btstack_log_deferred_init(storage, sizeof(storage));
+    }
+};
+
+TEST(LogDeferred, FormatStoredOnce){
+    btstack_log_deferred(1, format_int, 5);
+    btstack_log_deferred(1, format_int, 6);
+    uint32_t len = btstack_log_deferred_read(stream, sizeof(stream));
+    uint16_t format_len = (uint16_t) strlen(format_int);
+    CHECK_EQUAL(5 + format_len + 2 * (10 + 4), len);
+    // format
+    CHECK_EQUAL(BTSTACK_LOG_DEFERRED_RECORD_TYPE_FORMAT, stream[0]);
+    CHECK_EQUAL(0, little_endian_read_16(stream, 1));
+    CHECK_EQUAL(format_len, little_endian_read_16(stream, 3));
+    MEMCMP_EQUAL(format_int, &stream[5], format_len);
+    // logs
+    uint8_t * log = &stream[5 + format_len];
+    CHECK_EQUAL(BTSTACK_LOG_DEFERRED_RECORD_TYPE_LOG, log[0]);
+    CHECK_EQUAL(1, log[1]);
+    CHECK_EQUAL(0, little_endian_read_16(log, 2));
+    CHECK_EQUAL(0x12345678, little_endian_read_32(log, 4));
+    CHECK_EQUAL(4, little_endian_read_16(log, 8));
+    CHECK_EQUAL(5, little_endian_read_32(log, 10));
+    log += 14;
+    CHECK_EQUAL(BTSTACK_LOG_DEFERRED_RECORD_TYPE_LOG, log[0]);
+    CHECK_EQUAL(6, little_endian_read_32(log, 10));
+}
+
+TEST(LogDeferred, Args){
+    const char * format = "%s %lu %%%c";
+    char text[] = "abc";
+    btstack_log_deferred(0, format, text, 7UL, 'x');
+    // string is copied
+    text[0] = 'z';
+    uint32_t len = btstack_log_deferred_read(stream, sizeof(stream));
+    uint8_t * log = &stream[5 + strlen(format)];
+    CHECK_EQUAL(5 + strlen(format) + 10 + 16, len);
+    CHECK_EQUAL(1 + 3 + 8 + 4, little_endian_read_16(log, 8));
+    uint8_t * args = &log[10];
+    CHECK_EQUAL(3, args[0]);
+    MEMCMP_EQUAL("abc", &args[1], 3);
+    CHECK_EQUAL(7, little_endian_read_32(args, 4));
+    CHECK_EQUAL(0, little_endian_read_32(args, 8));
+    CHECK_EQUAL('x', little_endian_read_32(args, 12));
+}
+
+TEST(LogDeferred, StringPrecision){
+    const char * format = "%.2s %.*s";
+    // strings don't need to be terminated if precision is given
+    const char text[] = { 'a', 'b', 'c', 'd' };
+    btstack_log_deferred(1, format, text, 3, text);
+    btstack_log_deferred_read(stream, sizeof(stream));
+    uint8_t * log = &stream[5 + strlen(format)];
+    CHECK_EQUAL(1 + 2 + 4 + 1 + 3, little_endian_read_16(log, 8));
+    uint8_t * args = &log[10];
+    CHECK_EQUAL(2, args[0]);
+    MEMCMP_EQUAL("ab", &args[1], 2);
+    CHECK_EQUAL(3, little_endian_read_32(args, 3));
+    CHECK_EQUAL(3, args[7]);
+    MEMCMP_EQUAL("abc", &args[8], 3);
+}
+
+TEST(LogDeferred, LogLevelDisabled){
+    log_level_enabled[0] = 0;
+    btstack_log_deferred(0, format_int, 1);
+    CHECK_EQUAL(0, btstack_log_deferred_bytes_available());
+    btstack_log_deferred(1, format_int, 2);
+    CHECK_EQUAL(5 + 8 + 14, btstack_log_deferred_bytes_available());
+}
+
+TEST(LogDeferred, Dropped){
+    // format (13) + 3 logs (14) fit into 64 bytes
+    btstack_log_deferred(1, format_int, 1);
+    btstack_log_deferred(1, format_int, 2);
+    btstack_log_deferred(1, format_int, 3);
+    btstack_log_deferred(1, format_int, 4);
+    btstack_log_deferred(1, format_int, 5);
+    btstack_log_deferred(1, format_int, 6);
+    CHECK_EQUAL(5 + 8 + 3 * 14, btstack_log_deferred_bytes_available());
+    CHECK_EQUAL(5 + 8 + 3 * 14, btstack_log_deferred_read(stream, sizeof(stream)));
+    // dropped count is stored before next log
+    btstack_log_deferred(1, format_int, 7);
+    CHECK_EQUAL(5 + 14, btstack_log_deferred_read(stream, sizeof(stream)));
+    CHECK_EQUAL(BTSTACK_LOG_DEFERRED_RECORD_TYPE_DROPPED, stream[0]);
+    CHECK_EQUAL(3, little_endian_read_32(stream, 1));
+    CHECK_EQUAL(BTSTACK_LOG_DEFERRED_RECORD_TYPE_LOG, stream[5]);
+    CHECK_EQUAL(7, little_endian_read_32(stream, 15));
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
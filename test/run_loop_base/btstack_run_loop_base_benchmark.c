@@ -0,0 +1,93 @@
+// Measure cost of adding, removing and firing timers in btstack_run_loop_base
+// Build with 'make benchmark', which runs it with the sorted list and with ENABLE_RUN_LOOP_TIMER_HEAP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "btstack_run_loop_base.h"
+#include "btstack_util.h"
+
+#define MAX_TIMERS 16000
+#define NUM_ROUNDS 5
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+static btstack_timer_source_t timers[MAX_TIMERS];
+static uint32_t num_fired;
+
+static void timer_handler(btstack_timer_source_t * ts){
+    UNUSED(ts);
+    num_fired++;
+}
+
+static uint64_t get_time_ns(void){
+    struct timespec now_ts;
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    return ((uint64_t) now_ts.tv_sec * 1000000000u) + (uint64_t) now_ts.tv_nsec;
+}
+
+static void benchmark(uint16_t num_timers){
+    uint64_t add_ns = 0;
+    uint64_t remove_ns = 0;
+    uint64_t fire_ns = 0;
+    uint16_t num_removed = num_timers / 2;
+    int round;
+    for (round = 0; round < NUM_ROUNDS; round++){
+        btstack_run_loop_base_init();
+        memset(timers, 0, sizeof(timers));
+        srand(round);
+        uint16_t i;
+        for (i = 0; i < num_timers; i++){
+            timers[i].timeout = 1000u + (uint32_t) (rand() % 60000);
+            timers[i].process = &timer_handler;
+        }
+
+        uint64_t start_ns = get_time_ns();
+        for (i = 0; i < num_timers; i++){
+            btstack_run_loop_base_add_timer(&timers[i]);
+        }
+        add_ns += get_time_ns() - start_ns;
+
+        // remove every second timer, e.g. timeouts stopped after response
+        start_ns = get_time_ns();
+        for (i = 0; i < num_timers; i += 2){
+            btstack_run_loop_base_remove_timer(&timers[i]);
+        }
+        remove_ns += get_time_ns() - start_ns;
+
+        num_fired = 0;
+        start_ns = get_time_ns();
+        uint32_t now;
+        for (now = 1000u; now <= 61000u; now += 10u){
+            btstack_run_loop_base_process_timers(now);
+        }
+        fire_ns += get_time_ns() - start_ns;
+        if (num_fired != (uint32_t) (num_timers - num_removed)){
+            printf("error: fired %u of %u timers\n", (unsigned int) num_fired, num_timers - num_removed);
+            exit(1);
+        }
+    }
+    printf("%5u timers: add %8.1f ns, remove %8.1f ns, fire %8.1f ns per timer\n", num_timers,
+           (double) add_ns / (NUM_ROUNDS * num_timers),
+           (double) remove_ns / (NUM_ROUNDS * num_removed),
+           (double) fire_ns / (NUM_ROUNDS * (num_timers - num_removed)));
+}
+
+int main(void){
+#ifdef ENABLE_RUN_LOOP_TIMER_HEAP
+    printf("btstack_run_loop_base with ENABLE_RUN_LOOP_TIMER_HEAP\n");
+#else
+    printf("btstack_run_loop_base with sorted list\n");
+#endif
+    static const uint16_t num_timers[] = { 16, 128, 1000, 4000, 16000 };
+    uint16_t i;
+    for (i = 0; i < sizeof(num_timers) / sizeof(uint16_t); i++){
+        benchmark(num_timers[i]);
+    }
+    return 0;
+}
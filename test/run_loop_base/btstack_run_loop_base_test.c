@@ -0,0 +1,179 @@
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+#include "btstack_run_loop_base.h"
+#include "btstack_util.h"
+
+#include <string.h>
+
+#define NUM_TIMERS 100
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+static btstack_timer_source_t timers[NUM_TIMERS];
+static uint32_t fired_timeouts[NUM_TIMERS * 2];
+static uint16_t num_fired;
+static btstack_timer_source_t * readd_timer;
+
+static void timer_handler(btstack_timer_source_t * ts){
+    fired_timeouts[num_fired++] = ts->timeout;
+    if (ts == readd_timer){
+        readd_timer = NULL;
+        ts->timeout += 5;
+        btstack_run_loop_base_add_timer(ts);
+    }
+}
+
+static void setup_timer(btstack_timer_source_t * ts, uint32_t timeout){
+    ts->timeout = timeout;
+    ts->process = &timer_handler;
+}
+
+static void check_fired_in_order(void){
+    uint16_t i;
+    for (i = 1; i < num_fired; i++){
+        CHECK(btstack_time_delta(fired_timeouts[i], fired_timeouts[i-1]) >= 0);
+    }
+}
+
+TEST_GROUP(RunLoopBase){
+    void setup(void){
+        memset(timers, 0, sizeof(timers));
+        num_fired = 0;
+        readd_timer = NULL;
+        btstack_run_loop_base_init();
+    }
+};
+
+TEST(RunLoopBase, NoTimers){
+    CHECK_EQUAL(-1, btstack_run_loop_base_get_time_until_timeout(0));
+    CHECK_FALSE(btstack_run_loop_base_remove_timer(&timers[0]));
+    btstack_run_loop_base_process_timers(1000);
+    CHECK_EQUAL(0, num_fired);
+}
+
+TEST(RunLoopBase, FireInOrder){
+    uint16_t i;
+    for (i = 0; i < NUM_TIMERS; i++){
+        // pseudo random order
+        setup_timer(&timers[i], 1000 + ((i * 37u) % NUM_TIMERS) * 10u);
+        btstack_run_loop_base_add_timer(&timers[i]);
+    }
+    CHECK_EQUAL(500, btstack_run_loop_base_get_time_until_timeout(500));
+    CHECK_EQUAL(0, btstack_run_loop_base_get_time_until_timeout(2000));
+    btstack_run_loop_base_process_timers(1495);
+    CHECK_EQUAL(50, num_fired);
+    CHECK_EQUAL(5, btstack_run_loop_base_get_time_until_timeout(1495));
+    btstack_run_loop_base_process_timers(5000);
+    CHECK_EQUAL(NUM_TIMERS, num_fired);
+    check_fired_in_order();
+    CHECK_EQUAL(-1, btstack_run_loop_base_get_time_until_timeout(5000));
+}
+
+TEST(RunLoopBase, Remove){
+    uint16_t i;
+    for (i = 0; i < NUM_TIMERS; i++){
+        setup_timer(&timers[i], 1000 + ((i * 37u) % NUM_TIMERS) * 10u);
+        btstack_run_loop_base_add_timer(&timers[i]);
+    }
+    // remove every third timer, including first to fire
+    for (i = 0; i < NUM_TIMERS; i += 3){
+        CHECK_TRUE(btstack_run_loop_base_remove_timer(&timers[i]));
+        CHECK_FALSE(btstack_run_loop_base_remove_timer(&timers[i]));
+    }
+    btstack_run_loop_base_process_timers(5000);
+    CHECK_EQUAL(NUM_TIMERS - 34, num_fired);
+    check_fired_in_order();
+}
+
+TEST(RunLoopBase, AddTwice){
+    setup_timer(&timers[0], 10);
+    setup_timer(&timers[1], 20);
+    btstack_run_loop_base_add_timer(&timers[0]);
+    btstack_run_loop_base_add_timer(&timers[1]);
+    btstack_run_loop_base_add_timer(&timers[0]);
+    btstack_run_loop_base_add_timer(&timers[1]);
+    btstack_run_loop_base_process_timers(100);
+    CHECK_EQUAL(2, num_fired);
+}
+
+TEST(RunLoopBase, ReAddInHandler){
+    setup_timer(&timers[0], 10);
+    setup_timer(&timers[1], 12);
+    btstack_run_loop_base_add_timer(&timers[0]);
+    btstack_run_loop_base_add_timer(&timers[1]);
+    readd_timer = &timers[0];
+    btstack_run_loop_base_process_timers(14);
+    CHECK_EQUAL(2, num_fired);
+    CHECK_EQUAL(1, btstack_run_loop_base_get_time_until_timeout(14));
+    btstack_run_loop_base_process_timers(15);
+    CHECK_EQUAL(3, num_fired);
+    CHECK_EQUAL(15, fired_timeouts[2]);
+}
+
+TEST(RunLoopBase, TimeWrap){
+    setup_timer(&timers[0], 0xfffffff0u);
+    setup_timer(&timers[1], 0x00000010u);
+    btstack_run_loop_base_add_timer(&timers[1]);
+    btstack_run_loop_base_add_timer(&timers[0]);
+    btstack_run_loop_base_process_timers(0xfffffff8u);
+    CHECK_EQUAL(1, num_fired);
+    CHECK_EQUAL(0xfffffff0u, fired_timeouts[0]);
+    CHECK_EQUAL(0x18, btstack_run_loop_base_get_time_until_timeout(0xfffffff8u));
+}
+
+#ifdef ENABLE_RUN_LOOP_TIMER_SLACK
+TEST(RunLoopBase, SlackCoalesce){
+    setup_timer(&timers[0], 100);
+    timers[0].slack_ms = 50;
+    setup_timer(&timers[1], 120);
+    setup_timer(&timers[2], 130);
+    timers[2].slack_ms = 100;
+    btstack_run_loop_base_add_timer(&timers[2]);
+    btstack_run_loop_base_add_timer(&timers[0]);
+    btstack_run_loop_base_add_timer(&timers[1]);
+    // wake up for timer 1 without slack, timer 0 fires with it
+    CHECK_EQUAL(120, btstack_run_loop_base_get_time_until_timeout(0));
+    btstack_run_loop_base_process_timers(120);
+    CHECK_EQUAL(2, num_fired);
+    CHECK_EQUAL(110, btstack_run_loop_base_get_time_until_timeout(120));
+}
+
+TEST(RunLoopBase, SlackWakeUpTime){
+    uint16_t i;
+    uint32_t wake_up = 0xffffffffu;
+    for (i = 0; i < NUM_TIMERS; i++){
+        uint32_t timeout = 1000 + ((i * 37u) % NUM_TIMERS) * 10u;
+        setup_timer(&timers[i], timeout);
+        timers[i].slack_ms = (uint16_t) ((i * 53u) % 700u);
+        btstack_run_loop_base_add_timer(&timers[i]);
+        if ((timeout + timers[i].slack_ms) < wake_up){
+            wake_up = timeout + timers[i].slack_ms;
+        }
+        CHECK_EQUAL(wake_up, btstack_run_loop_base_get_time_until_timeout(0));
+    }
+    // remove timers in different order and check again
+    static bool removed[NUM_TIMERS];
+    memset(removed, 0, sizeof(removed));
+    for (i = 0; i < NUM_TIMERS - 1; i++){
+        uint16_t index = (uint16_t) ((i * 71u) % NUM_TIMERS);
+        btstack_run_loop_base_remove_timer(&timers[index]);
+        removed[index] = true;
+        wake_up = 0xffffffffu;
+        uint16_t j;
+        for (j = 0; j < NUM_TIMERS; j++){
+            if (removed[j]) continue;
+            if ((timers[j].timeout + timers[j].slack_ms) < wake_up){
+                wake_up = timers[j].timeout + timers[j].slack_ms;
+            }
+        }
+        CHECK_EQUAL(wake_up, btstack_run_loop_base_get_time_until_timeout(0));
+    }
+}
+#endif
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
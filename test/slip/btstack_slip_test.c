@@ -0,0 +1,120 @@
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/CommandLineTestRunner.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "btstack_slip.h"
+#include "btstack_util.h"
+
+#define MAX_PAYLOAD_LEN 300
+
+extern "C" void hci_dump_log(int log_level, const char * format, ...){
+    UNUSED(log_level);
+    UNUSED(format);
+}
+
+static uint8_t payload[MAX_PAYLOAD_LEN];
+static uint8_t encoded_bytewise[2 * MAX_PAYLOAD_LEN];
+static uint8_t encoded_blockwise[2 * MAX_PAYLOAD_LEN];
+static uint8_t decoded[MAX_PAYLOAD_LEN];
+
+static void fill_payload(uint16_t len){
+    uint16_t i;
+    for (i = 0; i < len; i++){
+        // make SOF and escape bytes frequent
+        switch (rand() & 7){
+            case 0:
+                payload[i] = BTSTACK_SLIP_SOF;
+                break;
+            case 1:
+                payload[i] = 0xdb;
+                break;
+            default:
+                payload[i] = (uint8_t) rand();
+                break;
+        }
+    }
+}
+
+static uint16_t encode_bytewise(uint16_t len){
+    uint16_t pos = 0;
+    btstack_slip_encoder_start(payload, len);
+    while (btstack_slip_encoder_has_data()){
+        encoded_bytewise[pos++] = btstack_slip_encoder_get_byte();
+    }
+    return pos;
+}
+
+static uint16_t encode_blockwise(uint16_t len, uint16_t chunk_size){
+    uint16_t pos = 0;
+    btstack_slip_encoder_start(payload, len);
+    while (btstack_slip_encoder_has_data()){
+        pos += btstack_slip_encoder_get_bytes(&encoded_blockwise[pos], chunk_size);
+    }
+    return pos;
+}
+
+TEST_GROUP(SLIP){
+    void setup(void){
+        srand(1);
+    }
+};
+
+TEST(SLIP, EncoderEscape){
+    const uint8_t expected[] = { 0x01, 0xdb, 0xdc, 0x02, 0xdb, 0xdd, 0x03 };
+    payload[0] = 0x01;
+    payload[1] = BTSTACK_SLIP_SOF;
+    payload[2] = 0x02;
+    payload[3] = 0xdb;
+    payload[4] = 0x03;
+    btstack_slip_encoder_start(payload, 5);
+    CHECK_EQUAL(sizeof(expected), btstack_slip_encoder_get_bytes(encoded_blockwise, sizeof(encoded_blockwise)));
+    MEMCMP_EQUAL(expected, encoded_blockwise, sizeof(expected));
+    CHECK_FALSE(btstack_slip_encoder_has_data());
+}
+
+TEST(SLIP, EncoderGetBytesMatchesGetByte){
+    const uint16_t chunk_sizes[] = { 1, 2, 3, 7, 64, 2 * MAX_PAYLOAD_LEN };
+    int round;
+    for (round = 0; round < 50; round++){
+        uint16_t len = (uint16_t) (1 + (rand() % MAX_PAYLOAD_LEN));
+        fill_payload(len);
+        uint16_t expected_len = encode_bytewise(len);
+        unsigned int i;
+        for (i = 0; i < sizeof(chunk_sizes) / sizeof(uint16_t); i++){
+            CHECK_EQUAL(expected_len, encode_blockwise(len, chunk_sizes[i]));
+            MEMCMP_EQUAL(encoded_bytewise, encoded_blockwise, expected_len);
+        }
+    }
+}
+
+TEST(SLIP, DecoderProcessBlockRoundTrip){
+    const uint16_t block_sizes[] = { 1, 5, 32, 2 * MAX_PAYLOAD_LEN };
+    int round;
+    for (round = 0; round < 50; round++){
+        uint16_t len = (uint16_t) (1 + (rand() % MAX_PAYLOAD_LEN));
+        fill_payload(len);
+        // frame: SOF, encoded payload, SOF
+        encoded_bytewise[0] = BTSTACK_SLIP_SOF;
+        btstack_slip_encoder_start(payload, len);
+        uint16_t frame_len = 1 + btstack_slip_encoder_get_bytes(&encoded_bytewise[1], sizeof(encoded_bytewise) - 2);
+        encoded_bytewise[frame_len++] = BTSTACK_SLIP_SOF;
+        unsigned int i;
+        for (i = 0; i < sizeof(block_sizes) / sizeof(uint16_t); i++){
+            btstack_slip_decoder_init(decoded, sizeof(decoded));
+            uint16_t pos = 0;
+            while ((pos < frame_len) && (btstack_slip_decoder_frame_size() == 0)){
+                uint16_t block_len = btstack_min(block_sizes[i], frame_len - pos);
+                pos += btstack_slip_decoder_process_block(&encoded_bytewise[pos], block_len);
+            }
+            CHECK_EQUAL(frame_len, pos);
+            CHECK_EQUAL(len, btstack_slip_decoder_frame_size());
+            MEMCMP_EQUAL(payload, decoded, len);
+        }
+    }
+}
+
+int main (int argc, const char * argv[]){
+    return CommandLineTestRunner::RunAllTests(argc, argv);
+}
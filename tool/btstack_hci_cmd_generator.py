@@ -0,0 +1,243 @@
+#!/usr/bin/env python3
+
+import os
+import re
+import sys
+
+program_info = """
+BTstack HCI Command Serializer Generator for BTstack
+Copyright 2020, BlueKitchen GmbH
+"""
+
+copyright = """/*
+ * Copyright (C) 2020 BlueKitchen GmbH
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holders nor the names of
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ * 4. Any redistribution, use, or modification is done solely for
+ *    personal benefit and not for any commercial purpose or for
+ *    monetary gain.
+ *
+ * THIS SOFTWARE IS PROVIDED BY BLUEKITCHEN GMBH AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MATTHIAS
+ * RINGWALD OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF
+ * THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ * Please inquire about commercial licensing options at 
+ * contact@bluekitchen-gmbh.com
+ *
+ */
+"""
+
+hfile_header_begin = """
+/*
+ *  hci_cmd_serializer.h
+ *
+ *  @brief Typed serializers for HCI Commands defined in hci_cmd.c
+ *  @note  Don't edit - generated by tool/btstack_hci_cmd_generator.py
+ *
+ */
+
+#ifndef HCI_CMD_SERIALIZER_H
+#define HCI_CMD_SERIALIZER_H
+
+#if defined __cplusplus
+extern "C" {
+#endif
+
+#include "btstack_util.h"
+#include "hci_cmd.h"
+
+#include <stdint.h>
+#include <string.h>
+
+/* API_START */
+
+"""
+
+hfile_header_end = """
+/* API_END */
+
+#if defined __cplusplus
+}
+#endif
+
+#endif // HCI_CMD_SERIALIZER_H
+"""
+
+c_prototype = '''/**
+ * @brief Create {command_name} command
+ * @param hci_cmd_buffer of at least {buffer_size} bytes{param_docs}
+ * @return size of command packet
+ * @note: btstack_type {format}
+ */
+static inline uint16_t {fn_name}(uint8_t * hci_cmd_buffer{params}){{
+    little_endian_store_16(hci_cmd_buffer, 0, {opcode});
+    hci_cmd_buffer[2] = {param_len};
+{code}    return {size};
+}}
+
+'''
+
+param_types = {
+    '1' : 'uint8_t',
+    '2' : 'uint16_t',
+    '3' : 'uint32_t',
+    '4' : 'uint32_t',
+    'H' : 'hci_con_handle_t',
+    'B' : 'const bd_addr_t',
+    'D' : 'const uint8_t *',
+    'E' : 'const uint8_t *',
+    'N' : 'const char *',
+    'P' : 'const uint8_t *',
+    'A' : 'const uint8_t *',
+    'Q' : 'const uint8_t *',
+    'V' : 'const uint8_t *',
+}
+
+param_sizes = { '1' : 1, '2' : 2, '3' : 3, '4' : 4, 'H' : 2, 'B' : 6, 'D' : 8, 'E' : 240, 'N' : 248, 'P' : 16, 'A' : 31, 'Q' : 32 }
+
+param_write = {
+    '1' : 'hci_cmd_buffer[{offset}] = {name};',
+    '2' : 'little_endian_store_16(hci_cmd_buffer, {offset}, {name});',
+    '3' : 'little_endian_store_24(hci_cmd_buffer, {offset}, {name});',
+    '4' : 'little_endian_store_32(hci_cmd_buffer, {offset}, {name});',
+    'H' : 'little_endian_store_16(hci_cmd_buffer, {offset}, {name});',
+    'B' : 'reverse_bd_addr({name}, &hci_cmd_buffer[{offset}]);',
+    'D' : '(void)memcpy(&hci_cmd_buffer[{offset}], {name}, 8);',
+    'E' : '(void)memcpy(&hci_cmd_buffer[{offset}], {name}, 240);',
+    'N' : '(void)strncpy((char *) &hci_cmd_buffer[{offset}], {name}, 248);',
+    'P' : '(void)memcpy(&hci_cmd_buffer[{offset}], {name}, 16);',
+    'A' : '(void)memcpy(&hci_cmd_buffer[{offset}], {name}, 31);',
+    'Q' : 'reverse_bytes({name}, &hci_cmd_buffer[{offset}], 32);',
+    'V' : '(void)memcpy(&hci_cmd_buffer[{offset}], {name}, {length_name});',
+}
+
+# parameter names must be valid identifiers in C and C++, as hci_cmd_serializer.h is included by C++ tests
+reserved_names = [
+    'alignas', 'alignof', 'and', 'and_eq', 'asm', 'auto', 'bitand', 'bitor', 'bool', 'break', 'case', 'catch', 'char',
+    'class', 'compl', 'const', 'const_cast', 'constexpr', 'continue', 'decltype', 'default', 'delete', 'do', 'double',
+    'dynamic_cast', 'else', 'enum', 'explicit', 'export', 'extern', 'false', 'float', 'for', 'friend', 'goto', 'if',
+    'inline', 'int', 'long', 'mutable', 'namespace', 'new', 'noexcept', 'not', 'not_eq', 'nullptr', 'operator', 'or',
+    'or_eq', 'private', 'protected', 'public', 'register', 'reinterpret_cast', 'restrict', 'return', 'short', 'signed',
+    'sizeof', 'static', 'static_assert', 'static_cast', 'struct', 'switch', 'template', 'this', 'thread_local', 'throw',
+    'true', 'try', 'typedef', 'typeid', 'typename', 'union', 'unsigned', 'using', 'virtual', 'void', 'volatile',
+    'wchar_t', 'while', 'xor', 'xor_eq',
+]
+
+reserved_name_mapping = {
+    'public'  : 'public_key',
+    'private' : 'private_key',
+}
+
+def param_name(name):
+    if name in reserved_name_mapping:
+        return reserved_name_mapping[name]
+    if name in reserved_names:
+        return name + '_value'
+    return name
+
+def parse_commands(path):
+    # returns list of (command_name, opcode, format, params), skips commands in #if 0 blocks
+    commands = []
+    params = []
+    command_name = None
+    disabled_depth = 0
+    depth = 0
+    with open (path, 'rt') as fin:
+        for line in fin:
+            if re.match('\s*#\s*if', line):
+                depth += 1
+                if disabled_depth == 0 and re.match('\s*#\s*if\s+0\s*$', line):
+                    disabled_depth = depth
+                continue
+            if re.match('\s*#\s*endif', line):
+                if disabled_depth == depth:
+                    disabled_depth = 0
+                depth -= 1
+                continue
+            if disabled_depth:
+                continue
+            parts = re.match('.*@param\s*(\w*)\s*', line)
+            if parts:
+                params.append(param_name(parts.groups()[0].lower()))
+                continue
+            declaration = re.match('const\s+hci_cmd_t\s+(\w+)[\s=]+', line)
+            if declaration:
+                command_name = declaration.groups()[0]
+                continue
+            definition = re.match('\s*(HCI_OPCODE_\w+|0x[0-9a-fA-F]+)\s*,\s*\"(\w*)\".*', line)
+            if definition and command_name:
+                (opcode, format) = definition.groups()
+                if len(params) != len(format) or len(set(params)) != len(params):
+                    params = ['arg%u' % (i+1) for i in range(len(format))]
+                commands.append((command_name, opcode, format, params))
+                command_name = None
+                params = []
+    return commands
+
+def create_serializer(command_name, opcode, format, params):
+    offset = 3
+    code = ''
+    param_docs = ''
+    param_list = ''
+    # variable length data 'V' is the last field, its length is given by the preceding 8 bit field
+    length_name = ''
+    for f, name in zip(format, params):
+        param_docs += '\n * @param %s' % name
+        param_list += ', %s %s' % (param_types[f], name)
+        code += '    ' + param_write[f].format(offset=offset, name=name, length_name=length_name) + '\n'
+        if f != 'V':
+            length_name = name
+            offset += param_sizes[f]
+    param_len   = offset - 3
+    size        = offset
+    buffer_size = offset
+    if format.endswith('V'):
+        param_len   = '%u + %s' % (param_len, length_name)
+        size        = '%u + %s' % (size, length_name)
+        buffer_size = '%u + %s' % (buffer_size, length_name)
+    return c_prototype.format(command_name=command_name, fn_name=command_name + '_serialize', opcode=opcode, format=format,
+                              params=param_list, param_docs=param_docs, param_len=param_len, size=size, buffer_size=buffer_size, code=code)
+
+def create_serializers(commands, path):
+    with open(path, 'wt') as fout:
+        fout.write(copyright)
+        fout.write(hfile_header_begin)
+        for (command_name, opcode, format, params) in commands:
+            unsupported = [f for f in format if not f in param_types]
+            if ('V' in format[:-1]) or (format.endswith('V') and not format[:-1].endswith('1')):
+                unsupported.append('V')
+            if unsupported:
+                print("%s: format '%s' not supported" % (command_name, format))
+                continue
+            fout.write(create_serializer(command_name, opcode, format, params))
+        fout.write(hfile_header_end)
+
+btstack_root = os.path.abspath(os.path.dirname(sys.argv[0]) + '/..')
+gen_path = btstack_root + '/src/hci_cmd_serializer.h'
+
+print(program_info)
+
+commands = parse_commands(btstack_root + '/src/hci_cmd.c')
+create_serializers(commands, gen_path)
+
+print('Done!')
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+# BlueKitchen GmbH (c) 2020
+
+# Decode binary log stream created with ENABLE_LOG_DEFERRED, see src/btstack_log_deferred.h
+
+import re
+import struct
+import sys
+
+RECORD_TYPE_FORMAT  = 0x01
+RECORD_TYPE_LOG     = 0x02
+RECORD_TYPE_DROPPED = 0x03
+
+log_levels = ['DEBUG', 'INFO', 'ERROR']
+
+# flags, width, precision, length modifier, conversion
+conversion_pattern = re.compile(r'%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t|L)?([diuxXocpsfFeEgGaA%])')
+
+class ArgsReader:
+    def __init__(self, data):
+        self.data = data
+        self.pos  = 0
+
+    def read(self, fmt, size):
+        if self.pos + size > len(self.data):
+            raise EOFError
+        value = struct.unpack_from(fmt, self.data, self.pos)[0]
+        self.pos += size
+        return value
+
+    def read_string(self):
+        string_len = self.read('<B', 1)
+        if self.pos + string_len > len(self.data):
+            raise EOFError
+        value = self.data[self.pos:self.pos+string_len].decode('utf-8', 'replace')
+        self.pos += string_len
+        return value
+
+def format_message(format, args):
+    reader = ArgsReader(args)
+    def replace(match):
+        flags, width, precision, length, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if width == '*':
+            width = str(reader.read('<i', 4))
+        if precision == '*':
+            precision = reader.read('<i', 4)
+            # negative precision is taken as if it was omitted
+            precision = str(precision) if precision >= 0 else None
+        spec = '%' + flags + (width or '') + ('.' + precision if precision is not None else '')
+        long_arg = length in ['l', 'll', 'z', 'j', 't']
+        if conversion in 'diuxXoc':
+            if long_arg:
+                value = reader.read('<q' if conversion in 'di' else '<Q', 8)
+            else:
+                value = reader.read('<i' if conversion in 'di' else '<I', 4)
+            if conversion == 'c':
+                return (spec + 'c') % chr(value & 0xff)
+            if conversion == 'u':
+                conversion = 'd'
+            return (spec + conversion) % value
+        if conversion == 'p':
+            return '0x%x' % reader.read('<Q', 8)
+        if conversion in 'fFeEgGaA':
+            if conversion in 'aA':
+                conversion = 'e'
+            return (spec + conversion) % reader.read('<d', 8)
+        if conversion == 's':
+            return (spec + 's') % reader.read_string()
+        return match.group(0)
+    try:
+        return conversion_pattern.sub(replace, format)
+    except EOFError:
+        return format + ' <args truncated>'
+
+def format_timestamp(time_ms):
+    seconds = time_ms // 1000
+    minutes = seconds // 60
+    hours   = minutes // 60
+    return '[%02u:%02u:%02u.%03u]' % (hours, minutes % 60, seconds % 60, time_ms % 1000)
+
+def decode(data, out):
+    formats = {}
+    pos = 0
+    while pos < len(data):
+        record_type = data[pos]
+        if record_type == RECORD_TYPE_FORMAT:
+            if pos + 5 > len(data):
+                break
+            (id, len_format) = struct.unpack_from('<HH', data, pos + 1)
+            formats[id] = data[pos+5:pos+5+len_format].decode('utf-8', 'replace')
+            pos += 5 + len_format
+        elif record_type == RECORD_TYPE_LOG:
+            if pos + 10 > len(data):
+                break
+            (level, id, time_ms, len_args) = struct.unpack_from('<BHIH', data, pos + 1)
+            args = data[pos+10:pos+10+len_args]
+            pos += 10 + len_args
+            level_name = log_levels[level] if level < len(log_levels) else str(level)
+            if id in formats:
+                message = format_message(formats[id], args)
+            else:
+                message = '<unknown format %u>' % id
+            out.write('%s %s: %s\n' % (format_timestamp(time_ms), level_name, message))
+        elif record_type == RECORD_TYPE_DROPPED:
+            if pos + 5 > len(data):
+                break
+            (num_dropped,) = struct.unpack_from('<I', data, pos + 1)
+            out.write('<%u log message(s) dropped>\n' % num_dropped)
+            pos += 5
+        else:
+            out.write('<invalid record type 0x%02x at offset %u>\n' % (record_type, pos))
+            break
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('Decode deferred log created with ENABLE_LOG_DEFERRED')
+        print('Usage: %s binary_log' % sys.argv[0])
+        sys.exit(1)
+    with open(sys.argv[1], 'rb') as f:
+        decode(f.read(), sys.stdout)